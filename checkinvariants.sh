@@ -0,0 +1,90 @@
+#!/bin/sh
+# Runs the release (full) and checked builds on the same inputs and fails if
+# their output or simout.txt differ, or if the checked build finds a broken
+# invariant. See src/Invariants.hpp. Also fails if per-CPU queue runs differ
+# between one thread and several (--cpu-threads, see SmpScheduler.hpp), or if
+# either build fails --check-philox.
+
+mkdir -p invresults
+rm -rf invresults/*.txt
+make clean && make full && mv full.out invresults/release.out
+make clean && make checked && mv checked.out invresults/checked.out
+make clean
+
+status=0
+run() {
+  for build in release checked; do
+    ./invresults/$build.out "$@" > invresults/output-$build.txt 2>&1 ||
+      echo "$build exited with $? on: $*" >> invresults/output-$build.txt
+    mv simout.txt invresults/simout-$build.txt
+  done
+  if ! cmp -s invresults/output-release.txt invresults/output-checked.txt ||
+     ! cmp -s invresults/simout-release.txt invresults/simout-checked.txt; then
+    echo "DIFF: $*"
+    status=1
+  fi
+}
+
+for build in release checked; do
+  ./invresults/$build.out --check-philox > invresults/philox-$build.txt 2>&1 || {
+    echo "PHILOX: $build"
+    cat invresults/philox-$build.txt
+    status=1
+  }
+done
+
+run 1 2 0.01 256 4 0.5 128
+run 2 2 0.01 256 4 0.5 128
+run 16 2 0.01 256 4 0.75 64
+run 8 64 0.001 4096 4 0.5 2048
+run 8 64 0.001 4096 4 0.5 2048 BEGINNING
+run 8 64 0.001 4096 20 0.5 2048
+run 26 7 0.01 256 2 0.25 16 --cutoff=none
+run 64 3 0.001 1024 8 0.9 32 BEGINNING --cutoff=none
+run 500 11 0.01 256 4 0.5 64 --stats-only
+run 200 5 0.01 256 4 0.5 64 --rng=philox --sampler=inverse-cdf
+run 200 5 0.01 256 4 0.5 64 --rng=philox --stream --cfs --mlfq
+run 64 3 0.01 256 4 0.5 64 --cfs --mlfq --cutoff=none
+run 64 3 0.01 256 4 0.5 64 --cpus=4 --queues=global --cfs --mlfq
+run 64 3 0.01 256 4 0.5 64 --cpus=4 --queues=per-cpu --cfs --mlfq
+
+# Same as run, then the same again with --cpu-threads=4 in both builds
+threads() {
+  run "$@"
+  for build in release checked; do
+    mv invresults/output-$build.txt invresults/output-$build-1.txt
+    mv invresults/simout-$build.txt invresults/simout-$build-1.txt
+  done
+  run "$@" --cpu-threads=4
+  if ! cmp -s invresults/output-release-1.txt invresults/output-release.txt ||
+     ! cmp -s invresults/simout-release-1.txt invresults/simout-release.txt; then
+    echo "THREADS DIFF: $*"
+    status=1
+  fi
+}
+
+threads 64 3 0.01 256 4 0.5 64 --cpus=4 --queues=per-cpu --cfs --mlfq
+threads 64 3 0.01 256 4 0.5 64 --cpus=4 --queues=per-cpu --balance=periodic:50
+threads 200 5 0.001 1024 8 0.9 32 --cpus=3 --queues=per-cpu --migration=2
+threads 200 5 0.01 256 4 0.5 16 BEGINNING --cpus=8 --queues=per-cpu --cfs --mlfq --migration=1
+threads 500 11 0.01 256 2 0.25 64 --cpus=2 --queues=per-cpu --balance=periodic:10 --cfs --mlfq
+
+# A workload file whose first CPU burst is 0ms must fail the run, not hang it
+./invresults/release.out 2 1 0.01 256 4 0.5 64 --stats-only \
+  --dump=invresults/w0.bin > /dev/null 2>&1
+arena=$(od -An -t u8 -j 48 -N 8 invresults/w0.bin | tr -d ' ')
+printf '\000\000\000\000' |
+  dd of=invresults/w0.bin bs=1 seek="$arena" conv=notrunc 2> /dev/null
+for build in release checked; do
+  if timeout 10 ./invresults/$build.out 2 1 0.01 256 4 0.5 64 --stats-only \
+       --workload=invresults/w0.bin > invresults/w0-$build.txt 2>&1 ||
+     ! grep -q "0ms CPU burst" invresults/w0-$build.txt; then
+    echo "0MS BURST: $build"
+    status=1
+  fi
+done
+rm -f simout.txt
+
+rm -f invresults/release.out invresults/checked.out
+[ $status = 0 ] && echo "release and checked builds agree"
+exit $status
@@ -0,0 +1,117 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - rr.c
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Round robin as a plugin (see src/SchedPlugin.h), adding processes to the
+ * end of the queue like RR with rr_add END; the argument is the time slice in
+ * ms, 64 if empty. Built with make plugins and run with
+ * --plugin=plugins/rr.so:128, or timed with --bench plugin plugins/rr.so.
+ */
+
+#include "SchedPlugin.h"
+#include <stdlib.h>
+
+struct rr {
+  uint32_t slice;
+  /* FIFO of handles in a circular buffer of size cap, a power of two */
+  uint32_t *ring;
+  uint32_t cap;
+  uint32_t head;
+  uint32_t count;
+};
+
+static void *rr_create(const char *args) {
+  char *end;
+  unsigned long slice = 64;
+  struct rr *self;
+  if (*args) {
+    slice = strtoul(args, &end, 10);
+    if (*end || !slice || slice > UINT32_MAX) {
+      return NULL;
+    }
+  }
+  self = calloc(1, sizeof(*self));
+  if (self) {
+    self->slice = slice;
+  }
+  return self;
+}
+
+static void rr_destroy(void *p) {
+  struct rr *self = p;
+  free(self->ring);
+  free(self);
+}
+
+/* Doubles the ring, unrolling it at head 0 */
+static void rr_grow(struct rr *self) {
+  const uint32_t cap = self->cap ? 2 * self->cap : 16;
+  uint32_t *ring = malloc(cap * sizeof(*ring));
+  uint32_t i;
+  if (!ring) {
+    abort();
+  }
+  for (i = 0; i < self->count; ++i) {
+    ring[i] = self->ring[(self->head + i) & (self->cap - 1)];
+  }
+  free(self->ring);
+  self->ring = ring;
+  self->cap = cap;
+  self->head = 0;
+}
+
+static void rr_enqueue(void *p, const struct sched_task *tasks, uint32_t n) {
+  struct rr *self = p;
+  uint32_t i;
+  for (i = 0; i < n; ++i) {
+    if (self->count == self->cap) {
+      rr_grow(self);
+    }
+    self->ring[(self->head + self->count) & (self->cap - 1)] =
+        tasks[i].handle;
+    ++self->count;
+  }
+}
+
+static uint32_t rr_pick_next(void *p) {
+  struct rr *self = p;
+  const uint32_t h = self->ring[self->head];
+  self->head = (self->head + 1) & (self->cap - 1);
+  --self->count;
+  return h;
+}
+
+static uint32_t rr_time_slice(void *p, const struct sched_task *task) {
+  (void)task;
+  return ((struct rr *)p)->slice;
+}
+
+static uint32_t rr_list_queue(void *p, uint32_t *handles, uint32_t max) {
+  struct rr *self = p;
+  uint32_t i;
+  for (i = 0; i < self->count && i < max; ++i) {
+    handles[i] = self->ring[(self->head + i) & (self->cap - 1)];
+  }
+  return self->count;
+}
+
+static const struct sched_plugin RR_PLUGIN = {
+    SCHED_PLUGIN_ABI_VERSION,
+    SCHED_PLUGIN_TIME_SLICED,
+    "RR-plugin",
+    rr_create,
+    rr_destroy,
+    rr_enqueue,
+    rr_pick_next,
+    NULL, /* should_preempt */
+    rr_time_slice,
+    NULL, /* on_burst_complete */
+    rr_list_queue};
+
+const struct sched_plugin *sched_plugin_get(void) { return &RR_PLUGIN; }
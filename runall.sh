@@ -3,7 +3,7 @@
 mkdir -p ownresults
 rm -rf ownresults/output*.txt
 rm -rf ownresults/simout*.txt
-make clean && make full
+make clean && make limited
 
 
 
@@ -17,9 +17,6 @@ make clean && make full
 
 ./full.out 8 64 0.001 4096 4 0.5 2048 BEGINNING > ownresults/output06-full.txt
 
-make clean && make limited
-
-
 ./limited.out 1 2 0.01 256 4 0.5 128 > ownresults/output02.txt
 mv simout.txt ownresults/simout02.txt
 
@@ -0,0 +1,32 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - AllocCounter.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ */
+
+#include "AllocCounter.hpp"
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<unsigned long long> count{0};
+} // namespace
+
+const std::atomic<unsigned long long> *AllocCounter::allocations() {
+  return &count;
+}
+
+void *operator new(std::size_t size) {
+  count.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
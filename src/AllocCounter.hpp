@@ -0,0 +1,29 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - AllocCounter.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Heap allocation counting for the benchmarks. AllocCounter.cpp replaces
+ * the global operator new with one that counts calls; it is only linked into
+ * bench.out (see the Makefile) so the simulator itself pays nothing for it.
+ * Without it, the weak definition of allocations() in Bench.cpp returns
+ * nullptr and Bench reports no allocation figures.
+ */
+
+#ifndef ALLOCCOUNTER_HPP
+#define ALLOCCOUNTER_HPP
+
+#include <atomic>
+
+namespace AllocCounter {
+
+// Number of operator new calls so far, or nullptr when not counting
+const std::atomic<unsigned long long> *allocations();
+} // namespace AllocCounter
+
+#endif
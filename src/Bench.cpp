@@ -0,0 +1,456 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - Bench.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ */
+
+#include "Bench.hpp"
+#include "AllocCounter.hpp"
+#include "CompletelyFair.hpp"
+#include "EventLog.hpp"
+#include "ExpSampler.hpp"
+#include "MultilevelFeedback.hpp"
+#include "PluginPolicy.hpp"
+#include "ProcessTable.hpp"
+#include "Rand48.hpp"
+#include "RoundRobin.hpp"
+#include "SeqGenerator.hpp"
+#include "ShortestRemainingTime.hpp"
+#include "WorkloadFile.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <malloc.h>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <stdlib.h>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
+// Replaced by the counting one in AllocCounter.cpp when that is linked in
+__attribute__((weak)) const std::atomic<unsigned long long> *
+AllocCounter::allocations() {
+  return nullptr;
+}
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double secondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void report(std::ostream &os, const char *name, double lambda, double maxval,
+            unsigned long count, double seconds, double mean) {
+  os << name << " lambda=" << lambda << " limit=" << maxval << ": "
+     << count / seconds / 1e6 << " M values/s, mean " << mean << std::endl;
+}
+
+// The suite's workloads; tcs, alpha and tslice are fixed. Every logged event
+// holds a copy of the ready queue, so full output is only timed where the
+// queue stays short.
+struct Case {
+  unsigned int n;
+  double lambda;
+  int limit;
+  bool fullOutput;
+};
+const Case CASES[] = {{64, 0.01, 256, true},
+                      {128, 0.001, 4096, true},
+                      {512, 0.01, 256, false},
+                      {4096, 0.01, 64, false}};
+constexpr long int SEED = 1;
+constexpr unsigned int TCS = 4;
+constexpr double ALPHA = 0.5;
+constexpr unsigned int TSLICE = 64;
+// Timings are the best of this many runs
+constexpr int REPS = 3;
+// How much worse than the baseline a metric may get before it is flagged
+constexpr double THROUGHPUT_TOLERANCE = 0.25;
+constexpr double MEMORY_TOLERANCE = 0.10;
+
+struct Result {
+  std::string key;
+  std::string metric;
+  double value;
+};
+
+std::string caseName(const Case &c) {
+  std::ostringstream ss;
+  ss << "n=" << c.n << ",lambda=" << c.lambda << ",limit=" << c.limit;
+  return ss.str();
+}
+
+unsigned long long allocationCount() {
+  const std::atomic<unsigned long long> *count = AllocCounter::allocations();
+  return count ? count->load(std::memory_order_relaxed) : 0;
+}
+
+/* Returns heap the earlier cases freed to the system and starts the peak RSS
+ * (VmHWM) over from the current RSS, so peakRssKb() only sees what comes
+ * after. False if the kernel can't reset it. */
+bool resetPeakRss() {
+  malloc_trim(0);
+  std::ofstream ofs("/proc/self/clear_refs");
+  ofs << "5" << std::flush;
+  return (bool)ofs;
+}
+
+double peakRssKb() {
+  std::ifstream ifs("/proc/self/status");
+  std::string line;
+  while (std::getline(ifs, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0) {
+      return std::stod(line.substr(6));
+    }
+  }
+  throw std::runtime_error("Error: no VmHWM in /proc/self/status.");
+}
+
+std::string tempPath() {
+  char path[] = "/tmp/cpusim-benchXXXXXX";
+  const int fd = mkstemp(path);
+  if (fd < 0) {
+    throw std::runtime_error("Error: could not create a temporary file.");
+  }
+  close(fd);
+  return path;
+}
+
+template <class F> double bestTime(F f) {
+  double best = std::numeric_limits<double>::infinity();
+  for (int rep = 0; rep < REPS; ++rep) {
+    const Clock::time_point start = Clock::now();
+    f();
+    best = std::min(best, secondsSince(start));
+  }
+  return best;
+}
+
+/* Times run() of the policy makePolicy builds, logging every event to an
+ * temporary EventLog if fullOutput is set. */
+template <class MakePolicy>
+void benchAlgorithm(const Workload &workload, MakePolicy makePolicy,
+                    bool fullOutput, const std::string &key,
+                    std::vector<Result> &results) {
+  double best = std::numeric_limits<double>::infinity();
+  double elapsed = 0;
+  double ticks = 0;
+  double allocs = 0;
+  double peakRss = 0;
+  bool hasPeakRss = true;
+  for (int rep = 0; rep < REPS; ++rep) {
+    hasPeakRss = hasPeakRss && resetPeakRss();
+    EventLog log;
+    ProcessTable processes(workload);
+    auto policy = makePolicy(processes);
+    Scheduler<decltype(policy)> scheduler(processes, TCS, policy,
+                                          fullOutput ? &log : nullptr);
+    const unsigned long long allocsBefore = allocationCount();
+    const Clock::time_point start = Clock::now();
+    scheduler.run();
+    best = std::min(best, secondsSince(start));
+    allocs = allocationCount() - allocsBefore;
+    elapsed = scheduler.getElapsedTime();
+    ticks = scheduler.getNumEventTicks();
+    if (hasPeakRss) {
+      peakRss = std::max(peakRss, peakRssKb());
+    }
+  }
+  results.push_back({key, "sim_ms_per_s", elapsed / best});
+  results.push_back({key, "events_per_s", ticks / best});
+  if (AllocCounter::allocations()) {
+    results.push_back({key, "allocs_per_event", allocs / ticks});
+  }
+  if (hasPeakRss) {
+    results.push_back({key, "peak_rss_kb", peakRss});
+  }
+}
+
+void benchCase(const Case &c, std::vector<Result> &results) {
+  const std::string name = caseName(c);
+  Workload workload(ALPHA);
+  const double genTime = bestTime([&] {
+    workload = SeqGenerator::generateProccesses(c.n, c.lambda, c.limit, SEED,
+                                                ALPHA);
+  });
+  results.push_back({"generate/" + name, "procs_per_s", c.n / genTime});
+
+  const std::string textPath = tempPath();
+  const std::string binaryPath = tempPath();
+  SeqGenerator::writeProcesses(workload, textPath);
+  WorkloadFile::save(workload, binaryPath);
+  const double textTime = bestTime([&] {
+    SeqGenerator::parseProcesses(textPath, c.lambda, TCS, ALPHA, TSLICE);
+  });
+  results.push_back({"parse-text/" + name, "procs_per_s", c.n / textTime});
+  unsigned long long checksum = 0;
+  const double binaryTime = bestTime([&] {
+    // Touch every burst, mapping alone doesn't read anything
+    const Workload loaded = WorkloadFile::load(binaryPath);
+    for (unsigned long long i = 0; i < loaded.numBurstSlots(); ++i) {
+      checksum += loaded.getCpuBurstTime(i);
+    }
+  });
+  results.push_back({"load-binary/" + name, "procs_per_s", c.n / binaryTime});
+  unlink(textPath.c_str());
+  unlink(binaryPath.c_str());
+  if (!checksum) {
+    throw std::runtime_error("Error: loaded an empty benchmark workload.");
+  }
+
+  for (bool fullOutput : {false, true}) {
+    if (fullOutput && !c.fullOutput) {
+      break;
+    }
+    const std::string suffix = (fullOutput ? "/full/" : "/stats/") + name;
+    benchAlgorithm(
+        workload, [](const ProcessTable &) { return FcfsPolicy(); },
+        fullOutput, "run/FCFS" + suffix, results);
+    benchAlgorithm(
+        workload, [](const ProcessTable &procs) { return SjfPolicy(procs); },
+        fullOutput, "run/SJF" + suffix, results);
+    benchAlgorithm(
+        workload, [](const ProcessTable &procs) { return SrtPolicy(procs); },
+        fullOutput, "run/SRT" + suffix, results);
+    benchAlgorithm(
+        workload,
+        [](const ProcessTable &) { return RoundRobinPolicy<true>(TSLICE); },
+        fullOutput, "run/RR" + suffix, results);
+  }
+}
+
+/* Dispatches are the decisions a policy makes: every one picks the next
+ * process and, for the time-sliced and preemptive ones, asks the policy about
+ * it. */
+struct DecisionTiming {
+  double seconds;
+  unsigned long long decisions;
+  double avgWaitTime;
+};
+
+/* Times run() of the policy makePolicy builds, without logging. */
+template <class MakePolicy>
+DecisionTiming timeDecisions(const Workload &workload, MakePolicy makePolicy) {
+  DecisionTiming timing{std::numeric_limits<double>::infinity(), 0, 0};
+  for (int rep = 0; rep < REPS; ++rep) {
+    ProcessTable processes(workload);
+    auto policy = makePolicy(processes);
+    Scheduler<decltype(policy)> scheduler(processes, TCS, policy, nullptr);
+    const Clock::time_point start = Clock::now();
+    scheduler.run();
+    timing.seconds = std::min(timing.seconds, secondsSince(start));
+    const ProcessTable::Totals totals = processes.totals();
+    timing.decisions = totals.numCtxSwitches;
+    timing.avgWaitTime =
+        totals.numBursts ? (double)totals.waitTime / totals.numBursts : 0;
+  }
+  return timing;
+}
+
+// Prints timing and returns its ns per decision
+double reportDecisions(std::ostream &os, const std::string &name,
+                       const DecisionTiming &timing) {
+  const double ns =
+      timing.decisions ? timing.seconds * 1e9 / timing.decisions : 0;
+  os << "  " << std::left << std::setw(12) << name << std::right
+     << std::setw(10) << ns << " ns/decision" << std::setw(10)
+     << timing.decisions << " decisions, avg wait " << timing.avgWaitTime
+     << " ms";
+  return ns;
+}
+
+std::map<std::string, double> readBaseline(const std::string &path) {
+  std::map<std::string, double> baseline;
+  std::ifstream ifs(path);
+  std::string line;
+  while (std::getline(ifs, line)) {
+    std::istringstream ss(line);
+    std::string key;
+    std::string metric;
+    double value;
+    if (line.empty() || line[0] == '#' || !(ss >> key >> metric >> value)) {
+      continue;
+    }
+    baseline[key + " " + metric] = value;
+  }
+  return baseline;
+}
+
+// Whether value is worse enough than base to count as a regression
+bool isRegression(const std::string &metric, double value, double base) {
+  const std::string rate = "_per_s";
+  if (metric.size() > rate.size() &&
+      metric.compare(metric.size() - rate.size(), rate.size(), rate) == 0) {
+    return value < base * (1 - THROUGHPUT_TOLERANCE);
+  }
+  // allocs_per_event and peak_rss_kb: lower is better
+  return value > base * (1 + MEMORY_TOLERANCE) + 0.01;
+}
+
+} // namespace
+
+int Bench::suite(std::ostream &os, const std::string &baselinePath,
+                 bool update) {
+  std::vector<Result> results;
+  for (const Case &c : CASES) {
+    benchCase(c, results);
+  }
+
+  if (update) {
+    std::ofstream ofs(baselinePath);
+    ofs << "# Benchmark baseline, see src/Bench.hpp; regenerate with\n"
+        << "# make bench-baseline on the machine the numbers are for.\n";
+    ofs.precision(6);
+    for (const Result &r : results) {
+      ofs << r.key << " " << r.metric << " " << r.value << "\n";
+    }
+    if (!ofs) {
+      throw std::runtime_error("Error: could not write " + baselinePath +
+                               ".");
+    }
+    os << "Wrote " << results.size() << " results to " << baselinePath
+       << std::endl;
+    return 0;
+  }
+
+  const std::map<std::string, double> baseline = readBaseline(baselinePath);
+  int numRegressions = 0;
+  os.precision(4);
+  for (const Result &r : results) {
+    os << std::left << std::setw(52) << r.key << std::setw(17) << r.metric
+       << std::right << std::setw(11) << r.value;
+    auto it = baseline.find(r.key + " " + r.metric);
+    if (it != baseline.end()) {
+      os << "  baseline " << std::setw(11) << it->second;
+      if (it->second > 0) {
+        os << " " << std::showpos << std::fixed << std::setprecision(1)
+           << 100 * (r.value / it->second - 1) << "%" << std::noshowpos
+           << std::defaultfloat << std::setprecision(4);
+      }
+      if (isRegression(r.metric, r.value, it->second)) {
+        os << "  REGRESSION";
+        ++numRegressions;
+      }
+    }
+    os << std::endl;
+  }
+  os << numRegressions << " regression(s) against " << baselinePath
+     << std::endl;
+  return numRegressions;
+}
+
+void Bench::sampler(std::ostream &os, unsigned long count) {
+  static constexpr std::size_t BATCH = 4096;
+  static const double cases[][2] = {{0.001, 3000}, {0.01, 256}, {0.001, 256},
+                                    {0.001, 64}};
+  std::vector<double> uniforms(BATCH);
+  std::vector<unsigned int> values(BATCH);
+  os.precision(4);
+  for (const auto &c : cases) {
+    const double lambda = c[0];
+    const double maxval = c[1];
+
+    Rand48 rng(1);
+    unsigned long long sum = 0;
+    Clock::time_point start = Clock::now();
+    for (unsigned long i = 0; i < count; ++i) {
+      sum += SeqGenerator::ceilNextExp(rng, lambda, maxval);
+    }
+    report(os, "rejection  ", lambda, maxval, count, secondsSince(start),
+           (double)sum / count);
+
+    rng = Rand48(1);
+    sum = 0;
+    start = Clock::now();
+    for (unsigned long i = 0; i < count; i += BATCH) {
+      const std::size_t n = std::min<unsigned long>(BATCH, count - i);
+      for (std::size_t k = 0; k < n; ++k) {
+        uniforms[k] = rng.next();
+      }
+      ExpSampler::ceilTruncated(uniforms.data(), values.data(), n, lambda,
+                                maxval);
+      for (std::size_t k = 0; k < n; ++k) {
+        sum += values[k];
+      }
+    }
+    report(os, "inverse-cdf", lambda, maxval, count, secondsSince(start),
+           (double)sum / count);
+
+    // Kernel alone, on one batch of uniforms over and over
+    sum = 0;
+    start = Clock::now();
+    for (unsigned long i = 0; i < count; i += BATCH) {
+      const std::size_t n = std::min<unsigned long>(BATCH, count - i);
+      ExpSampler::ceilTruncated(uniforms.data(), values.data(), n, lambda,
+                                maxval);
+      for (std::size_t k = 0; k < n; ++k) {
+        sum += values[k];
+      }
+    }
+    report(os, "kernel     ", lambda, maxval, count, secondsSince(start),
+           (double)sum / count);
+  }
+}
+
+void Bench::plugin(std::ostream &os, const std::string &path,
+                   const std::string &args) {
+  const std::shared_ptr<const SchedulerPlugin> plugin =
+      SchedulerPlugin::load(path, args);
+  os.precision(4);
+  for (const Case &c : CASES) {
+    const Workload workload = SeqGenerator::generateProccesses(
+        c.n, c.lambda, c.limit, SEED, ALPHA);
+    os << caseName(c) << std::endl;
+    reportDecisions(
+        os, "FCFS",
+        timeDecisions(workload,
+                      [](const ProcessTable &) { return FcfsPolicy(); }));
+    os << std::endl;
+    reportDecisions(os, "SJF",
+                    timeDecisions(workload, [](const ProcessTable &procs) {
+                      return SjfPolicy(procs);
+                    }));
+    os << std::endl;
+    reportDecisions(os, "SRT",
+                    timeDecisions(workload, [](const ProcessTable &procs) {
+                      return SrtPolicy(procs);
+                    }));
+    os << std::endl;
+    const double rrNs = reportDecisions(
+        os, "RR", timeDecisions(workload, [](const ProcessTable &) {
+          return RoundRobinPolicy<true>(TSLICE);
+        }));
+    os << std::endl;
+    reportDecisions(os, "CFS",
+                    timeDecisions(workload, [](const ProcessTable &procs) {
+                      return CfsPolicy(procs, CfsConfig());
+                    }));
+    os << std::endl;
+    reportDecisions(os, "MLFQ",
+                    timeDecisions(workload, [](const ProcessTable &procs) {
+                      return MlfqPolicy(procs, MlfqConfig());
+                    }));
+    os << std::endl;
+    withPluginPolicy(*plugin, [&](auto *tag) {
+      typedef std::remove_pointer_t<decltype(tag)> Policy;
+      const double ns = reportDecisions(
+          os, plugin->ops().name,
+          timeDecisions(workload, [&plugin](const ProcessTable &procs) {
+            return Policy(procs, plugin);
+          }));
+      os << ", " << std::showpos << ns - rrNs << std::noshowpos
+         << " ns/decision against RR" << std::endl;
+    });
+  }
+}
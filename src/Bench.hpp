@@ -0,0 +1,61 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - Bench.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Throughput benchmarks, run with --bench. Each benchmark writes one line
+ * per case with its rate and a checksum-like statistic of what it computed,
+ * which keeps the work from being optimized away and lets two samplers be
+ * compared for agreement as well as speed.
+ *
+ *    suite: times workload generation, parsing a text process file, loading
+ * a binary workload file and every algorithm's run(), both without logging
+ * (stats only) and logging every event to an in-memory EventLog (full
+ * output, small cases only), for a few (n, lambda, limit) cases. run()
+ * reports simulated ms per wall second, event ticks per second, heap
+ * allocations per event tick (in bench.out only, see AllocCounter.hpp) and
+ * the process' peak RSS while it runs, which /proc/self/clear_refs resets
+ * before every run (left out where it can't). The results are compared with
+ * a baseline file of "key metric value" lines: throughput more than 25%
+ * below the baseline, or memory figures more than 10% above it, are flagged
+ * as regressions. With update set, the baseline is rewritten instead.
+ *
+ *    plugin: the cost per scheduling decision (dispatch) of a policy loaded
+ * from a shared object (see PluginPolicy.hpp) against the built-in ones, as
+ * run() time over the number of dispatches, stats only, on the suite's
+ * workloads. Every decision also pays for simulating what happens until the
+ * next one, so the difference to RR, which a plugin implementing round robin
+ * with the same time slice (64ms) should make identically, is the overhead of
+ * going through the C interface. The average wait time tells whether the
+ * policies did the same.
+ *
+ *    sampler: SeqGenerator::ceilNextExp() (REJECTION) against
+ * ExpSampler::ceilTruncated() (INVERSE_CDF) for a few lambda / limit pairs,
+ * both fed by a Rand48. The kernel is also timed on its own with the uniforms
+ * drawn beforehand.
+ */
+
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <iostream>
+#include <string>
+
+namespace Bench {
+
+// Number of regressions found, 0 after an update
+int suite(std::ostream &os, const std::string &baselinePath, bool update);
+
+void sampler(std::ostream &os, unsigned long count);
+
+// args is passed to the plugin's create()
+void plugin(std::ostream &os, const std::string &path,
+            const std::string &args);
+} // namespace Bench
+
+#endif
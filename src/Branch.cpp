@@ -0,0 +1,134 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - Branch.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ */
+
+#include "Branch.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <iostream>
+#include <poll.h>
+#include <stdexcept>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+struct Child {
+  pid_t pid;
+  int fd;
+  unsigned int branch;
+};
+
+/* Runs branch i in a child, writing its result to fd. */
+[[noreturn]] void
+runChild(int fd, unsigned int i,
+         const std::function<std::string(unsigned int)> &branch) {
+  int status = EXIT_SUCCESS;
+  try {
+    const std::string result = branch(i);
+    std::size_t written = 0;
+    while (written < result.size()) {
+      const ssize_t n =
+          write(fd, result.data() + written, result.size() - written);
+      if (n < 0 && errno != EINTR) {
+        status = EXIT_FAILURE;
+        break;
+      }
+      written += std::max<ssize_t>(n, 0);
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    status = EXIT_FAILURE;
+  }
+  _exit(status);
+}
+
+} // namespace
+
+std::vector<std::string>
+Branch::forkEach(unsigned int numBranches,
+                 const std::function<std::string(unsigned int)> &branch,
+                 unsigned int maxChildren) {
+  if (!maxChildren) {
+    maxChildren = std::max(1u, std::thread::hardware_concurrency());
+  }
+  std::vector<std::string> results(numBranches);
+  std::vector<Child> running;
+  unsigned int next = 0;
+  std::string error;
+  while ((next < numBranches && error.empty()) || !running.empty()) {
+    while (next < numBranches && running.size() < maxChildren &&
+           error.empty()) {
+      int fds[2];
+      if (pipe(fds) < 0) {
+        error = "Error: could not create a pipe for a branch.";
+        break;
+      }
+      const pid_t pid = fork();
+      if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        error = "Error: could not fork a branch.";
+        break;
+      }
+      if (pid == 0) {
+        close(fds[0]);
+        runChild(fds[1], next, branch);
+      }
+      close(fds[1]);
+      running.push_back({pid, fds[0], next});
+      ++next;
+    }
+    if (running.empty()) {
+      break;
+    }
+
+    // Drain the pipes as they fill so no child blocks on a large result
+    std::vector<pollfd> pollFds;
+    for (const Child &child : running) {
+      pollFds.push_back({child.fd, POLLIN, 0});
+    }
+    if (poll(pollFds.data(), pollFds.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error("Error: could not wait for a branch.");
+    }
+    for (std::size_t i = running.size(); i-- > 0;) {
+      if (!pollFds[i].revents) {
+        continue;
+      }
+      char buf[65536];
+      const ssize_t n = read(running[i].fd, buf, sizeof(buf));
+      if (n > 0) {
+        results[running[i].branch].append(buf, n);
+        continue;
+      }
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      close(running[i].fd);
+      int status = 0;
+      while (waitpid(running[i].pid, &status, 0) < 0 && errno == EINTR) {
+      }
+      if ((n < 0 || !WIFEXITED(status) || WEXITSTATUS(status)) &&
+          error.empty()) {
+        error = "Error: branch " + std::to_string(running[i].branch) +
+                " failed.";
+      }
+      running.erase(running.begin() + i);
+    }
+  }
+  if (!error.empty()) {
+    throw std::runtime_error(error);
+  }
+  return results;
+}
@@ -0,0 +1,45 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - Branch.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    What-if branches of a paused simulation (see Scheduler::runUntil()).
+ * forkEach() forks one child process per branch and calls branch(i) in child
+ * i, which typically changes a setting of the paused Scheduler it inherited
+ * and finishes the run. The children get the Scheduler, its ProcessTable and
+ * the workload through fork()'s copy-on-write pages, so the prefix the
+ * branches share is simulated once and each branch only pays for the pages
+ * it goes on to modify.
+ *
+ *    A child sends the string branch(i) returns back through a pipe and
+ * leaves with _exit(), so nothing the parent has buffered gets written twice.
+ * The results are returned in branch order; if a branch throws, its error
+ * goes to stderr and forkEach() throws once every child has finished. At most
+ * maxChildren children run at once, one per hardware thread if 0.
+ *
+ *    The calling process must not have other threads running: a child only
+ * gets the thread that forked it, so anything another thread holds (a lock,
+ * a half-written log) would stay that way in the child.
+ */
+
+#ifndef BRANCH_HPP
+#define BRANCH_HPP
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Branch {
+
+std::vector<std::string>
+forkEach(unsigned int numBranches,
+         const std::function<std::string(unsigned int)> &branch,
+         unsigned int maxChildren = 0);
+} // namespace Branch
+
+#endif
@@ -0,0 +1,175 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - CompletelyFair.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ */
+
+#include "CompletelyFair.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Linux's sched_prio_to_weight: each nice level is worth about 10% CPU time
+const unsigned int WEIGHTS[CfsConfig::MAX_NICE - CfsConfig::MIN_NICE + 1] = {
+    /* -20 */ 88761, 71755, 56483, 46273, 36291,
+    /* -15 */ 29154, 23254, 18705, 14949, 11916,
+    /* -10 */ 9548,  7620,  6100,  4904,  3906,
+    /*  -5 */ 3121,  2501,  1991,  1586,  1277,
+    /*   0 */ 1024,  820,   655,   526,   423,
+    /*   5 */ 335,   272,   215,   172,   137,
+    /*  10 */ 110,   87,    70,    56,    45,
+    /*  15 */ 36,    29,    23,    18,    15,
+};
+
+} // namespace
+
+CfsPolicy::CfsPolicy(const ProcessTable &procs, const CfsConfig &config)
+    : procs(&procs), config(std::make_shared<const CfsConfig>(config)),
+      entities(std::make_shared<std::vector<Entity>>(procs.size())),
+      readyQueue(VruntimeOrder{entities.get(), &procs}, procs.size()) {
+  if (!config.targetLatency || !config.minGranularity) {
+    throw std::runtime_error(
+        "Error: CFS target latency and granularity must be at least 1ms.");
+  }
+  for (int nice : config.niceLevels) {
+    getWeight(nice);
+  }
+}
+
+unsigned int CfsPolicy::getWeight(int nice) {
+  if (nice < CfsConfig::MIN_NICE || nice > CfsConfig::MAX_NICE) {
+    throw std::runtime_error("Error: nice level must be between " +
+                             std::to_string(CfsConfig::MIN_NICE) + " and " +
+                             std::to_string(CfsConfig::MAX_NICE) + ".");
+  }
+  return WEIGHTS[nice - CfsConfig::MIN_NICE];
+}
+
+std::string CfsPolicy::describe() const {
+  return "CFS with target latency " + std::to_string(config->targetLatency) +
+         "ms, minimum granularity " + std::to_string(config->minGranularity) +
+         "ms and wakeup granularity " +
+         std::to_string(config->wakeupGranularity) + "ms";
+}
+
+unsigned int CfsPolicy::timeSlice(Handle h) const {
+  const unsigned long long weight = (*entities)[h].weight;
+  const unsigned long long numRunnable = readyQueue.size() + 1;
+  const unsigned long long period =
+      std::max<unsigned long long>(config->targetLatency,
+                                   numRunnable * config->minGranularity);
+  const unsigned long long slice = period * weight / (queuedWeight + weight);
+  return std::max<unsigned long long>(slice, config->minGranularity);
+}
+
+/* min_vruntime never goes back; it follows the smaller of the vruntime of a
+ * process that just ran and the front of the queue. */
+void CfsPolicy::updateMinVruntime(unsigned long long vruntime) {
+  if (!readyQueue.empty()) {
+    vruntime = std::min(vruntime, (*entities)[readyQueue.first()].vruntime);
+  }
+  minVruntime = std::max(minVruntime, vruntime);
+}
+
+void CfsPolicy::popFront() {
+  const Handle h = readyQueue.first();
+  readyQueue.pop();
+  Entity &e = (*entities)[h];
+  queuedWeight -= e.weight;
+  e.remainingAtPick = procs->getRemainingBurstTime(h);
+  updateMinVruntime(e.vruntime);
+  e.lag = static_cast<signed long long>(e.vruntime - minVruntime);
+}
+
+void CfsPolicy::push(Handle h, ReadyReason reason) {
+  if (h >= entities->size()) {
+    entities->resize(h + 1);
+  }
+  Entity &e = (*entities)[h];
+  switch (reason) {
+  case ReadyReason::ARRIVED:
+    e = Entity();
+    e.weight = getWeight(config->getNice(procs->getPid(h)));
+    e.vruntime = minVruntime;
+    break;
+  case ReadyReason::IO_COMPLETED: {
+    // The last run went on to the end of the burst
+    e.vruntime += toVirtual(e.remainingAtPick, e.weight);
+    updateMinVruntime(e.vruntime);
+    const unsigned long long credit =
+        toVirtual(config->targetLatency, 2 * NICE_0_WEIGHT);
+    if (minVruntime > credit) {
+      e.vruntime = std::max(e.vruntime, minVruntime - credit);
+    }
+    break;
+  }
+  case ReadyReason::PREEMPTED:
+    e.vruntime += toVirtual(
+        e.remainingAtPick - procs->getRemainingBurstTime(h), e.weight);
+    updateMinVruntime(e.vruntime);
+    break;
+  case ReadyReason::MIGRATED:
+    e.vruntime = e.lag < 0 && static_cast<unsigned long long>(-e.lag) >
+                                  minVruntime
+                     ? 0
+                     : minVruntime + e.lag;
+    break;
+  }
+  readyQueue.push(h);
+  queuedWeight += e.weight;
+}
+
+void CfsPolicy::saveState(SnapshotWriter &out) const {
+  std::vector<unsigned long long> vruntimes;
+  std::vector<signed long long> lags;
+  std::vector<unsigned int> weights;
+  std::vector<unsigned int> remainingAtPicks;
+  for (const Entity &e : *entities) {
+    vruntimes.push_back(e.vruntime);
+    lags.push_back(e.lag);
+    weights.push_back(e.weight);
+    remainingAtPicks.push_back(e.remainingAtPick);
+  }
+  out.putArray(vruntimes);
+  out.putArray(lags);
+  out.putArray(weights);
+  out.putArray(remainingAtPicks);
+  out.putArray(readyQueue.sorted());
+  out.put(minVruntime);
+}
+
+void CfsPolicy::loadState(SnapshotReader &in, unsigned int numHandles) {
+  std::vector<unsigned long long> vruntimes;
+  std::vector<signed long long> lags;
+  std::vector<unsigned int> weights;
+  std::vector<unsigned int> remainingAtPicks;
+  in.getArray(vruntimes);
+  in.getArray(lags, vruntimes.size());
+  in.getArray(weights, vruntimes.size());
+  in.getArray(remainingAtPicks, vruntimes.size());
+  entities->resize(vruntimes.size());
+  for (std::size_t h = 0; h < vruntimes.size(); ++h) {
+    if (!weights[h]) {
+      in.fail("is truncated or corrupt");
+    }
+    Entity &e = (*entities)[h];
+    e.vruntime = vruntimes[h];
+    e.lag = lags[h];
+    e.weight = weights[h];
+    e.remainingAtPick = remainingAtPicks[h];
+  }
+  std::vector<Handle> handles;
+  in.getIndices(handles, std::min<std::size_t>(numHandles, entities->size()));
+  for (Handle h : handles) {
+    readyQueue.push(h);
+    queuedWeight += (*entities)[h].weight;
+  }
+  minVruntime = in.get<unsigned long long>();
+}
+
+template class Scheduler<CfsPolicy>;
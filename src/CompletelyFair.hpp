@@ -0,0 +1,166 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - CompletelyFair.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Scheduler policy modelled on Linux's Completely Fair Scheduler (CFS), see
+ * Policy.hpp. Every process has a weight given by its nice level (Linux's
+ * table, nice 0 = 1024) and a virtual runtime that grows by the time it runs
+ * scaled by 1024 / weight, kept in us so that nice 0 adds 1000 per ms. The
+ * ready process with the smallest vruntime runs next.
+ *
+ *    Time slices: each runnable process gets a share of the target latency
+ * proportional to its weight, but at least the minimum granularity; once the
+ * processes are too many for that, the period is stretched to minimum
+ * granularity times their number instead.
+ *
+ *    Placement: a new process starts at the queue's min_vruntime, the largest
+ * smallest vruntime seen there, and one waking up from I/O at no less than
+ * min_vruntime minus half the target latency, so sleepers get some credit but
+ * can't bank it. One moved to another queue keeps its distance from
+ * min_vruntime.
+ *
+ *    Wakeup preemption: a process becoming ready preempts the running one if
+ * its vruntime is more than the wakeup granularity (scaled to its weight)
+ * behind the running process' vruntime, including the current run. Since the
+ * running process loses its claim as it runs, the front of the ready queue is
+ * not checked every event tick; a running process is only cut short by a
+ * wakeup or by its time slice, as on Linux.
+ *
+ *    The ready queue is an IndexedTree ordered by vruntime, ties broken by
+ * pid, so pushes and pops are O(log n) and the front is cached. The per
+ * process state is shared between copies of a policy, so with SmpScheduler
+ * a process keeps its vruntime when it moves between CPUs.
+ *
+ *    Cfs is the Scheduler instantiation used by main(); it is compiled once in
+ * CompletelyFair.cpp.
+ */
+
+#ifndef COMPLETELYFAIR_HPP
+#define COMPLETELYFAIR_HPP
+
+#include "IndexedTree.hpp"
+#include "Policy.hpp"
+#include "ProcessTable.hpp"
+#include "Scheduler.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+struct CfsConfig {
+  static constexpr int MIN_NICE = -20;
+  static constexpr int MAX_NICE = 19;
+
+  // All in ms; Linux's defaults are 6/0.75/1ms (times 1 + log2 of the
+  // number of CPUs), scaled up here since a context switch takes ms
+  unsigned int targetLatency = 96;
+  unsigned int minGranularity = 12;
+  unsigned int wakeupGranularity = 16;
+  // Indexed by pid; processes past the end have nice level 0
+  std::vector<int> niceLevels;
+
+  int getNice(Process::Pid pid) const {
+    return pid < niceLevels.size() ? niceLevels[pid] : 0;
+  }
+};
+
+class CfsPolicy {
+public:
+  typedef ProcessTable::Handle Handle;
+
+  static constexpr bool timeSliced = true;
+  static constexpr bool preemptive = true;
+  static constexpr bool checksQueueFront = false;
+  static constexpr bool clocked = false;
+  static constexpr bool showTau = false;
+  static constexpr bool alwaysShowRemaining = false;
+  static constexpr bool exclusiveCutoff = false;
+
+  CfsPolicy(const ProcessTable &procs, const CfsConfig &config);
+
+  static const char *name() { return "CFS"; }
+  std::string describe() const;
+  unsigned int timeSlice(Handle h) const;
+  bool shouldPreempt(Handle running, Handle candidate) const {
+    const unsigned long long curr = getVruntime(running);
+    const unsigned long long vruntime = getVruntime(candidate);
+    return curr > vruntime &&
+           curr - vruntime >
+               toVirtual(config->wakeupGranularity,
+                         (*entities)[candidate].weight);
+  }
+
+  bool empty() const { return readyQueue.empty(); }
+  Handle front() const { return readyQueue.first(); }
+  void popFront();
+  void push(Handle h, ReadyReason reason);
+  template <class F> void forEachQueued(F f) const {
+    for (Handle h : readyQueue.sorted()) {
+      f(h);
+    }
+  }
+  void saveState(SnapshotWriter &out) const;
+  void loadState(SnapshotReader &in, unsigned int numHandles);
+
+  // Weight of nice level nice, MIN_NICE <= nice <= MAX_NICE
+  static unsigned int getWeight(int nice);
+
+private:
+  static constexpr unsigned int NICE_0_WEIGHT = 1024;
+
+  struct Entity {
+    unsigned long long vruntime = 0;
+    // vruntime - min_vruntime when last taken off a queue
+    signed long long lag = 0;
+    unsigned int weight = NICE_0_WEIGHT;
+    // Remaining burst time when last taken off a queue, i.e. dispatched
+    unsigned int remainingAtPick = 0;
+  };
+
+  struct VruntimeOrder {
+    const std::vector<Entity> *entities;
+    const ProcessTable *procs;
+    bool operator()(Handle left, Handle right) const {
+      const unsigned long long lv = (*entities)[left].vruntime;
+      const unsigned long long rv = (*entities)[right].vruntime;
+      return lv < rv ||
+             (lv == rv && procs->getPid(left) < procs->getPid(right));
+    }
+  };
+
+  static unsigned long long toVirtual(unsigned long long ms,
+                                      unsigned int weight) {
+    return ms * 1000 * NICE_0_WEIGHT / weight;
+  }
+
+  // h's vruntime including the time it has run since it was dispatched
+  unsigned long long getVruntime(Handle h) const {
+    const Entity &e = (*entities)[h];
+    if (readyQueue.contains(h)) {
+      return e.vruntime;
+    }
+    return e.vruntime +
+           toVirtual(e.remainingAtPick - procs->getRemainingBurstTime(h),
+                     e.weight);
+  }
+
+  void updateMinVruntime(unsigned long long vruntime);
+
+  const ProcessTable *procs;
+  std::shared_ptr<const CfsConfig> config;
+  std::shared_ptr<std::vector<Entity>> entities;
+  IndexedTree<VruntimeOrder> readyQueue;
+  unsigned long long minVruntime = 0;
+  unsigned long long queuedWeight = 0;
+};
+
+typedef Scheduler<CfsPolicy> Cfs;
+
+extern template class Scheduler<CfsPolicy>;
+
+#endif
@@ -0,0 +1,91 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - Event.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ */
+
+#include "Event.hpp"
+#include <stdexcept>
+
+void Event::writeProc(EventLog &log, const ProcessTable &procs,
+                      bool showTau) const {
+  if (proc == Process::NONE) {
+    throw std::runtime_error("Error: Event::write() called without a process.");
+  }
+  log << "Process " << procs.getName(proc);
+  if (showTau) {
+    log << " (tau " << tau << "ms)";
+  }
+}
+
+void Event::write(EventLog &log, const ProcessTable &procs,
+                  bool showTau) const {
+  log << "time " << timestamp << "ms: ";
+  switch (type) {
+  case Type::SIM_STARTED:
+    log << "Simulator started for " << text;
+    break;
+  case Type::SIM_ENDED:
+    log << "Simulator ended for " << text;
+    break;
+  case Type::ARRIVED:
+    writeProc(log, procs, showTau);
+    log << " arrived; placed on ready queue";
+    break;
+  case Type::ARRIVED_PREEMPTING:
+    writeProc(log, procs, showTau);
+    log << " arrived; preempting " << procs.getName(other);
+    break;
+  case Type::IO_COMPLETED:
+    writeProc(log, procs, showTau);
+    log << " completed I/O; placed on ready queue";
+    break;
+  case Type::IO_COMPLETED_PREEMPTING:
+    writeProc(log, procs, showTau);
+    log << " completed I/O; preempting " << procs.getName(other);
+    break;
+  case Type::STARTED_BURST:
+    writeProc(log, procs, showTau);
+    log << " started using the CPU for " << value << "ms burst";
+    break;
+  case Type::RESUMED_BURST:
+    writeProc(log, procs, showTau);
+    log << " started using the CPU with " << value << "ms burst remaining";
+    break;
+  case Type::SLICE_EXPIRED:
+    log << "Time slice expired; process " << procs.getName(proc)
+        << " preempted with " << value << "ms to go";
+    break;
+  case Type::SLICE_EXPIRED_NO_PREEMPTION:
+    log << "Time slice expired; no preemption because ready queue is empty";
+    break;
+  case Type::BURST_COMPLETED:
+    writeProc(log, procs, showTau);
+    log << " completed a CPU burst; " << value
+        << (value == 1 ? " burst to go" : " bursts to go");
+    break;
+  case Type::TAU_RECALCULATED:
+    log << "Recalculated tau (" << tau << "ms) for process "
+        << procs.getName(proc);
+    break;
+  case Type::SWITCHING_TO_IO:
+    log << "Process " << procs.getName(proc)
+        << " switching out of CPU; will block on I/O until time " << value
+        << "ms";
+    break;
+  case Type::TERMINATED:
+    log << "Process " << procs.getName(proc) << " terminated";
+    break;
+  case Type::WILL_PREEMPT:
+    writeProc(log, procs, showTau);
+    log << " will preempt " << procs.getName(other);
+    break;
+  default:
+    throw std::runtime_error("Error: Event::write() called for unrecognized "
+                             "event type.");
+  }
+}
@@ -0,0 +1,68 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - Event.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    A simulation event as a small record of plain numbers and handles. The
+ * schedulers create one per event and only turn it into text with write()
+ * once it is known to be shown, so events past the output cutoff (or all of
+ * them in stats-only runs) never touch a string.
+ *
+ *    write() outputs "time Xms: <detail>"; the caller appends the ready queue.
+ * Which of the fields are used depends on type:
+ *
+ *    proc: the process the event is about (all but SIM_*).
+ *    other: the process being preempted (*_PREEMPTING, WILL_PREEMPT).
+ *    tau: proc's tau as the event reports it.
+ *    value: the remaining burst time (STARTED_*, SLICE_EXPIRED), the number of
+ * bursts to go (BURST_COMPLETED) or the time I/O ends (SWITCHING_TO_IO).
+ *    text: the algorithm description (SIM_*).
+ */
+
+#ifndef EVENT_HPP
+#define EVENT_HPP
+
+#include "EventLog.hpp"
+#include "Process.hpp"
+#include "ProcessTable.hpp"
+
+struct Event {
+  enum class Type : char {
+    SIM_STARTED,
+    SIM_ENDED,
+    ARRIVED,
+    ARRIVED_PREEMPTING,
+    IO_COMPLETED,
+    IO_COMPLETED_PREEMPTING,
+    STARTED_BURST,
+    RESUMED_BURST,
+    SLICE_EXPIRED,
+    SLICE_EXPIRED_NO_PREEMPTION,
+    BURST_COMPLETED,
+    TAU_RECALCULATED,
+    SWITCHING_TO_IO,
+    TERMINATED,
+    WILL_PREEMPT
+  };
+
+  Type type;
+  unsigned int timestamp;
+  Process::Handle proc = Process::NONE;
+  Process::Handle other = Process::NONE;
+  unsigned int tau = 0;
+  unsigned int value = 0;
+  const char *text = nullptr;
+
+  // showTau labels processes as "Process A (tau Xms)" instead of "Process A"
+  void write(EventLog &log, const ProcessTable &procs, bool showTau) const;
+
+private:
+  void writeProc(EventLog &log, const ProcessTable &procs, bool showTau) const;
+};
+
+#endif
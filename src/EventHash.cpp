@@ -0,0 +1,442 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - EventHash.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ */
+
+#include "EventHash.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <climits>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+const char *const TYPE_NAMES[] = {"SIM_STARTED",
+                                  "SIM_ENDED",
+                                  "ARRIVED",
+                                  "ARRIVED_PREEMPTING",
+                                  "IO_COMPLETED",
+                                  "IO_COMPLETED_PREEMPTING",
+                                  "STARTED_BURST",
+                                  "RESUMED_BURST",
+                                  "SLICE_EXPIRED",
+                                  "SLICE_EXPIRED_NO_PREEMPTION",
+                                  "BURST_COMPLETED",
+                                  "TAU_RECALCULATED",
+                                  "SWITCHING_TO_IO",
+                                  "TERMINATED",
+                                  "WILL_PREEMPT"};
+
+struct Record {
+  char kind;
+  unsigned long long events;
+  unsigned long long time;
+  std::string line;
+};
+
+struct HashFile {
+  std::string path;
+  std::string algorithm;
+  std::string interval;
+  std::string cwd;
+  std::vector<std::string> command;
+  std::vector<Record> records;
+};
+
+HashFile load(const std::string &path) {
+  std::ifstream ifs(path);
+  if (!ifs) {
+    throw std::runtime_error("Error: could not open hash file " + path + ".");
+  }
+  HashFile file;
+  file.path = path;
+  std::string line;
+  if (!std::getline(ifs, line) || line != "# cpusim-hash 1") {
+    throw std::runtime_error("Error: " + path + " is not a hash file.");
+  }
+  while (std::getline(ifs, line)) {
+    if (line.rfind("# ", 0) == 0) {
+      const std::size_t space = line.find(' ', 2);
+      const std::string key = line.substr(2, space - 2);
+      const std::string value =
+          space == std::string::npos ? "" : line.substr(space + 1);
+      if (key == "algorithm") {
+        file.algorithm = value;
+      } else if (key == "interval") {
+        file.interval = value;
+      } else if (key == "cwd") {
+        file.cwd = value;
+      } else if (key == "arg") {
+        file.command.push_back(value);
+      }
+      continue;
+    }
+    Record record;
+    std::istringstream iss(line);
+    if (!(iss >> record.kind >> record.events >> record.time) ||
+        (record.kind != 'C' && record.kind != 'E' && record.kind != 'F')) {
+      throw std::runtime_error("Error: hash file " + path +
+                               " is truncated or corrupt.");
+    }
+    record.line = line;
+    file.records.push_back(record);
+  }
+  return file;
+}
+
+std::string fmtPid(const std::string &pid) {
+  return pid == std::to_string(UINT32_MAX) ? "-"
+                                           : Process::fmtPid(std::stoul(pid));
+}
+
+// An E line as "time Xms: TYPE A (other B) tau T value V"
+std::string describe(const Record &record) {
+  if (record.kind != 'E') {
+    return "time " + std::to_string(record.time) + "ms: " +
+           (record.kind == 'F' ? "end of the run" : "end of event tick");
+  }
+  std::istringstream iss(record.line);
+  std::string kind, event, time, hash, proc, other, tau, value;
+  unsigned int type;
+  iss >> kind >> event >> time >> hash >> type >> proc >> other >> tau >>
+      value;
+  std::string s = "time " + time + "ms: " +
+                  (type < sizeof(TYPE_NAMES) / sizeof(*TYPE_NAMES)
+                       ? TYPE_NAMES[type]
+                       : "?");
+  s += " " + fmtPid(proc);
+  if (other != std::to_string(UINT32_MAX)) {
+    s += " (other " + fmtPid(other) + ")";
+  }
+  return s + " tau " + tau + " value " + value;
+}
+
+// Index of the first record that differs, or of the end of the shorter file
+std::size_t firstDifference(const HashFile &a, const HashFile &b) {
+  std::size_t i = 0;
+  while (i < a.records.size() && i < b.records.size() &&
+         a.records[i].line == b.records[i].line) {
+    ++i;
+  }
+  return i;
+}
+
+// This executable, not the one a hash file names
+std::string selfPath() {
+  char exe[PATH_MAX];
+  const ssize_t len = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+  if (len <= 0) {
+    throw std::runtime_error("Error: could not find the simulator to run "
+                             "again to narrow down the divergence.");
+  }
+  return std::string(exe, len);
+}
+
+// The command of file with --hash-detail, writing to prefix-*.hash
+std::vector<std::string> detailArgs(const HashFile &file,
+                                    const std::string &prefix,
+                                    unsigned long long from,
+                                    unsigned long long to) {
+  std::vector<std::string> args{selfPath()};
+  for (std::size_t i = 1; i < file.command.size(); ++i) {
+    if (file.command[i].rfind("--hash", 0) != 0) {
+      args.push_back(file.command[i]);
+    }
+  }
+  args.push_back("--hash=" + prefix);
+  args.push_back("--hash-detail=" + file.algorithm + ":" +
+                 std::to_string(from) + "-" + std::to_string(to));
+  return args;
+}
+
+// arg quoted for a POSIX shell where it needs to be
+std::string shellQuote(const std::string &arg) {
+  if (!arg.empty() &&
+      arg.find_first_not_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVW"
+                            "XYZ0123456789_-+=.,:/@%") == std::string::npos) {
+    return arg;
+  }
+  std::string quoted = "'";
+  for (char c : arg) {
+    quoted += c == '\'' ? std::string("'\\''") : std::string(1, c);
+  }
+  return quoted + "'";
+}
+
+void printCommand(const std::string &cwd, const std::vector<std::string> &args,
+                  std::ostream &os) {
+  os << "  cd " << shellQuote(cwd) << " &&";
+  for (const std::string &arg : args) {
+    os << " " << shellQuote(arg);
+  }
+  os << std::endl;
+}
+
+// Throws if the command of file loads a shared object: it could do anything
+void checkRerunnable(const HashFile &file) {
+  for (const std::string &arg : file.command) {
+    if (arg.rfind("--plugin=", 0) == 0) {
+      throw std::runtime_error("Error: " + file.path + " was recorded with " +
+                               arg + ", which --hash-diff won't load; run " +
+                               "it again by hand instead.");
+    }
+  }
+}
+
+// Runs the command of file with --hash-detail, writing to prefix-*.hash
+pid_t spawnDetail(const HashFile &file, const std::string &prefix,
+                  unsigned long long from, unsigned long long to,
+                  std::ostream &os) {
+  std::vector<std::string> args = detailArgs(file, prefix, from, to);
+  os << "Running in " << file.cwd << ":";
+  for (const std::string &arg : args) {
+    os << " " << arg;
+  }
+  os << std::endl;
+  std::vector<char *> argv;
+  for (std::string &arg : args) {
+    argv.push_back(&arg[0]);
+  }
+  argv.push_back(nullptr);
+
+  const pid_t pid = fork();
+  if (pid == 0) {
+    const int null = open("/dev/null", O_WRONLY);
+    if (null < 0 || chdir(file.cwd.c_str()) != 0 || dup2(null, 1) < 0 ||
+        dup2(null, 2) < 0) {
+      _exit(127);
+    }
+    execv(argv[0], argv.data());
+    _exit(127);
+  }
+  return pid;
+}
+
+bool succeeded(pid_t pid) {
+  int status = 0;
+  if (pid < 0) {
+    return false;
+  }
+  while (waitpid(pid, &status, 0) < 0) {
+    if (errno != EINTR) {
+      return false;
+    }
+  }
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// Writes the differing records at index i, at least one of them an event
+void printEvent(const HashFile &a, const HashFile &b, std::size_t i,
+                std::ostream &os) {
+  const Record &ra = a.records[i];
+  const Record &rb = b.records[i];
+  os << "First diverging event, " << std::max(ra.events, rb.events) << ":"
+     << std::endl
+     << "  " << a.path << ": " << describe(ra) << std::endl
+     << "  " << b.path << ": " << describe(rb) << std::endl;
+}
+
+bool compare(const HashFile &a, const HashFile &b, std::ostream &os,
+             bool narrow, bool rerun);
+
+/* Runs both simulations again, recording the events in (from, to] one by
+ * one, and compares those records instead. */
+void narrowDown(const HashFile &a, const HashFile &b, unsigned long long from,
+                unsigned long long to, std::ostream &os) {
+  checkRerunnable(a);
+  checkRerunnable(b);
+  const char *tmp = getenv("TMPDIR");
+  std::string dir = std::string(tmp && *tmp ? tmp : "/tmp") +
+                    "/cpusim-hash-XXXXXX";
+  if (!mkdtemp(&dir[0])) {
+    throw std::runtime_error("Error: could not create a temporary directory "
+                             "to narrow down the divergence in.");
+  }
+  const pid_t pidA = spawnDetail(a, dir + "/a", from + 1, to, os);
+  const pid_t pidB = spawnDetail(b, dir + "/b", from + 1, to, os);
+  const bool okA = succeeded(pidA);
+  const bool okB = succeeded(pidB);
+  const std::string pathA = dir + "/a-" + a.algorithm + ".hash";
+  const std::string pathB = dir + "/b-" + b.algorithm + ".hash";
+  std::string error;
+  try {
+    if (!okA || !okB) {
+      throw std::runtime_error(
+          "Error: could not run the simulation of " +
+          (okA ? b.path : a.path) + " again to narrow down the divergence.");
+    }
+    HashFile detailA = load(pathA);
+    HashFile detailB = load(pathB);
+    detailA.path = a.path;
+    detailB.path = b.path;
+    if (compare(detailA, detailB, os, false, false)) {
+      os << "Both runs agree over those events when run again; one of them "
+            "isn't deterministic"
+         << std::endl;
+    }
+  } catch (const std::exception &e) {
+    error = e.what();
+  }
+  unlink(pathA.c_str());
+  unlink(pathB.c_str());
+  rmdir(dir.c_str());
+  if (!error.empty()) {
+    throw std::runtime_error(error);
+  }
+}
+
+bool compare(const HashFile &a, const HashFile &b, std::ostream &os,
+             bool narrow, bool rerun) {
+  const std::size_t i = firstDifference(a, b);
+  if (i == a.records.size() && i == b.records.size()) {
+    if (narrow) {
+      os << a.path << " and " << b.path << " match";
+      if (!a.records.empty()) {
+        os << ": " << a.records.back().events << " events";
+      }
+      os << std::endl;
+    }
+    return true;
+  }
+  // The last event both agree on
+  unsigned long long agreed = 0;
+  for (std::size_t j = i; j-- > 0;) {
+    if (a.records[j].kind != 'E') {
+      agreed = a.records[j].events;
+      os << a.path << " and " << b.path << " agree up to event " << agreed
+         << " (time " << a.records[j].time << "ms)" << std::endl;
+      break;
+    }
+  }
+  if (i == a.records.size() || i == b.records.size()) {
+    const HashFile &shorter = i == a.records.size() ? a : b;
+    os << shorter.path << " ends there; the other one goes on" << std::endl;
+    return false;
+  }
+  const Record &ra = a.records[i];
+  const Record &rb = b.records[i];
+  if (!narrow && ra.kind == 'C' && rb.kind == 'C') {
+    os << "The events agree, but the states differ after the event tick at "
+          "time "
+       << std::min(ra.time, rb.time) << "ms" << std::endl;
+    // The events usually follow soon; the C lines line up until they do
+    std::size_t j = i;
+    while (j < a.records.size() && j < b.records.size() &&
+           ((a.records[j].kind == 'C' && b.records[j].kind == 'C') ||
+            a.records[j].line == b.records[j].line)) {
+      ++j;
+    }
+    if (j < a.records.size() && j < b.records.size()) {
+      printEvent(a, b, j, os);
+    }
+    return false;
+  }
+  if (ra.kind == 'E' || rb.kind == 'E') {
+    printEvent(a, b, i, os);
+    return false;
+  }
+  const unsigned long long to = std::max(ra.events, rb.events);
+  os << "They first differ by event " << to << std::endl;
+  if (a.command.empty() || b.command.empty() || a.algorithm.empty() ||
+      b.algorithm.empty()) {
+    os << "Run both again with --hash-detail=<algorithm>:" << agreed + 1
+       << "-" << to << " to find the event" << std::endl;
+    return false;
+  }
+  if (!rerun) {
+    os << "Run both again recording those events:" << std::endl;
+    printCommand(a.cwd, detailArgs(a, "detail-a", agreed + 1, to), os);
+    printCommand(b.cwd, detailArgs(b, "detail-b", agreed + 1, to), os);
+    os << "and --hash-diff the two detail-*.hash files they write to find the "
+          "event, or pass --rerun to have them run"
+       << std::endl;
+    return false;
+  }
+  os << "Narrowing down..." << std::endl;
+  narrowDown(a, b, agreed, to, os);
+  return false;
+}
+
+} // namespace
+
+EventHash::EventHash(const std::string &path, const std::string &algorithm,
+                     const Settings &settings)
+    : path(path), settings(settings),
+      nextCheckpoint(std::max(1ULL, settings.interval)) {
+  fp = fopen(path.c_str(), "w");
+  if (fp == NULL) {
+    throw std::runtime_error("Error: could not create hash file " + path +
+                             ".");
+  }
+  fprintf(fp, "# cpusim-hash 1\n# algorithm %s\n# interval %llu\n",
+          algorithm.c_str(), settings.interval);
+  if (!settings.cwd.empty()) {
+    fprintf(fp, "# cwd %s\n", settings.cwd.c_str());
+  }
+  for (const std::string &arg : settings.command) {
+    fprintf(fp, "# arg %s\n", arg.c_str());
+  }
+}
+
+EventHash::~EventHash() { fclose(fp); }
+
+void EventHash::writeEvent(const Event &e, std::uint64_t proc,
+                           std::uint64_t other) {
+  fprintf(fp, "E %llu %u %016" PRIx64 " %d %" PRIu64 " %" PRIu64 " %u %u\n",
+          numEvents, e.timestamp, hash, (int)e.type, proc, other, e.tau,
+          e.value);
+}
+
+void EventHash::writeLine(char kind, unsigned int timestamp,
+                          std::uint64_t stateHash) {
+  fprintf(fp, "%c %llu %u %016" PRIx64 " %016" PRIx64 "\n", kind, numEvents,
+          timestamp, hash, stateHash);
+}
+
+void EventHash::checkpoint(unsigned int timestamp, std::uint64_t stateHash) {
+  writeLine('C', timestamp, stateHash);
+  lastCheckpoint = numEvents;
+  const unsigned long long interval = std::max(1ULL, settings.interval);
+  const unsigned long long next = numEvents - numEvents % interval;
+  nextCheckpoint = next > std::numeric_limits<unsigned long long>::max() -
+                              interval
+                       ? std::numeric_limits<unsigned long long>::max()
+                       : next + interval;
+}
+
+void EventHash::finish(unsigned int timestamp, std::uint64_t stateHash) {
+  writeLine('F', timestamp, stateHash);
+  if (fflush(fp) != 0 || ferror(fp)) {
+    throw std::runtime_error("Error: could not write hash file " + path +
+                             ".");
+  }
+}
+
+bool EventHash::diff(const std::string &a, const std::string &b,
+                     std::ostream &os, bool rerun) {
+  const HashFile fileA = load(a);
+  const HashFile fileB = load(b);
+  // Their checkpoints would fall on different events
+  if (fileA.interval != fileB.interval) {
+    throw std::runtime_error("Error: " + a + " and " + b +
+                             " were hashed with different --hash-every.");
+  }
+  // Files from --hash-detail already record every event of their range
+  const auto isEvent = [](const Record &r) { return r.kind == 'E'; };
+  const bool detail =
+      std::any_of(fileA.records.begin(), fileA.records.end(), isEvent) ||
+      std::any_of(fileB.records.begin(), fileB.records.end(), isEvent);
+  return compare(fileA, fileB, os, !detail, rerun);
+}
@@ -0,0 +1,133 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - EventHash.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Rolling hash of the event stream of one simulation run, so two runs (or
+ * two builds of the simulator) can be compared without writing or diffing
+ * their event logs. The Scheduler hands every event to addEvent(), logged or
+ * not, i.e. every event a --cutoff=none run would log; the hash covers its
+ * type, time, processes (by pid), tau and value, not its text, so a plugin
+ * named RR-plugin can match RR. At the end of every event tick with events,
+ * once interval more events have happened since the last checkpoint, the
+ * Scheduler also hashes its state (time, burst and context switch timers,
+ * who runs or switches, the ready queue in order, the I/O queue and every
+ * live process' state, bursts to go and remaining burst time) and
+ * checkpoint() writes both hashes out. Checkpoints are thus placed by events,
+ * not ticks, and line up between engines that step time differently, such
+ * as Scheduler and a one-CPU SmpScheduler.
+ *
+ *    The file is text, one record per line:
+ *
+ *      # cpusim-hash 1             header lines first, then
+ *      # algorithm <name>
+ *      # interval <events>
+ *      # cwd <dir>                 how to run the simulation again
+ *      # arg <argument>            one line per argument, argv[0] first
+ *      C <events> <time> <event hash> <state hash>     checkpoint
+ *      E <event> <time> <event hash> <type> <pid> <pid> <tau> <value>
+ *      F <events> <time> <event hash> <state hash>     end of the run
+ *
+ * Events count from 1 and hashes are 16 hex digits. E lines (and a C line
+ * after every event tick) are only written for the events in [detailFrom,
+ * detailTo]; a run with such a range only needs to get that far, see
+ * isDone().
+ *
+ *    diff() compares two files. If their checkpoints differ, the divergence
+ * is narrowed down to one event by running both recorded commands again with
+ * --hash-detail over the events between the last matching checkpoint and the
+ * first differing one and comparing those files line by line. The commands
+ * are those recorded, in their recorded directories, but on this executable
+ * rather than the recorded argv[0]. A hash file may come from anyone, so
+ * diff() only prints them unless asked to rerun them, and never reruns one
+ * recorded with --plugin=, which would load a shared object it names. The
+ * first E line that differs is the first diverging event; if a C line
+ * differs before it, the states diverged first and the event is reported
+ * after that.
+ */
+
+#ifndef EVENTHASH_HPP
+#define EVENTHASH_HPP
+
+#include "Event.hpp"
+#include "ProcessTable.hpp"
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+class EventHash {
+public:
+  struct Settings {
+    unsigned long long interval = 1000000;
+    unsigned long long detailFrom = 1;
+    unsigned long long detailTo = 0;
+    // How this run was started: working directory and arguments
+    std::string cwd;
+    std::vector<std::string> command;
+  };
+
+  static std::uint64_t mix(std::uint64_t hash, std::uint64_t word) {
+    hash = (hash ^ word) * 0x9e3779b97f4a7c15ULL;
+    return hash ^ (hash >> 29);
+  }
+
+  EventHash(const std::string &path, const std::string &algorithm,
+            const Settings &settings);
+  EventHash(const EventHash &) = delete;
+  EventHash &operator=(const EventHash &) = delete;
+  ~EventHash();
+
+  void addEvent(const Event &e, const ProcessTable &procs) {
+    const std::uint64_t proc =
+        e.proc == Process::NONE ? UINT32_MAX : procs.getPid(e.proc);
+    const std::uint64_t other =
+        e.other == Process::NONE ? UINT32_MAX : procs.getPid(e.other);
+    hash = mix(hash, (std::uint64_t)e.type << 32 | e.timestamp);
+    hash = mix(hash, proc << 32 | other);
+    hash = mix(hash, (std::uint64_t)e.tau << 32 | e.value);
+    ++numEvents;
+    if (numEvents >= settings.detailFrom && numEvents <= settings.detailTo) {
+      writeEvent(e, proc, other);
+    }
+  }
+  // Whether the event tick that just ended needs a checkpoint
+  bool wantsCheckpoint() const {
+    return numEvents != lastCheckpoint &&
+           (numEvents >= nextCheckpoint ||
+            (numEvents >= settings.detailFrom &&
+             lastCheckpoint < settings.detailTo));
+  }
+  void checkpoint(unsigned int timestamp, std::uint64_t stateHash);
+  void finish(unsigned int timestamp, std::uint64_t stateHash);
+  // Whether every event of the detail range has been recorded
+  bool isDone() const {
+    return settings.detailTo && lastCheckpoint >= settings.detailTo;
+  }
+
+  // Writes the differences of the files at a and b to os; true if none.
+  // Only runs the recorded commands again if rerun is set.
+  static bool diff(const std::string &a, const std::string &b,
+                   std::ostream &os, bool rerun = false);
+
+private:
+  void writeEvent(const Event &e, std::uint64_t proc, std::uint64_t other);
+  void writeLine(char kind, unsigned int timestamp, std::uint64_t stateHash);
+
+  std::string path;
+  Settings settings;
+  FILE *fp;
+  std::uint64_t hash = 0xcbf29ce484222325ULL;
+  unsigned long long numEvents = 0;
+  unsigned long long lastCheckpoint = 0;
+  unsigned long long nextCheckpoint;
+};
+
+#endif
@@ -0,0 +1,161 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - EventLog.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ */
+
+#include "EventLog.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+
+EventLog::EventLog() : fd(-1), temporary(true) {}
+
+EventLog::EventLog(int fd, bool background) : fd(fd), temporary(false) {
+  if (fd < 0) {
+    throw std::runtime_error("Error: EventLog given an invalid fd.");
+  }
+  buffer.reserve(BUFFER_SIZE + BUFFER_SIZE / 8);
+  if (background) {
+    pending.reserve(buffer.capacity());
+    writer = std::thread(&EventLog::writerLoop, this);
+  }
+}
+
+EventLog::~EventLog() {
+  try {
+    flush();
+  } catch (const std::exception &) {
+    // Nowhere left to report it; the output is simply cut short.
+  }
+  if (writer.joinable()) {
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      stopping = true;
+    }
+    changed.notify_all();
+    writer.join();
+  }
+  if (temporary && fd >= 0) {
+    close(fd);
+  }
+}
+
+int EventLog::writeAll(const std::string &data) {
+  const char *p = data.data();
+  std::size_t left = data.size();
+  while (left) {
+    ssize_t n = ::write(fd, p, left);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return errno;
+    }
+    p += n;
+    left -= n;
+  }
+  return 0;
+}
+
+void EventLog::throwWriteError(int err) {
+  throw std::runtime_error(std::string("Error: EventLog write failed: ") +
+                           std::strerror(err));
+}
+
+void EventLog::handOff() {
+  if (fd < 0) {
+    const char *tmp = getenv("TMPDIR");
+    std::string path =
+        std::string(tmp && *tmp ? tmp : "/tmp") + "/cpusim-log-XXXXXX";
+    fd = mkstemp(&path[0]);
+    if (fd < 0) {
+      throw std::runtime_error(
+          "Error: could not create a temporary file for an event log: " +
+          std::string(std::strerror(errno)));
+    }
+    unlink(path.c_str());
+  }
+  if (!writer.joinable()) {
+    int err = writeAll(buffer);
+    buffer.clear();
+    if (err) {
+      throwWriteError(err);
+    }
+    return;
+  }
+  std::unique_lock<std::mutex> guard(lock);
+  changed.wait(guard, [this] { return !hasPending; });
+  pending.swap(buffer);
+  hasPending = true;
+  guard.unlock();
+  changed.notify_all();
+  buffer.clear();
+}
+
+void EventLog::flush() {
+  if (temporary) {
+    // Kept until copyTo()
+    return;
+  }
+  if (!buffer.empty()) {
+    handOff();
+  }
+  if (writer.joinable()) {
+    std::unique_lock<std::mutex> guard(lock);
+    changed.wait(guard, [this] { return !hasPending; });
+    if (writeErrno) {
+      int err = writeErrno;
+      writeErrno = 0;
+      throwWriteError(err);
+    }
+  }
+}
+
+void EventLog::writerLoop() {
+  std::unique_lock<std::mutex> guard(lock);
+  while (true) {
+    changed.wait(guard, [this] { return hasPending || stopping; });
+    if (!hasPending) {
+      return;
+    }
+    guard.unlock();
+    int err = writeAll(pending);
+    pending.clear();
+    guard.lock();
+    if (err && !writeErrno) {
+      writeErrno = err;
+    }
+    hasPending = false;
+    changed.notify_all();
+  }
+}
+
+void EventLog::copyTo(EventLog &out) {
+  if (fd >= 0) {
+    if (lseek(fd, 0, SEEK_SET) < 0) {
+      throwWriteError(errno);
+    }
+    std::string chunk(BUFFER_SIZE, '\0');
+    while (true) {
+      const ssize_t n = read(fd, &chunk[0], chunk.size());
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n < 0) {
+        throwWriteError(errno);
+      }
+      if (n == 0) {
+        break;
+      }
+      out.write(chunk.data(), n);
+    }
+  }
+  out.write(buffer.data(), buffer.size());
+}
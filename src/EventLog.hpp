@@ -0,0 +1,102 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - EventLog.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Output path for the simulation event log. Events are appended to a large
+ * in-memory buffer that is only written out (with as few write() calls as
+ * possible) when it fills up, when flush() is called and when the EventLog is
+ * destroyed, so a run that throws still gets everything up to the failure
+ * written out as its stack unwinds. Unlike std::endl nothing here flushes per
+ * line.
+ *
+ *    EventLog(fd) writes to a file descriptor. With background = true full
+ * buffers are handed to a writer thread and the caller carries on formatting
+ * into a second buffer while the first one is written; write errors then
+ * surface from the next flush().
+ *
+ *    EventLog() is for runs whose output has to wait its turn: full buffers
+ * go to an unlinked temporary file, created on the first one, so memory stays
+ * at one buffer however long the run is, and copyTo() later writes all of it
+ * to another EventLog.
+ */
+
+#ifndef EVENTLOG_HPP
+#define EVENTLOG_HPP
+
+#include <charconv>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class EventLog {
+public:
+  static constexpr std::size_t BUFFER_SIZE = 1 << 20;
+
+  EventLog();
+  explicit EventLog(int fd, bool background = false);
+  ~EventLog();
+  EventLog(const EventLog &) = delete;
+  EventLog &operator=(const EventLog &) = delete;
+
+  void write(const char *data, std::size_t len) {
+    buffer.append(data, len);
+    if (buffer.size() >= BUFFER_SIZE) {
+      handOff();
+    }
+  }
+  EventLog &operator<<(const std::string &s) {
+    write(s.data(), s.size());
+    return *this;
+  }
+  EventLog &operator<<(const char *s) {
+    write(s, std::char_traits<char>::length(s));
+    return *this;
+  }
+  EventLog &operator<<(char c) {
+    write(&c, 1);
+    return *this;
+  }
+  EventLog &operator<<(unsigned long long n) {
+    char digits[20];
+    const auto res = std::to_chars(digits, digits + sizeof(digits), n);
+    write(digits, res.ptr - digits);
+    return *this;
+  }
+  EventLog &operator<<(unsigned int n) {
+    return *this << (unsigned long long)n;
+  }
+
+  void flush();
+  // Writes everything written so far to out, only for temporary logs
+  void copyTo(EventLog &out);
+
+private:
+  void handOff();
+  // Returns 0 or the errno of the failed write
+  int writeAll(const std::string &data);
+  static void throwWriteError(int err);
+  void writerLoop();
+
+  int fd;
+  // Whether fd is the temporary file of an EventLog()
+  const bool temporary;
+  std::string buffer;
+
+  // Background writer only; pending is the buffer being written out
+  std::thread writer;
+  std::mutex lock;
+  std::condition_variable changed;
+  std::string pending;
+  bool hasPending = false;
+  bool stopping = false;
+  int writeErrno = 0;
+};
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - ExpSampler.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ */
+
+#include "ExpSampler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+// Values per kernel call; a constant trip count lets -O2 vectorize the loop
+constexpr std::size_t BLOCK = 16;
+
+constexpr double LN2 = 0.6931471805599453094;
+
+inline double fromBits(std::uint64_t bits) {
+  double d;
+  std::memcpy(&d, &bits, sizeof(d));
+  return d;
+}
+
+inline std::uint64_t toBits(double d) {
+  std::uint64_t bits;
+  std::memcpy(&bits, &d, sizeof(bits));
+  return bits;
+}
+
+// x = m * 2^e with m in [sqrt(1/2), sqrt(2)), then log(m) = 2 atanh(s) with
+// s = (m - 1) / (m + 1), |s| < 0.172, summed up to s^17. Only integer and
+// floating point arithmetic, no branches, so that loops over it vectorize.
+inline double logKernel(double x) {
+  // Offsetting the bits by those of sqrt(1/2) moves the exponent boundary to
+  // the mantissa sqrt(2) (the fdlibm trick).
+  constexpr std::uint64_t SQRT_HALF_BITS = 0x3fe6a09e667f3bcdULL;
+  const std::uint64_t bits =
+      toBits(x) + (0x3ff0000000000000ULL - SQRT_HALF_BITS);
+  // The exponent field as a double, without an int -> double conversion
+  const double e = fromBits(0x4330000000000000ULL | (bits >> 52)) -
+                   (4503599627370496.0 + 1023.0);
+  const double m = fromBits((bits & 0x000fffffffffffffULL) + SQRT_HALF_BITS);
+  const double s = (m - 1.0) / (m + 1.0);
+  const double s2 = s * s;
+  const double poly =
+      s2 * (1.0 / 3 +
+            s2 * (1.0 / 5 +
+                  s2 * (1.0 / 7 +
+                        s2 * (1.0 / 9 +
+                              s2 * (1.0 / 11 +
+                                    s2 * (1.0 / 13 +
+                                          s2 * (1.0 / 15 + s2 / 17)))))));
+  return e * LN2 + 2.0 * s + 2.0 * s * poly;
+}
+
+/* x[k] = -log(1 - w[k] * p) * scale: the inverse CDF of Exp(1 / scale)
+ * truncated to [0, -log(1 - p) * scale). 1 - w[k] * p is only 0 when p
+ * rounds to 1, and the (finite) value the kernel gives for it is clamped to
+ * maxval afterwards like any other. */
+inline void inverseCdfBlock(const double *w, double *x, double p,
+                            double scale) {
+  for (std::size_t k = 0; k < BLOCK; ++k) {
+    x[k] = -logKernel(1.0 - w[k] * p) * scale;
+  }
+}
+
+/* Samples with values in [0, bound), rounded by round(). ceil() wants u in
+ * (0, 1] so that it never yields 0, which Flip provides as 1 - u. */
+template <bool Flip, class Round>
+void sampleTruncated(const double *u, unsigned int *out, std::size_t n,
+                     double lambda, double bound, double maxval,
+                     Round round) {
+  const double p = -std::expm1(-lambda * bound);
+  const double scale = 1.0 / lambda;
+  double w[BLOCK];
+  double x[BLOCK];
+  for (std::size_t i = 0; i < n; i += BLOCK) {
+    const std::size_t len = std::min(BLOCK, n - i);
+    for (std::size_t k = 0; k < BLOCK; ++k) {
+      const double v = k < len ? u[i + k] : 0.0;
+      w[k] = Flip ? 1.0 - v : v;
+    }
+    inverseCdfBlock(w, x, p, scale);
+    for (std::size_t k = 0; k < len; ++k) {
+      // Rounding errors can land a hair outside the range
+      out[i + k] = std::min(round(x[k]), maxval);
+    }
+  }
+}
+
+} // namespace
+
+double ExpSampler::log(double x) { return logKernel(x); }
+
+void ExpSampler::ceilTruncated(const double *u, unsigned int *out,
+                               std::size_t n, double lambda, double maxval) {
+  // ceil(X) <= maxval <=> X <= maxval
+  sampleTruncated<true>(u, out, n, lambda, maxval, maxval,
+                        [](double x) { return std::max(std::ceil(x), 1.0); });
+}
+
+void ExpSampler::floorTruncated(const double *u, unsigned int *out,
+                                std::size_t n, double lambda, double maxval) {
+  // floor(X) <= maxval <=> X < maxval + 1
+  sampleTruncated<false>(u, out, n, lambda, maxval + 1, maxval,
+                         [](double x) { return std::floor(x); });
+}
@@ -0,0 +1,44 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - ExpSampler.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Batched, rejection-free sampling of the truncated exponential values
+ * SeqGenerator draws. SeqGenerator::floorNextExp() and ceilNextExp() redraw
+ * -log(u) / lambda until the rounded value is at most maxval, which throws
+ * most draws away when maxval is small next to 1 / lambda. Here every uniform
+ * u is mapped straight through the inverse CDF of the exponential
+ * distribution truncated to the accepted range, so each value takes exactly
+ * one uniform and the results are distributed exactly like the rejection
+ * sampler's (though they are not the same numbers).
+ *
+ *    The logarithm is a branch-free polynomial applied to fixed-size blocks,
+ * which the compiler turns into SIMD code at -O2; rounding and conversion to
+ * unsigned int are done afterwards one value at a time.
+ */
+
+#ifndef EXPSAMPLER_HPP
+#define EXPSAMPLER_HPP
+
+#include <cstddef>
+
+namespace ExpSampler {
+
+// out[i] = ceil(X) with X ~ Exp(lambda) given ceil(X) <= maxval, for u[i]
+// uniform in [0, 1). Like ceilNextExp(), never 0.
+void ceilTruncated(const double *u, unsigned int *out, std::size_t n,
+                   double lambda, double maxval);
+// out[i] = floor(X) with X ~ Exp(lambda) given floor(X) <= maxval.
+void floorTruncated(const double *u, unsigned int *out, std::size_t n,
+                    double lambda, double maxval);
+// Natural logarithm of a positive normal x, to within a few ulp
+double log(double x);
+
+} // namespace ExpSampler
+
+#endif
@@ -0,0 +1,82 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - Histogram.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ */
+
+#include "Histogram.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+void Histogram::merge(const Histogram &other) {
+  for (unsigned int i = 0; i < NUM_BUCKETS; ++i) {
+    counts[i] += other.counts[i];
+  }
+  numValues += other.numValues;
+  total += other.total;
+  maxValue = std::max(maxValue, other.maxValue);
+}
+
+void Histogram::clear() { *this = Histogram(); }
+
+void Histogram::saveState(SnapshotWriter &out) const {
+  std::vector<std::uint32_t> buckets;
+  std::vector<unsigned long long> bucketCounts;
+  for (unsigned int i = 0; i < NUM_BUCKETS; ++i) {
+    if (counts[i]) {
+      buckets.push_back(i);
+      bucketCounts.push_back(counts[i]);
+    }
+  }
+  out.putArray(buckets);
+  out.putArray(bucketCounts);
+  out.put(numValues);
+  out.put(total);
+  out.put(maxValue);
+}
+
+void Histogram::loadState(SnapshotReader &in) {
+  std::vector<std::uint32_t> buckets;
+  std::vector<unsigned long long> bucketCounts;
+  in.getIndices(buckets, NUM_BUCKETS);
+  in.getArray(bucketCounts, buckets.size());
+  counts.fill(0);
+  for (std::size_t i = 0; i < buckets.size(); ++i) {
+    counts[buckets[i]] = bucketCounts[i];
+  }
+  numValues = in.get<unsigned long long>();
+  total = in.get<unsigned long long>();
+  maxValue = in.get<unsigned int>();
+}
+
+unsigned int Histogram::upperBound(unsigned int bucket) {
+  if (bucket < SUB_BUCKETS) {
+    return bucket;
+  }
+  const unsigned int shift = bucket / SUB_BUCKETS - 1;
+  const unsigned long long lower =
+      (unsigned long long)(bucket % SUB_BUCKETS + SUB_BUCKETS) << shift;
+  return lower + (1ull << shift) - 1;
+}
+
+unsigned int Histogram::percentile(double p) const {
+  if (!numValues) {
+    return 0;
+  }
+  // The rank-th smallest value, counting from 1
+  const unsigned long long rank = std::max(
+      1ull, (unsigned long long)std::ceil(p / 100 * (double)numValues));
+  unsigned long long seen = 0;
+  for (unsigned int i = 0; i < NUM_BUCKETS; ++i) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return std::min(upperBound(i), maxValue);
+    }
+  }
+  return maxValue;
+}
@@ -0,0 +1,73 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - Histogram.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Fixed-size histogram of unsigned ms values with logarithmic buckets,
+ * for per-burst wait and turnaround times. Values below SUB_BUCKETS get a
+ * bucket each; above that every power of two is split into SUB_BUCKETS equal
+ * buckets, so a bucket is never wider than 1/SUB_BUCKETS of its values
+ * (about 3%). The count, 64-bit sum and exact maximum are kept on the side.
+ *
+ *    add() is O(1) and the memory doesn't grow with the number of values.
+ * Two histograms merge() by adding their buckets, which gives exactly the
+ * histogram of both value sets. percentile() returns the upper end of the
+ * bucket holding the value of that rank, capped at max().
+ */
+
+#ifndef HISTOGRAM_HPP
+#define HISTOGRAM_HPP
+
+#include "Snapshot.hpp"
+#include <array>
+
+class Histogram {
+public:
+  void add(unsigned int value) {
+    ++counts[bucketOf(value)];
+    ++numValues;
+    total += value;
+    if (value > maxValue) {
+      maxValue = value;
+    }
+  }
+  void merge(const Histogram &other);
+  void clear();
+  // Only the non-empty buckets are saved
+  void saveState(SnapshotWriter &out) const;
+  void loadState(SnapshotReader &in);
+
+  unsigned long long count() const { return numValues; }
+  unsigned long long sum() const { return total; }
+  unsigned int max() const { return maxValue; }
+  // p in (0, 100]; 0 for an empty histogram
+  unsigned int percentile(double p) const;
+
+private:
+  static constexpr unsigned int SUB_BUCKET_BITS = 5;
+  static constexpr unsigned int SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+  // The exact buckets, then SUB_BUCKETS per power of two from SUB_BUCKETS up
+  static constexpr unsigned int NUM_BUCKETS =
+      SUB_BUCKETS * (32 - SUB_BUCKET_BITS + 1);
+
+  static unsigned int bucketOf(unsigned int value) {
+    if (value < SUB_BUCKETS) {
+      return value;
+    }
+    const unsigned int shift = 31 - __builtin_clz(value) - SUB_BUCKET_BITS;
+    return SUB_BUCKETS * (shift + 1) + (value >> shift) - SUB_BUCKETS;
+  }
+  static unsigned int upperBound(unsigned int bucket);
+
+  std::array<unsigned long long, NUM_BUCKETS> counts{};
+  unsigned long long numValues = 0;
+  unsigned long long total = 0;
+  unsigned int maxValue = 0;
+};
+
+#endif
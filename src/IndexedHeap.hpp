@@ -0,0 +1,156 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - IndexedHeap.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Binary heap of Process::Handles that also remembers where every handle
+ * sits in the heap, so that besides O(log n) push() and pop() it supports
+ * O(log n) erase() of an arbitrary process and update() after a process' key
+ * has changed. The comparator follows the std::priority_queue convention:
+ * comp(a, b) == true means a comes out after b, so top() is the element that
+ * compares "smallest" under the reversed order.
+ *
+ *    As long as comp is a strict total order (e.g. it breaks ties on pid),
+ * sorted() lists the elements in exactly the order a sorted container would
+ * hold them, which is what the event log prints.
+ */
+
+#ifndef INDEXEDHEAP_HPP
+#define INDEXEDHEAP_HPP
+
+#include "Invariants.hpp"
+#include "Process.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+template <class Compare> class IndexedHeap {
+public:
+  typedef Process::Handle Handle;
+
+  explicit IndexedHeap(const Compare &comp, unsigned int capacity = 0)
+      : positions(capacity, Process::NONE), comp(comp) {
+    heap.reserve(capacity);
+  }
+
+  bool empty() const { return heap.empty(); }
+  unsigned int size() const { return heap.size(); }
+  bool contains(Handle h) const {
+    return h < positions.size() && positions[h] != Process::NONE;
+  }
+
+  Handle top() const {
+    if (Invariants::checked && heap.empty()) {
+      throw std::runtime_error("Error: IndexedHeap::top() called when empty.");
+    }
+    return heap.front();
+  }
+
+  void push(Handle h) {
+    if (h >= positions.size()) {
+      positions.resize(h + 1, Process::NONE);
+    }
+    if (Invariants::checked && positions[h] != Process::NONE) {
+      throw std::runtime_error(
+          "Error: IndexedHeap::push() called for a handle already queued.");
+    }
+    heap.push_back(h);
+    positions[h] = heap.size() - 1;
+    siftUp(heap.size() - 1);
+  }
+
+  void pop() {
+    if (Invariants::checked && heap.empty()) {
+      throw std::runtime_error("Error: IndexedHeap::pop() called when empty.");
+    }
+    erase(heap.front());
+  }
+
+  void erase(Handle h) {
+    if (Invariants::checked && !contains(h)) {
+      throw std::runtime_error(
+          "Error: IndexedHeap::erase() called for a handle not queued.");
+    }
+    unsigned int i = positions[h];
+    positions[h] = Process::NONE;
+    Handle last = heap.back();
+    heap.pop_back();
+    if (i == heap.size()) {
+      return;
+    }
+    place(i, last);
+    update(last);
+  }
+
+  // Restores the heap order after the key of h changed in either direction.
+  void update(Handle h) {
+    if (Invariants::checked && !contains(h)) {
+      throw std::runtime_error(
+          "Error: IndexedHeap::update() called for a handle not queued.");
+    }
+    unsigned int i = positions[h];
+    if (i > 0 && comp(heap[(i - 1) / 2], h)) {
+      siftUp(i);
+    } else {
+      siftDown(i);
+    }
+  }
+
+  std::vector<Handle> sorted() const {
+    std::vector<Handle> res(heap);
+    std::sort(res.begin(), res.end(), [this](Handle a, Handle b) -> bool {
+      return comp(b, a);
+    });
+    return res;
+  }
+
+private:
+  void place(unsigned int i, Handle h) {
+    heap[i] = h;
+    positions[h] = i;
+  }
+
+  void siftUp(unsigned int i) {
+    Handle h = heap[i];
+    while (i > 0) {
+      unsigned int parent = (i - 1) / 2;
+      if (!comp(heap[parent], h)) {
+        break;
+      }
+      place(i, heap[parent]);
+      i = parent;
+    }
+    place(i, h);
+  }
+
+  void siftDown(unsigned int i) {
+    Handle h = heap[i];
+    const unsigned int n = heap.size();
+    while (true) {
+      unsigned int child = 2 * i + 1;
+      if (child >= n) {
+        break;
+      }
+      if (child + 1 < n && comp(heap[child], heap[child + 1])) {
+        ++child;
+      }
+      if (!comp(h, heap[child])) {
+        break;
+      }
+      place(i, heap[child]);
+      i = child;
+    }
+    place(i, h);
+  }
+
+  std::vector<Handle> heap;
+  std::vector<unsigned int> positions;
+  Compare comp;
+};
+
+#endif
@@ -0,0 +1,322 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - IndexedTree.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Red-black tree of Process::Handles ordered by a comparator, with the
+ * nodes stored in arrays indexed by handle like IndexedHeap's positions, so
+ * push() and erase() are O(log n) without allocating per node. The leftmost
+ * (smallest) handle is cached, so first() is O(1) and pop() only rebalances.
+ * comp(a, b) == true means a comes before b; like a std::set it needs a
+ * strict total order, e.g. one that breaks ties on pid, and the key of a
+ * handle must not change while it is in the tree.
+ *
+ *    sorted() lists the handles in order by walking the tree.
+ */
+
+#ifndef INDEXEDTREE_HPP
+#define INDEXEDTREE_HPP
+
+#include "Invariants.hpp"
+#include "Process.hpp"
+#include <stdexcept>
+#include <vector>
+
+template <class Compare> class IndexedTree {
+public:
+  typedef Process::Handle Handle;
+
+  explicit IndexedTree(const Compare &comp, unsigned int capacity = 0)
+      : nodes(capacity), comp(comp) {}
+
+  bool empty() const { return root == NIL; }
+  unsigned int size() const { return count; }
+  bool contains(Handle h) const {
+    return h < nodes.size() && nodes[h].queued;
+  }
+
+  Handle first() const {
+    if (Invariants::checked && root == NIL) {
+      throw std::runtime_error(
+          "Error: IndexedTree::first() called when empty.");
+    }
+    return leftmost;
+  }
+
+  void push(Handle h) {
+    if (h >= nodes.size()) {
+      nodes.resize(h + 1);
+    }
+    if (Invariants::checked && nodes[h].queued) {
+      throw std::runtime_error(
+          "Error: IndexedTree::push() called for a handle already queued.");
+    }
+    nodes[h] = Node{NIL, NIL, NIL, true, true};
+    ++count;
+    if (root == NIL) {
+      nodes[h].red = false;
+      root = leftmost = h;
+      return;
+    }
+    Handle parent = root;
+    while (true) {
+      Handle &child = comp(h, parent) ? nodes[parent].left
+                                      : nodes[parent].right;
+      if (child == NIL) {
+        child = h;
+        break;
+      }
+      parent = child;
+    }
+    nodes[h].parent = parent;
+    if (comp(h, leftmost)) {
+      leftmost = h;
+    }
+    fixInsert(h);
+  }
+
+  void pop() {
+    if (Invariants::checked && root == NIL) {
+      throw std::runtime_error("Error: IndexedTree::pop() called when empty.");
+    }
+    erase(leftmost);
+  }
+
+  void erase(Handle h) {
+    if (Invariants::checked && !contains(h)) {
+      throw std::runtime_error(
+          "Error: IndexedTree::erase() called for a handle not queued.");
+    }
+    if (h == leftmost) {
+      leftmost = next(h);
+    }
+    // x takes the place of the node that is unlinked, y; xParent is tracked
+    // separately since x may be NIL
+    Handle y = h;
+    bool yWasRed = nodes[y].red;
+    Handle x;
+    Handle xParent;
+    if (nodes[h].left == NIL) {
+      x = nodes[h].right;
+      xParent = nodes[h].parent;
+      transplant(h, x);
+    } else if (nodes[h].right == NIL) {
+      x = nodes[h].left;
+      xParent = nodes[h].parent;
+      transplant(h, x);
+    } else {
+      y = nodes[h].right;
+      while (nodes[y].left != NIL) {
+        y = nodes[y].left;
+      }
+      yWasRed = nodes[y].red;
+      x = nodes[y].right;
+      if (nodes[y].parent == h) {
+        xParent = y;
+      } else {
+        xParent = nodes[y].parent;
+        transplant(y, x);
+        nodes[y].right = nodes[h].right;
+        nodes[nodes[y].right].parent = y;
+      }
+      transplant(h, y);
+      nodes[y].left = nodes[h].left;
+      nodes[nodes[y].left].parent = y;
+      nodes[y].red = nodes[h].red;
+    }
+    if (!yWasRed) {
+      fixErase(x, xParent);
+    }
+    nodes[h].queued = false;
+    --count;
+  }
+
+  std::vector<Handle> sorted() const {
+    std::vector<Handle> res;
+    res.reserve(count);
+    for (Handle h = root == NIL ? NIL : leftmost; h != NIL; h = next(h)) {
+      res.push_back(h);
+    }
+    return res;
+  }
+
+private:
+  static constexpr Handle NIL = Process::NONE;
+
+  struct Node {
+    Handle left;
+    Handle right;
+    Handle parent;
+    bool red;
+    bool queued;
+  };
+
+  bool isRed(Handle h) const { return h != NIL && nodes[h].red; }
+
+  // The handle after h in order, NIL if h is the last
+  Handle next(Handle h) const {
+    if (nodes[h].right != NIL) {
+      h = nodes[h].right;
+      while (nodes[h].left != NIL) {
+        h = nodes[h].left;
+      }
+      return h;
+    }
+    Handle parent = nodes[h].parent;
+    while (parent != NIL && h == nodes[parent].right) {
+      h = parent;
+      parent = nodes[h].parent;
+    }
+    return parent;
+  }
+
+  // Puts v (maybe NIL) where u hangs in the tree
+  void transplant(Handle u, Handle v) {
+    const Handle parent = nodes[u].parent;
+    if (parent == NIL) {
+      root = v;
+    } else if (u == nodes[parent].left) {
+      nodes[parent].left = v;
+    } else {
+      nodes[parent].right = v;
+    }
+    if (v != NIL) {
+      nodes[v].parent = parent;
+    }
+  }
+
+  void rotateLeft(Handle x) {
+    const Handle y = nodes[x].right;
+    nodes[x].right = nodes[y].left;
+    if (nodes[y].left != NIL) {
+      nodes[nodes[y].left].parent = x;
+    }
+    transplant(x, y);
+    nodes[y].left = x;
+    nodes[x].parent = y;
+  }
+
+  void rotateRight(Handle x) {
+    const Handle y = nodes[x].left;
+    nodes[x].left = nodes[y].right;
+    if (nodes[y].right != NIL) {
+      nodes[nodes[y].right].parent = x;
+    }
+    transplant(x, y);
+    nodes[y].right = x;
+    nodes[x].parent = y;
+  }
+
+  void fixInsert(Handle z) {
+    while (isRed(nodes[z].parent)) {
+      Handle parent = nodes[z].parent;
+      const Handle grandparent = nodes[parent].parent;
+      if (parent == nodes[grandparent].left) {
+        const Handle uncle = nodes[grandparent].right;
+        if (isRed(uncle)) {
+          nodes[parent].red = nodes[uncle].red = false;
+          nodes[grandparent].red = true;
+          z = grandparent;
+          continue;
+        }
+        if (z == nodes[parent].right) {
+          z = parent;
+          rotateLeft(z);
+          parent = nodes[z].parent;
+        }
+        nodes[parent].red = false;
+        nodes[grandparent].red = true;
+        rotateRight(grandparent);
+      } else {
+        const Handle uncle = nodes[grandparent].left;
+        if (isRed(uncle)) {
+          nodes[parent].red = nodes[uncle].red = false;
+          nodes[grandparent].red = true;
+          z = grandparent;
+          continue;
+        }
+        if (z == nodes[parent].left) {
+          z = parent;
+          rotateRight(z);
+          parent = nodes[z].parent;
+        }
+        nodes[parent].red = false;
+        nodes[grandparent].red = true;
+        rotateLeft(grandparent);
+      }
+    }
+    nodes[root].red = false;
+  }
+
+  // x, whose subtree is one black node short, may be NIL; its sibling isn't
+  void fixErase(Handle x, Handle xParent) {
+    while (x != root && !isRed(x)) {
+      if (x == nodes[xParent].left) {
+        Handle sibling = nodes[xParent].right;
+        if (isRed(sibling)) {
+          nodes[sibling].red = false;
+          nodes[xParent].red = true;
+          rotateLeft(xParent);
+          sibling = nodes[xParent].right;
+        }
+        if (!isRed(nodes[sibling].left) && !isRed(nodes[sibling].right)) {
+          nodes[sibling].red = true;
+          x = xParent;
+          xParent = nodes[x].parent;
+          continue;
+        }
+        if (!isRed(nodes[sibling].right)) {
+          nodes[nodes[sibling].left].red = false;
+          nodes[sibling].red = true;
+          rotateRight(sibling);
+          sibling = nodes[xParent].right;
+        }
+        nodes[sibling].red = nodes[xParent].red;
+        nodes[xParent].red = false;
+        nodes[nodes[sibling].right].red = false;
+        rotateLeft(xParent);
+      } else {
+        Handle sibling = nodes[xParent].left;
+        if (isRed(sibling)) {
+          nodes[sibling].red = false;
+          nodes[xParent].red = true;
+          rotateRight(xParent);
+          sibling = nodes[xParent].left;
+        }
+        if (!isRed(nodes[sibling].left) && !isRed(nodes[sibling].right)) {
+          nodes[sibling].red = true;
+          x = xParent;
+          xParent = nodes[x].parent;
+          continue;
+        }
+        if (!isRed(nodes[sibling].left)) {
+          nodes[nodes[sibling].right].red = false;
+          nodes[sibling].red = true;
+          rotateLeft(sibling);
+          sibling = nodes[xParent].left;
+        }
+        nodes[sibling].red = nodes[xParent].red;
+        nodes[xParent].red = false;
+        nodes[nodes[sibling].left].red = false;
+        rotateRight(xParent);
+      }
+      x = root;
+    }
+    if (x != NIL) {
+      nodes[x].red = false;
+    }
+  }
+
+  std::vector<Node> nodes;
+  Handle root = NIL;
+  Handle leftmost = NIL;
+  unsigned int count = 0;
+  Compare comp;
+};
+
+#endif
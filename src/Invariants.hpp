@@ -0,0 +1,31 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - Invariants.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Compile-time switch for the consistency checks of the simulation core.
+ * Scheduler, ProcessTable and the ready queues validate process states,
+ * timers and burst indices on every event tick; those checks are guarded by
+ * Invariants::checked and compile out unless the build defines
+ * CHECK_INVARIANTS (make checked, make debug). Checks on input (process
+ * files, workload files, the command line) and on API misuse outside the
+ * event loop are always on.
+ */
+
+#ifndef INVARIANTS_HPP
+#define INVARIANTS_HPP
+
+namespace Invariants {
+#ifdef CHECK_INVARIANTS
+constexpr bool checked = true;
+#else
+constexpr bool checked = false;
+#endif
+} // namespace Invariants
+
+#endif
@@ -0,0 +1,163 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - MultilevelFeedback.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ */
+
+#include "MultilevelFeedback.hpp"
+#include <algorithm>
+
+MlfqPolicy::MlfqPolicy(const ProcessTable &procs, const MlfqConfig &config)
+    : procs(&procs), config(std::make_shared<const MlfqConfig>(config)),
+      entities(std::make_shared<std::vector<Entity>>(procs.size())),
+      levels(config.timeSlices.size()) {
+  if (config.timeSlices.empty() ||
+      config.timeSlices.size() > MlfqConfig::MAX_LEVELS) {
+    throw std::runtime_error("Error: MLFQ needs 1 to " +
+                             std::to_string(MlfqConfig::MAX_LEVELS) +
+                             " levels.");
+  }
+  for (unsigned int slice : config.timeSlices) {
+    if (!slice) {
+      throw std::runtime_error(
+          "Error: MLFQ time slices must be at least 1ms.");
+    }
+  }
+}
+
+std::string MlfqPolicy::describe() const {
+  std::string res = "MLFQ with " + std::to_string(levels.size()) +
+                    " levels (time slices ";
+  for (std::size_t l = 0; l < levels.size(); ++l) {
+    res += (l ? "/" : "") + std::to_string(config->timeSlices[l]);
+  }
+  res += "ms)";
+  if (config->boostInterval) {
+    res += " and a priority boost every " +
+           std::to_string(config->boostInterval) + "ms";
+  }
+  return res;
+}
+
+void MlfqPolicy::popFront() {
+  const unsigned int level = __builtin_ctzll(nonEmptyLevels);
+  const Handle h = levels[level].front();
+  levels[level].pop();
+  if (levels[level].empty()) {
+    nonEmptyLevels &= ~(std::uint64_t(1) << level);
+  }
+  (*entities)[h].remainingAtPick = procs->getRemainingBurstTime(h);
+}
+
+void MlfqPolicy::push(Handle h, ReadyReason reason) {
+  if (h >= entities->size()) {
+    entities->resize(h + 1);
+  }
+  Entity &e = (*entities)[h];
+  switch (reason) {
+  case ReadyReason::ARRIVED:
+    setLevel(h, 0);
+    break;
+  case ReadyReason::IO_COMPLETED: {
+    // The last run went on to the end of the burst
+    demote(h, e.remainingAtPick);
+    const unsigned int level = getLevel(h);
+    setLevel(h, level ? level - 1 : 0);
+    break;
+  }
+  case ReadyReason::PREEMPTED:
+    demote(h, e.remainingAtPick - procs->getRemainingBurstTime(h));
+    break;
+  case ReadyReason::MIGRATED:
+    break;
+  }
+  const unsigned int level = getLevel(h);
+  levels[level].push(h);
+  nonEmptyLevels |= std::uint64_t(1) << level;
+}
+
+/* Drops h a level for every full time slice in ranFor ms; with nothing else
+ * to run, a process keeps running through several slices. */
+void MlfqPolicy::demote(Handle h, unsigned int ranFor) {
+  unsigned int level = getLevel(h);
+  while (level + 1 < levels.size() &&
+         ranFor >= config->timeSlices[level]) {
+    ranFor -= config->timeSlices[level];
+    ++level;
+  }
+  setLevel(h, level);
+}
+
+/* Moves every queued process to level 0 behind the ones already there.
+ * Processes that aren't queued are at level 0 from now on since their levels
+ * were set in an earlier period. */
+void MlfqPolicy::boost(unsigned int period) {
+  boostPeriod = period;
+  std::uint64_t lower = nonEmptyLevels & ~std::uint64_t(1);
+  while (lower) {
+    const unsigned int level = __builtin_ctzll(lower);
+    levels[0].append(levels[level]);
+    lower &= lower - 1;
+  }
+  nonEmptyLevels = nonEmptyLevels ? 1 : 0;
+}
+
+void MlfqPolicy::saveState(SnapshotWriter &out) const {
+  std::vector<unsigned int> entityLevels;
+  std::vector<unsigned int> boostPeriods;
+  std::vector<unsigned int> remainingAtPicks;
+  for (const Entity &e : *entities) {
+    entityLevels.push_back(e.level);
+    boostPeriods.push_back(e.boostPeriod);
+    remainingAtPicks.push_back(e.remainingAtPick);
+  }
+  out.put<std::uint32_t>(levels.size());
+  out.putArray(entityLevels);
+  out.putArray(boostPeriods);
+  out.putArray(remainingAtPicks);
+  for (const HandleRing &level : levels) {
+    std::vector<Handle> handles;
+    level.forEach([&handles](Handle h) { handles.push_back(h); });
+    out.putArray(handles);
+  }
+  out.put(boostPeriod);
+}
+
+/* The levels must be the ones the snapshot was saved with, since the
+ * processes' levels refer to them. */
+void MlfqPolicy::loadState(SnapshotReader &in, unsigned int numHandles) {
+  std::vector<unsigned int> entityLevels;
+  std::vector<unsigned int> boostPeriods;
+  std::vector<unsigned int> remainingAtPicks;
+  if (in.get<std::uint32_t>() != levels.size()) {
+    in.fail("was saved with a different number of MLFQ levels");
+  }
+  in.getIndices(entityLevels, levels.size());
+  in.getArray(boostPeriods, entityLevels.size());
+  in.getArray(remainingAtPicks, entityLevels.size());
+  entities->resize(entityLevels.size());
+  for (std::size_t h = 0; h < entityLevels.size(); ++h) {
+    Entity &e = (*entities)[h];
+    e.level = entityLevels[h];
+    e.boostPeriod = boostPeriods[h];
+    e.remainingAtPick = remainingAtPicks[h];
+  }
+  for (std::size_t l = 0; l < levels.size(); ++l) {
+    std::vector<Handle> handles;
+    in.getIndices(handles,
+                  std::min<std::size_t>(numHandles, entities->size()));
+    for (Handle h : handles) {
+      levels[l].push(h);
+    }
+    if (!handles.empty()) {
+      nonEmptyLevels |= std::uint64_t(1) << l;
+    }
+  }
+  boostPeriod = in.get<unsigned int>();
+}
+
+template class Scheduler<MlfqPolicy>;
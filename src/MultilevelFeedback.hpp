@@ -0,0 +1,200 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - MultilevelFeedback.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Scheduler policy for Multilevel Feedback Queue (MLFQ) scheduling, see
+ * Policy.hpp. Processes start at level 0, the highest priority, and the
+ * process at the front of the highest non-empty level runs next, for that
+ * level's time slice:
+ *
+ *    A process that uses up a full time slice drops a level, down to the
+ * last; one that gets preempted before that stays at its level.
+ *
+ *    A process coming back from I/O rises a level.
+ *
+ *    A process becoming ready at a higher level than the running process
+ * preempts it.
+ *
+ *    Every boostInterval ms every process goes back to level 0, so CPU-bound
+ * processes can't starve. Boosts are applied lazily at the first event tick
+ * after the boost time (see Policy::clocked) by tagging levels with the boost
+ * period they were set in, so a boost only has to move the queued processes.
+ *
+ *    Each level is a FIFO HandleRing and a bitmap has bit l set while level l
+ * isn't empty, so picking the next process is a count-trailing-zeros and
+ * every queue operation is O(1) however many processes are waiting, in the
+ * spirit of Linux's old O(1) scheduler. The per process state is shared
+ * between copies of a policy, so with SmpScheduler a process keeps its level
+ * when it moves between CPUs.
+ *
+ *    Mlfq is the Scheduler instantiation used by main(); it is compiled once
+ * in MultilevelFeedback.cpp.
+ */
+
+#ifndef MULTILEVELFEEDBACK_HPP
+#define MULTILEVELFEEDBACK_HPP
+
+#include "Invariants.hpp"
+#include "Policy.hpp"
+#include "ProcessTable.hpp"
+#include "Scheduler.hpp"
+#include "Snapshot.hpp"
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct MlfqConfig {
+  static constexpr unsigned int MAX_LEVELS = 64;
+
+  // Time slice of each level in ms, highest priority first
+  std::vector<unsigned int> timeSlices = {16, 32, 64, 128};
+  // ms between priority boosts, 0 for none
+  unsigned int boostInterval = 1000;
+};
+
+/* FIFO of handles in a circular buffer that doubles when it fills up. */
+class HandleRing {
+public:
+  typedef ProcessTable::Handle Handle;
+
+  bool empty() const { return !count; }
+  unsigned int size() const { return count; }
+  Handle front() const {
+    if (Invariants::checked && !count) {
+      throw std::runtime_error(
+          "Error: Attempted to peek first from an empty HandleRing.");
+    }
+    return slots[head];
+  }
+  void pop() {
+    head = (head + 1) & (slots.size() - 1);
+    --count;
+  }
+  void push(Handle h) {
+    if (count == slots.size()) {
+      grow(count + 1);
+    }
+    slots[(head + count) & (slots.size() - 1)] = h;
+    ++count;
+  }
+  // Moves every handle of other to the back of this ring, in order
+  void append(HandleRing &other) {
+    if (count + other.count > slots.size()) {
+      grow(count + other.count);
+    }
+    other.forEach([this](Handle h) {
+      slots[(head + count) & (slots.size() - 1)] = h;
+      ++count;
+    });
+    other.head = other.count = 0;
+  }
+  template <class F> void forEach(F f) const {
+    for (unsigned int i = 0; i < count; ++i) {
+      f(slots[(head + i) & (slots.size() - 1)]);
+    }
+  }
+
+private:
+  // Reallocates to the smallest power of two >= minSize, unrolled at head 0
+  void grow(unsigned int minSize) {
+    std::size_t size = slots.empty() ? 16 : slots.size();
+    while (size < minSize) {
+      size *= 2;
+    }
+    std::vector<Handle> bigger(size);
+    for (unsigned int i = 0; i < count; ++i) {
+      bigger[i] = slots[(head + i) & (slots.size() - 1)];
+    }
+    slots.swap(bigger);
+    head = 0;
+  }
+
+  std::vector<Handle> slots;
+  unsigned int head = 0;
+  unsigned int count = 0;
+};
+
+class MlfqPolicy {
+public:
+  typedef ProcessTable::Handle Handle;
+
+  static constexpr bool timeSliced = true;
+  static constexpr bool preemptive = true;
+  static constexpr bool checksQueueFront = true;
+  static constexpr bool clocked = true;
+  static constexpr bool showTau = false;
+  static constexpr bool alwaysShowRemaining = false;
+  static constexpr bool exclusiveCutoff = false;
+
+  MlfqPolicy(const ProcessTable &procs, const MlfqConfig &config);
+
+  static const char *name() { return "MLFQ"; }
+  std::string describe() const;
+  unsigned int timeSlice(Handle h) const {
+    return config->timeSlices[getLevel(h)];
+  }
+  bool shouldPreempt(Handle running, Handle candidate) const {
+    return getLevel(candidate) < getLevel(running);
+  }
+  void advanceClock(unsigned int t) {
+    if (config->boostInterval && t / config->boostInterval != boostPeriod) {
+      boost(t / config->boostInterval);
+    }
+  }
+
+  bool empty() const { return !nonEmptyLevels; }
+  Handle front() const {
+    return levels[__builtin_ctzll(nonEmptyLevels)].front();
+  }
+  void popFront();
+  void push(Handle h, ReadyReason reason);
+  template <class F> void forEachQueued(F f) const {
+    for (const HandleRing &level : levels) {
+      level.forEach(f);
+    }
+  }
+  void saveState(SnapshotWriter &out) const;
+  void loadState(SnapshotReader &in, unsigned int numHandles);
+
+private:
+  struct Entity {
+    unsigned int level = 0;
+    // Boost period the level was set in; it's 0 in any later one
+    unsigned int boostPeriod = 0;
+    // Remaining burst time when last taken off a queue, i.e. dispatched
+    unsigned int remainingAtPick = 0;
+  };
+
+  unsigned int getLevel(Handle h) const {
+    const Entity &e = (*entities)[h];
+    return e.boostPeriod == boostPeriod ? e.level : 0;
+  }
+  void setLevel(Handle h, unsigned int level) {
+    Entity &e = (*entities)[h];
+    e.level = level;
+    e.boostPeriod = boostPeriod;
+  }
+  void demote(Handle h, unsigned int ranFor);
+  void boost(unsigned int period);
+
+  const ProcessTable *procs;
+  std::shared_ptr<const MlfqConfig> config;
+  std::shared_ptr<std::vector<Entity>> entities;
+  std::vector<HandleRing> levels;
+  std::uint64_t nonEmptyLevels = 0;
+  unsigned int boostPeriod = 0;
+};
+
+typedef Scheduler<MlfqPolicy> Mlfq;
+
+extern template class Scheduler<MlfqPolicy>;
+
+#endif
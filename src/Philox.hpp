@@ -0,0 +1,83 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - Philox.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Philox4x32-10 counter-based generator (Salmon et al., "Parallel Random
+ * Numbers: As Easy as 1, 2, 3"). block() is a pure function from a 128-bit
+ * counter and a 64-bit key to 128 random bits, so any draw can be computed
+ * directly from its coordinates instead of by replaying everything drawn
+ * before it, and draws can be made on any number of threads at once.
+ *
+ *    A Stream is the sequence of uniform doubles for one fixed (c0, c1, c2)
+ * counter prefix; its k-th next() uses counter word c3 = k. It has the same
+ * next() as Rand48, so code sampling from either can be shared.
+ */
+
+#ifndef PHILOX_HPP
+#define PHILOX_HPP
+
+#include <array>
+#include <cstdint>
+
+class Philox {
+public:
+  typedef std::array<std::uint32_t, 4> Counter;
+  typedef std::array<std::uint32_t, 2> Key;
+
+  static Key keyFor(long int seedval) {
+    const std::uint64_t seed = static_cast<std::uint64_t>(seedval);
+    return {static_cast<std::uint32_t>(seed),
+            static_cast<std::uint32_t>(seed >> 32)};
+  }
+
+  static Counter block(Counter ctr, Key key) {
+    for (int round = 0; round < ROUNDS; ++round) {
+      if (round) {
+        key[0] += WEYL_0;
+        key[1] += WEYL_1;
+      }
+      const std::uint64_t p0 = (std::uint64_t)MULTIPLIER_0 * ctr[0];
+      const std::uint64_t p1 = (std::uint64_t)MULTIPLIER_1 * ctr[2];
+      ctr = {static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0],
+             static_cast<std::uint32_t>(p1),
+             static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1],
+             static_cast<std::uint32_t>(p0)};
+    }
+    return ctr;
+  }
+
+  class Stream {
+  public:
+    Stream(const Key &key, std::uint32_t c0, std::uint32_t c1,
+           std::uint32_t c2)
+        : key(key), ctr{c0, c1, c2, 0} {}
+
+    // Uniform in [0, 1) with 53 random bits
+    double next() {
+      const Counter bits = block(ctr, key);
+      ++ctr[3];
+      const std::uint64_t v =
+          ((std::uint64_t)bits[0] << 21) ^ ((std::uint64_t)bits[1] >> 11);
+      return (double)v / (double)(1ULL << 53);
+    }
+
+  private:
+    Key key;
+    Counter ctr;
+  };
+
+private:
+  static constexpr int ROUNDS = 10;
+  static constexpr std::uint32_t MULTIPLIER_0 = 0xd2511f53;
+  static constexpr std::uint32_t MULTIPLIER_1 = 0xcd9e8d57;
+  static constexpr std::uint32_t WEYL_0 = 0x9e3779b9;
+  static constexpr std::uint32_t WEYL_1 = 0xbb67ae85;
+};
+
+#endif
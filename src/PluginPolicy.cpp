@@ -0,0 +1,215 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - PluginPolicy.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ */
+
+#include "PluginPolicy.hpp"
+#include <dlfcn.h>
+#include <stdexcept>
+#include <utility>
+
+std::shared_ptr<const SchedulerPlugin>
+SchedulerPlugin::load(const std::string &path, const std::string &args) {
+  std::shared_ptr<SchedulerPlugin> plugin(new SchedulerPlugin());
+  plugin->path = path;
+  plugin->args = args;
+  // A bare file name would be looked up in the library search path
+  const std::string file =
+      path.find('/') == std::string::npos ? "./" + path : path;
+  plugin->library = dlopen(file.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (!plugin->library) {
+    throw std::runtime_error("Error: could not load plugin " + path + ": " +
+                             dlerror() + ".");
+  }
+  const sched_plugin_get_fn get = reinterpret_cast<sched_plugin_get_fn>(
+      dlsym(plugin->library, SCHED_PLUGIN_ENTRY));
+  if (!get) {
+    throw std::runtime_error("Error: plugin " + path + " doesn't export " +
+                             SCHED_PLUGIN_ENTRY + ".");
+  }
+  const sched_plugin *table = get();
+  if (!table || table->abi_version != SCHED_PLUGIN_ABI_VERSION) {
+    throw std::runtime_error(
+        "Error: plugin " + path + " was built for ABI version " +
+        (table ? std::to_string(table->abi_version) : "?") + ", not " +
+        std::to_string(SCHED_PLUGIN_ABI_VERSION) + ".");
+  }
+  if (!table->name || !*table->name || !table->create || !table->destroy ||
+      !table->enqueue || !table->pick_next || !table->list_queue ||
+      ((table->flags & SCHED_PLUGIN_TIME_SLICED) && !table->time_slice) ||
+      ((table->flags & SCHED_PLUGIN_PREEMPTIVE) && !table->should_preempt)) {
+    throw std::runtime_error("Error: plugin " + path +
+                             " is missing a name or a callback.");
+  }
+  plugin->table = table;
+  return plugin;
+}
+
+SchedulerPlugin::~SchedulerPlugin() {
+  if (library) {
+    dlclose(library);
+  }
+}
+
+template <bool TimeSliced, bool Preemptive>
+PluginPolicy<TimeSliced, Preemptive>::PluginPolicy(
+    const ProcessTable &procs, std::shared_ptr<const SchedulerPlugin> plugin)
+    : procs(&procs), plugin(std::move(plugin)),
+      instance(this->plugin->ops().create(this->plugin->getArgs().c_str())),
+      slots(procs.size()) {
+  if (!instance) {
+    fail("could not be created with arguments \"" +
+         this->plugin->getArgs() + "\"");
+  }
+}
+
+template <bool TimeSliced, bool Preemptive>
+PluginPolicy<TimeSliced, Preemptive>::PluginPolicy(const PluginPolicy &other)
+    : PluginPolicy(*other.procs, other.plugin) {
+  if (other.numQueued) {
+    throw std::runtime_error(
+        "Error: a PluginPolicy can only be copied while its queue is empty.");
+  }
+}
+
+template <bool TimeSliced, bool Preemptive>
+PluginPolicy<TimeSliced, Preemptive>::~PluginPolicy() {
+  plugin->ops().destroy(instance);
+}
+
+template <bool TimeSliced, bool Preemptive>
+void PluginPolicy<TimeSliced, Preemptive>::fail(const std::string &what) const {
+  throw std::runtime_error("Error: plugin " + plugin->getPath() + " " + what +
+                           ".");
+}
+
+template <bool TimeSliced, bool Preemptive>
+std::string PluginPolicy<TimeSliced, Preemptive>::describe() const {
+  std::string res = std::string(name()) + " (" + plugin->getPath();
+  if (!plugin->getArgs().empty()) {
+    res += ":" + plugin->getArgs();
+  }
+  return res + ")";
+}
+
+template <bool TimeSliced, bool Preemptive>
+sched_task
+PluginPolicy<TimeSliced, Preemptive>::makeTask(Handle h,
+                                               sched_reason reason) const {
+  return sched_task{h,
+                    procs->getPid(h),
+                    reason,
+                    procs->getTau(h),
+                    procs->getElapsedBurstTime(h),
+                    procs->getBurstsRemaining(h)};
+}
+
+template <bool TimeSliced, bool Preemptive>
+void PluginPolicy<TimeSliced, Preemptive>::flush() const {
+  const sched_plugin &ops = plugin->ops();
+  if (!pendingBursts.empty()) {
+    if (ops.on_burst_complete) {
+      ops.on_burst_complete(instance, pendingBursts.data(),
+                            pendingBursts.size());
+    }
+    pendingBursts.clear();
+  }
+  if (!pendingTasks.empty()) {
+    ops.enqueue(instance, pendingTasks.data(), pendingTasks.size());
+    pendingTasks.clear();
+  }
+}
+
+template <bool TimeSliced, bool Preemptive>
+unsigned int PluginPolicy<TimeSliced, Preemptive>::timeSlice(Handle h) const {
+  flush();
+  const sched_task task = makeTask(h, SCHED_RUNNING);
+  const uint32_t slice = plugin->ops().time_slice(instance, &task);
+  if (!slice) {
+    fail("gave a time slice of 0ms");
+  }
+  return slice;
+}
+
+template <bool TimeSliced, bool Preemptive>
+bool PluginPolicy<TimeSliced, Preemptive>::shouldPreempt(
+    Handle running, Handle candidate) const {
+  flush();
+  const sched_task curr = makeTask(running, SCHED_RUNNING);
+  const sched_task task = makeTask(
+      candidate, candidate < slots.size() && slots[candidate].queued
+                     ? slots[candidate].reason
+                     : SCHED_RUNNING);
+  return plugin->ops().should_preempt(instance, &curr, &task);
+}
+
+template <bool TimeSliced, bool Preemptive>
+typename PluginPolicy<TimeSliced, Preemptive>::Handle
+PluginPolicy<TimeSliced, Preemptive>::front() const {
+  if (picked == Process::NONE) {
+    flush();
+    picked = plugin->ops().pick_next(instance);
+    if (picked >= slots.size() || !slots[picked].queued) {
+      const Handle h = picked;
+      picked = Process::NONE;
+      fail("picked " + std::to_string(h) + ", which isn't queued");
+    }
+  }
+  return picked;
+}
+
+template <bool TimeSliced, bool Preemptive>
+void PluginPolicy<TimeSliced, Preemptive>::popFront() {
+  const Handle h = front();
+  Slot &slot = slots[h];
+  slot.queued = false;
+  slot.burstAtPick = procs->getCurrOriginalCpuBurstTime(h);
+  picked = Process::NONE;
+  --numQueued;
+}
+
+template <bool TimeSliced, bool Preemptive>
+void PluginPolicy<TimeSliced, Preemptive>::push(Handle h,
+                                                ReadyReason reason) {
+  if (picked != Process::NONE) {
+    throw std::runtime_error(
+        "Error: PluginPolicy::push() called between front() and popFront().");
+  }
+  if (h >= slots.size()) {
+    slots.resize(h + 1);
+  }
+  Slot &slot = slots[h];
+  switch (reason) {
+  case ReadyReason::ARRIVED:
+    slot.reason = SCHED_ARRIVED;
+    break;
+  case ReadyReason::IO_COMPLETED:
+    slot.reason = SCHED_IO_COMPLETED;
+    pendingBursts.push_back(
+        sched_burst{h, procs->getPid(h), slot.burstAtPick});
+    break;
+  case ReadyReason::PREEMPTED:
+    slot.reason = SCHED_PREEMPTED;
+    break;
+  case ReadyReason::MIGRATED:
+    slot.reason = SCHED_MIGRATED;
+    break;
+  }
+  slot.queued = true;
+  ++numQueued;
+  pendingTasks.push_back(makeTask(h, slot.reason));
+}
+
+template class PluginPolicy<false, false>;
+template class PluginPolicy<false, true>;
+template class PluginPolicy<true, false>;
+template class PluginPolicy<true, true>;
+template class Scheduler<PluginPolicy<false, false>>;
+template class Scheduler<PluginPolicy<false, true>>;
+template class Scheduler<PluginPolicy<true, false>>;
+template class Scheduler<PluginPolicy<true, true>>;
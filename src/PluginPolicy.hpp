@@ -0,0 +1,174 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - PluginPolicy.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Scheduler policy backed by a plugin, a shared object implementing the C
+ * interface in SchedPlugin.h. SchedulerPlugin loads the shared object once;
+ * every PluginPolicy, including every copy, drives an instance of its own.
+ *
+ *    push() only records the process in a batch, and the completed burst of a
+ * process returning from I/O in another one (its length was noted when it was
+ * dispatched). Both are handed to the plugin in one enqueue() and one
+ * on_burst_complete() call right before the next question for it, so a tick
+ * that readies many processes costs two calls through the ABI, not one per
+ * process.
+ *
+ *    Whatever a plugin returns is checked like input, in every build: it may
+ * only pick a queued process, list the queued ones and give time slices of at
+ * least 1ms. The running process' claim may change arbitrarily as it runs, so
+ * only processes becoming ready are checked against it (checksQueueFront is
+ * false); that also means front() is always followed by popFront().
+ *
+ *    The plugin's flags are only known at run time, so withPluginPolicy()
+ * picks one of the four instantiations, compiled once in PluginPolicy.cpp.
+ */
+
+#ifndef PLUGINPOLICY_HPP
+#define PLUGINPOLICY_HPP
+
+#include "Policy.hpp"
+#include "ProcessTable.hpp"
+#include "SchedPlugin.h"
+#include "Scheduler.hpp"
+#include "Snapshot.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+/* A loaded plugin; unloaded when the last reference goes. */
+class SchedulerPlugin {
+public:
+  // args is passed to every create()
+  static std::shared_ptr<const SchedulerPlugin> load(const std::string &path,
+                                                     const std::string &args);
+  ~SchedulerPlugin();
+  SchedulerPlugin(const SchedulerPlugin &) = delete;
+  SchedulerPlugin &operator=(const SchedulerPlugin &) = delete;
+
+  const sched_plugin &ops() const { return *table; }
+  const std::string &getArgs() const { return args; }
+  const std::string &getPath() const { return path; }
+  bool isTimeSliced() const {
+    return table->flags & SCHED_PLUGIN_TIME_SLICED;
+  }
+  bool isPreemptive() const {
+    return table->flags & SCHED_PLUGIN_PREEMPTIVE;
+  }
+
+private:
+  SchedulerPlugin() = default;
+
+  void *library = nullptr;
+  const sched_plugin *table = nullptr;
+  std::string path;
+  std::string args;
+};
+
+template <bool TimeSliced, bool Preemptive> class PluginPolicy {
+public:
+  typedef ProcessTable::Handle Handle;
+
+  static constexpr bool timeSliced = TimeSliced;
+  static constexpr bool preemptive = Preemptive;
+  static constexpr bool checksQueueFront = false;
+  static constexpr bool clocked = false;
+  static constexpr bool showTau = false;
+  static constexpr bool alwaysShowRemaining = false;
+  static constexpr bool exclusiveCutoff = false;
+
+  PluginPolicy(const ProcessTable &procs,
+               std::shared_ptr<const SchedulerPlugin> plugin);
+  // The copy starts out with a fresh instance, so the queue must be empty
+  PluginPolicy(const PluginPolicy &other);
+  PluginPolicy &operator=(const PluginPolicy &) = delete;
+  ~PluginPolicy();
+
+  const char *name() const { return plugin->ops().name; }
+  std::string describe() const;
+  unsigned int timeSlice(Handle h) const;
+  bool shouldPreempt(Handle running, Handle candidate) const;
+
+  bool empty() const { return !numQueued; }
+  Handle front() const;
+  void popFront();
+  void push(Handle h, ReadyReason reason);
+  // A plugin's state is its own, so it can't be saved
+  void saveState(SnapshotWriter &) const { fail("can't be saved"); }
+  void loadState(SnapshotReader &, unsigned int) { fail("can't be restored"); }
+  template <class F> void forEachQueued(F f) const {
+    flush();
+    // A process front() picked is no longer in the plugin's queue
+    const unsigned int expected = numQueued - (picked != Process::NONE);
+    listed.resize(expected);
+    const uint32_t n =
+        plugin->ops().list_queue(instance, listed.data(), expected);
+    if (n != expected) {
+      fail("listed " + std::to_string(n) + " processes instead of " +
+           std::to_string(expected));
+    }
+    if (picked != Process::NONE) {
+      f(picked);
+    }
+    for (Handle h : listed) {
+      if (h >= slots.size() || !slots[h].queued) {
+        fail("listed " + std::to_string(h) + ", which isn't queued");
+      }
+      f(h);
+    }
+  }
+
+private:
+  struct Slot {
+    bool queued = false;
+    sched_reason reason = SCHED_ARRIVED;
+    // Length of the CPU burst the process was dispatched for
+    unsigned int burstAtPick = 0;
+  };
+
+  sched_task makeTask(Handle h, sched_reason reason) const;
+  // Hands the batches to the plugin; everything asking it calls this first
+  void flush() const;
+  [[noreturn]] void fail(const std::string &what) const;
+
+  const ProcessTable *procs;
+  std::shared_ptr<const SchedulerPlugin> plugin;
+  void *instance;
+  std::vector<Slot> slots;
+  unsigned int numQueued = 0;
+  // Taken off the plugin's queue by front(), not yet by popFront()
+  mutable Handle picked = Process::NONE;
+  mutable std::vector<sched_task> pendingTasks;
+  mutable std::vector<sched_burst> pendingBursts;
+  mutable std::vector<Handle> listed;
+};
+
+/* Calls f with a null pointer to the PluginPolicy instantiation matching the
+ * flags of plugin, so a generic lambda can build that policy. */
+template <class F> void withPluginPolicy(const SchedulerPlugin &plugin, F f) {
+  if (plugin.isTimeSliced() && plugin.isPreemptive()) {
+    f(static_cast<PluginPolicy<true, true> *>(nullptr));
+  } else if (plugin.isTimeSliced()) {
+    f(static_cast<PluginPolicy<true, false> *>(nullptr));
+  } else if (plugin.isPreemptive()) {
+    f(static_cast<PluginPolicy<false, true> *>(nullptr));
+  } else {
+    f(static_cast<PluginPolicy<false, false> *>(nullptr));
+  }
+}
+
+extern template class PluginPolicy<false, false>;
+extern template class PluginPolicy<false, true>;
+extern template class PluginPolicy<true, false>;
+extern template class PluginPolicy<true, true>;
+extern template class Scheduler<PluginPolicy<false, false>>;
+extern template class Scheduler<PluginPolicy<false, true>>;
+extern template class Scheduler<PluginPolicy<true, false>>;
+extern template class Scheduler<PluginPolicy<true, true>>;
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - Policy.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Scheduler<Policy> (see Scheduler.hpp) owns the event loop, the I/O queue,
+ * context switches and statistics; everything that differs between scheduling
+ * algorithms lives in a policy type that is passed as the template argument,
+ * so every algorithm gets its own compiled loop with the policy calls inlined
+ * and no runtime mode flags. A policy provides:
+ *
+ *    const char *name() const (may be static): short name used in "Algorithm
+ * X" and "Simulator ended for X".
+ *
+ *    std::string describe() const: what follows "Simulator started for ".
+ *
+ *    static constexpr bool timeSliced: if true, unsigned int timeSlice(h) is
+ * queried every time h starts running, and when the slice runs out h is
+ * preempted if the ready queue isn't empty.
+ *
+ *    static constexpr bool preemptive: if true, bool shouldPreempt(running,
+ * candidate) is asked whenever a process becomes ready while another one is
+ * running.
+ *
+ *    static constexpr bool checksQueueFront: if true (and preemptive), the
+ * front of the ready queue is also checked against the running process on
+ * every event tick. Event ticks are skipped, so shouldPreempt(running, front)
+ * must then only be able to turn true when the ready queue changes; a policy
+ * whose running process loses its claim as it runs sets this to false.
+ *
+ *    static constexpr bool clocked: if true, void advanceClock(t) is called at
+ * the start of every event tick t, before anything else happens in it. Ticks
+ * in between are skipped, so whatever the policy does on its clock must only
+ * matter to its next decision.
+ *
+ *    static constexpr bool showTau: label processes as "Process A (tau Xms)"
+ * and report recalculated tau values.
+ *
+ *    static constexpr bool alwaysShowRemaining: always print "started using
+ * the CPU with Xms burst remaining", even at the start of a burst.
+ *
+ *    static constexpr bool exclusiveCutoff: drop arrival, I/O completion and
+ * CPU start events that happen exactly at MAX_OUTPUT_TS, like the original RR
+ * implementation did, so that limited output stays byte-identical.
+ *
+ *    The ready queue: bool empty(), Handle front(), void popFront(),
+ * void push(Handle, ReadyReason) and forEachQueued(f), which calls f on every
+ * queued handle in the order the queue is displayed.
+ *
+ *    void saveState(SnapshotWriter &) const and void loadState(SnapshotReader
+ * &, unsigned int numHandles): write the ready queue and whatever the policy
+ * keeps per process to a snapshot and read it back (see Snapshot.hpp), into
+ * a policy that hasn't been used yet. Settings given to the constructor, like
+ * RR's time slice, are not part of the state.
+ */
+
+#ifndef POLICY_HPP
+#define POLICY_HPP
+
+/* Why a process is being put on the ready queue. MIGRATED: moved over from
+ * another CPU's ready queue (SmpScheduler only). */
+enum class ReadyReason : char { ARRIVED, IO_COMPLETED, PREEMPTED, MIGRATED };
+
+#endif
@@ -8,9 +8,15 @@
  *    Mitesh Kumar  [ kumarm4 ]
  *
  *  Brief:
- *    Represents the process objects. Only allows the creation of up to 26
- * processes per program execution. Processes internally track their states
- * which are:
+ *    Types shared by everything that deals with processes. The processes
+ * themselves live in a ProcessTable (see ProcessTable.hpp) and are referred to
+ * by 32-bit Handles into that table.
+ *
+ *    Each process is given a numeric pid by the PidAllocator of the workload it
+ * belongs to, so any number of processes (and any number of independent
+ * workloads) can exist per program execution. Pids are printed with fmtPid() as
+ * A-Z, then AA, AB, ... so runs with at most 26 processes print exactly as
+ * before. Processes move through the following states:
  *
  *    UNARRIVED: process not yet arrived.
  *
@@ -34,32 +40,21 @@
  *
  *    SW_TERM: process has finished its last burst and is context switching out
  * of the CPU and into the TERMINATED state.
- *
- *    Process states can be changed by either calling nextState(), which moves
- * the process to the next logical state if it is not originally in the RUNNING
- * or TERMINATED state, or decrementBurst() which decides the next state of the
- * process if it is in the RUNNING state. Processes internally track waiting and
- * turnaround times so that the scheduling code isn't responsible for it.
- *
  */
 
 #ifndef PROCESS_HPP
 #define PROCESS_HPP
 
 #include "globals.hpp"
-#include <cmath>
-#include <exception>
-#include <functional>
-#include <iostream>
-#include <numeric>
-#include <stdexcept>
+#include <cstdint>
+#include <limits>
 #include <string>
-#include <utility>
-#include <vector>
 
-class Process {
+struct Process {
+  typedef unsigned int Pid;
+  typedef std::uint32_t Handle;
+  static constexpr Handle NONE = std::numeric_limits<Handle>::max();
 
-public:
   enum class State : char {
     UNARRIVED,
     READY,
@@ -71,59 +66,20 @@ public:
     SW_WAIT,
     SW_TERM
   };
-  Process(unsigned int arrivalTime,
-          const std::vector<unsigned int> &cpuBurstTimes,
-          const std::vector<unsigned int> &ioBurstTimes, unsigned int tau,
-          double alpha);
-  std::string nextState(unsigned int timestamp, unsigned int tcs);
-  Process::State getState() const { return processState; }
-  Process::State decrementBurst();
-  unsigned int getNumBursts() const { return originalCpuBurstTimes.size(); }
-  void printInfo() const;
-  void preempt();
-  unsigned int getArrivalTime() const { return arrivalTime; }
-  std::pair<unsigned long long, unsigned long long>
-  getTotalCpuBurstTime() const;
-  std::pair<unsigned long long, unsigned long long> getTotalWaitTime() const;
-  std::pair<unsigned long long, unsigned long long>
-  getTotalTurnaroundTime() const;
-  unsigned int getCurrOriginalCpuBurstTime() const;
-  unsigned int getCurrIoBurstTime() const;
-  char getPid() const { return pid; }
-  unsigned long long getNumPreempts() const { return numPreempts; }
-  unsigned long long getNumCtxSwitches() const { return numCtxSwitches; }
-  unsigned int getBurstsRemaining() const {
-    return originalCpuBurstTimes.size() - burstIdx - 1;
-  }
-  unsigned int getRemainingBurstTime() const;
-  unsigned int getTau() const { return tau; }
-  signed long long getExpectedRemainingBurstTime() const;
-  void reset();
-  bool isStartOfBurst() const;
-  unsigned int getElapsedBurstTime() const;
+
+  static std::string fmtPid(Pid pid);
+  // Inverse of fmtPid(); throws if name isn't one of its results.
+  static Pid parsePid(const std::string &name);
+};
+
+/* Hands out consecutive pids (0 -> A, 1 -> B, ...) to the processes of a single
+ * workload. */
+class PidAllocator {
+public:
+  Process::Pid next() { return nextPid++; }
+  Process::Pid size() const { return nextPid; }
 
 private:
-  void startWaitingTimer(unsigned int timestamp);
-  void endWaitingTimer(unsigned int timestamp);
-  void startTurnaroundTimer(unsigned int timestamp);
-  void endTurnaroundTimer(unsigned int timestamp);
-  void recalculateTau();
-  static char gpid;
-  const unsigned int arrivalTime;
-  const char pid;
-  const std::vector<unsigned int> originalCpuBurstTimes;
-  const std::vector<unsigned int> originalIoBurstTimes;
-  std::vector<unsigned int> cpuBurstTimes;
-  std::vector<unsigned int> waitingTimes;
-  std::vector<unsigned int> turnaroundTimes;
-  signed long waitingTimer = -1;
-  signed long turnaroundTimer = -1;
-  unsigned int burstIdx = 0;
-  unsigned int numPreempts = 0;
-  unsigned int numCtxSwitches = 0;
-  const unsigned int tau0;
-  unsigned int tau;
-  const double alpha;
-  State processState;
+  Process::Pid nextPid = 0;
 };
 #endif
@@ -0,0 +1,109 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - ProcessSource.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ */
+
+#include "ProcessSource.hpp"
+#include "SeqGenerator.hpp"
+#include <math.h>
+#include <stdexcept>
+
+bool WorkloadSource::next(ProcessSpec &spec) {
+  if (pos == order.size()) {
+    return false;
+  }
+  const Workload::Handle h = order[pos++];
+  const unsigned long long begin = workload.getBurstOffset(h);
+  const unsigned int numBursts = workload.getNumBursts(h);
+  spec.arrivalTime = workload.getArrivalTime(h);
+  spec.pid = workload.getPid(h);
+  spec.tau0 = workload.getTau0(h);
+  spec.cpuBurstTimes.resize(numBursts);
+  spec.ioBurstTimes.resize(numBursts);
+  for (unsigned int i = 0; i < numBursts; ++i) {
+    spec.cpuBurstTimes[i] = workload.getCpuBurstTime(begin + i);
+    spec.ioBurstTimes[i] = workload.getIoBurstTime(begin + i);
+  }
+  return true;
+}
+
+TraceSource::TraceSource(const std::string &path, double lambda, double alpha)
+    : path(path), fp(fopen(path.c_str(), "r")), alpha(alpha),
+      tau0(ceil(1 / lambda)) {
+  if (fp == NULL) {
+    throw std::runtime_error("Error: could not open " + path + ".");
+  }
+  try {
+    rewind();
+  } catch (...) {
+    fclose(fp);
+    throw;
+  }
+}
+
+TraceSource::~TraceSource() { fclose(fp); }
+
+unsigned int TraceSource::readUnsigned() {
+  unsigned int value;
+  if (fscanf(fp, "%u", &value) != 1) {
+    throw std::runtime_error("Error: " + path +
+                             " is truncated or not a process file.");
+  }
+  return value;
+}
+
+void TraceSource::rewind() {
+  ::rewind(fp);
+  pidAllocator = PidAllocator();
+  lastArrivalTime = 0;
+  numProcs = readUnsigned();
+  numRemaining = numProcs;
+}
+
+bool TraceSource::next(ProcessSpec &spec) {
+  if (numRemaining == 0) {
+    return false;
+  }
+  --numRemaining;
+  spec.arrivalTime = readUnsigned();
+  if (spec.arrivalTime < lastArrivalTime) {
+    throw std::runtime_error("Error: processes in " + path +
+                             " are not in arrival order.");
+  }
+  lastArrivalTime = spec.arrivalTime;
+  spec.pid = pidAllocator.next();
+  spec.tau0 = tau0;
+  const unsigned int numBursts = readUnsigned();
+  if (numBursts == 0) {
+    throw std::runtime_error("Error: nCpuBursts was 0.");
+  }
+  spec.cpuBurstTimes.resize(numBursts);
+  spec.ioBurstTimes.resize(numBursts);
+  for (unsigned int i = 0; i < numBursts; ++i) {
+    spec.cpuBurstTimes[i] = readUnsigned();
+    if (spec.cpuBurstTimes[i] == 0) {
+      throw std::runtime_error("Error: " + path +
+                               " has a 0ms CPU burst for process " +
+                               Process::fmtPid(spec.pid) + ".");
+    }
+  }
+  for (unsigned int i = 0; i + 1 < numBursts; ++i) {
+    spec.ioBurstTimes[i] = readUnsigned();
+  }
+  spec.ioBurstTimes[numBursts - 1] = 0;
+  return true;
+}
+
+bool GeneratorSource::next(ProcessSpec &spec) {
+  if (pos == order.size()) {
+    return false;
+  }
+  SeqGenerator::generateProcess(order[pos++], lambda, maxval, seedval, spec,
+                                sampler);
+  return true;
+}
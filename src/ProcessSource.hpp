@@ -0,0 +1,122 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - ProcessSource.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Sources of processes for streaming ProcessTables (see ProcessTable.hpp).
+ * A source hands out one process at a time, in the order the processes arrive
+ * (arrival time, then pid), so a table only has to hold the processes that
+ * have arrived and not yet terminated.
+ *
+ *    WorkloadSource feeds an existing Workload, e.g. one mapped from a
+ * workload file, and only keeps its arrival order. TraceSource reads a process
+ * file in the format of SeqGenerator::parseProcesses() one process at a time;
+ * its processes must already be listed in arrival order. GeneratorSource
+ * generates the processes of a PHILOX workload (see SeqGenerator.hpp) one at a
+ * time as they are handed out, so only its arrival order is ever held, never
+ * its bursts.
+ */
+
+#ifndef PROCESSSOURCE_HPP
+#define PROCESSSOURCE_HPP
+
+#include "Process.hpp"
+#include "Workload.hpp"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace SeqGenerator {
+enum class Sampler;
+}
+
+struct ProcessSpec {
+  unsigned int arrivalTime = 0;
+  Process::Pid pid = 0;
+  unsigned int tau0 = 0;
+  // One entry per burst; the I/O time of the last burst is 0
+  std::vector<unsigned int> cpuBurstTimes;
+  std::vector<unsigned int> ioBurstTimes;
+};
+
+class ProcessSource {
+public:
+  virtual ~ProcessSource() = default;
+  virtual double getAlpha() const = 0;
+  // Fills spec with the next process, false once there are none left.
+  virtual bool next(ProcessSpec &spec) = 0;
+  // Starts over from the first process.
+  virtual void rewind() = 0;
+};
+
+class WorkloadSource : public ProcessSource {
+public:
+  explicit WorkloadSource(const Workload &workload)
+      : workload(workload), order(workload.byArrival()) {}
+
+  double getAlpha() const override { return workload.getAlpha(); }
+  bool next(ProcessSpec &spec) override;
+  void rewind() override { pos = 0; }
+
+private:
+  const Workload &workload;
+  std::vector<Workload::Handle> order;
+  unsigned int pos = 0;
+};
+
+class TraceSource : public ProcessSource {
+public:
+  TraceSource(const std::string &path, double lambda, double alpha);
+  TraceSource(const TraceSource &) = delete;
+  TraceSource &operator=(const TraceSource &) = delete;
+  ~TraceSource() override;
+
+  double getAlpha() const override { return alpha; }
+  bool next(ProcessSpec &spec) override;
+  void rewind() override;
+  // Number of processes in the file, with pids 0 to size() - 1
+  unsigned int size() const { return numProcs; }
+
+private:
+  unsigned int readUnsigned();
+
+  std::string path;
+  FILE *fp;
+  double alpha;
+  unsigned int tau0;
+  unsigned int numProcs = 0;
+  unsigned int numRemaining = 0;
+  unsigned int lastArrivalTime = 0;
+  PidAllocator pidAllocator;
+};
+
+class GeneratorSource : public ProcessSource {
+public:
+  // order is SeqGenerator::arrivalOrder() for the same settings and must
+  // outlive the source
+  GeneratorSource(const std::vector<unsigned int> &order, double lambda,
+                  double maxval, long int seedval, double alpha,
+                  SeqGenerator::Sampler sampler)
+      : order(order), lambda(lambda), maxval(maxval), seedval(seedval),
+        alpha(alpha), sampler(sampler) {}
+
+  double getAlpha() const override { return alpha; }
+  bool next(ProcessSpec &spec) override;
+  void rewind() override { pos = 0; }
+
+private:
+  const std::vector<unsigned int> &order;
+  double lambda;
+  double maxval;
+  long int seedval;
+  double alpha;
+  SeqGenerator::Sampler sampler;
+  unsigned int pos = 0;
+};
+
+#endif
@@ -0,0 +1,555 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - ProcessTable.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ */
+
+#include "ProcessTable.hpp"
+#include "Invariants.hpp"
+
+ProcessTable::ProcessTable(const Workload &workload)
+    : view(workload.arrays()), alpha(workload.getAlpha()),
+      arrivalOrder(workload.byArrival()),
+      states(workload.size(), Process::State::UNARRIVED),
+      burstIdxs(workload.size(), 0), taus(workload.size(), 0),
+      remainingBurstTimes(workload.size(), 0),
+      waitingTimers(workload.size(), -1), turnaroundTimers(workload.size(), -1),
+      numPreempts(workload.size(), 0), numCtxSwitches(workload.size(), 0),
+      burstWaitTimes(workload.size(), 0), waitTimes(workload.size(), 0),
+      turnaroundTimes(workload.size(), 0) {
+  for (Handle h = 0; h < size(); ++h) {
+    initProcess(h);
+  }
+}
+
+ProcessTable::ProcessTable(ProcessSource &source)
+    : alpha(source.getAlpha()), source(&source) {
+  hasPending = source.next(pending);
+  updateView();
+}
+
+void ProcessTable::initProcess(Handle h) {
+  states[h] = Process::State::UNARRIVED;
+  burstIdxs[h] = 0;
+  taus[h] = view.tau0s[h];
+  loadBurst(h);
+  waitingTimers[h] = -1;
+  turnaroundTimers[h] = -1;
+  numPreempts[h] = 0;
+  numCtxSwitches[h] = 0;
+  burstWaitTimes[h] = 0;
+  waitTimes[h] = 0;
+  turnaroundTimes[h] = 0;
+}
+
+void ProcessTable::loadBurst(Handle h) {
+  // Workload files are mapped unchecked (see WorkloadFile.hpp), and a 0ms
+  // burst would wrap around in decrementBurst()
+  remainingBurstTimes[h] = getCpuBurstTime(burstSlot(h));
+  if (remainingBurstTimes[h] == 0) {
+    throw std::runtime_error("Error: the workload has a 0ms CPU burst for "
+                             "process " +
+                             Process::fmtPid(getPid(h)) + ".");
+  }
+}
+
+void ProcessTable::updateView() {
+  view.numProcs = slotArrivalTimes.size();
+  view.numBurstSlots = slotCpuBurstTimes.size();
+  view.arrivalTimes = slotArrivalTimes.data();
+  view.pids = slotPids.data();
+  view.burstOffsets = slotBurstOffsets.data();
+  view.numBursts = slotNumBursts.data();
+  view.tau0s = slotTau0s.data();
+  view.cpuBurstTimes = slotCpuBurstTimes.data();
+  view.ioBurstTimes = slotIoBurstTimes.data();
+}
+
+bool ProcessTable::hasPendingArrival() const {
+  return source ? hasPending : nextArrivalIdx < arrivalOrder.size();
+}
+
+unsigned int ProcessTable::nextArrivalTime() const {
+  if (Invariants::checked && !hasPendingArrival()) {
+    throw std::runtime_error(
+        "Error: nextArrivalTime() called with no pending arrivals.");
+  }
+  return source ? pending.arrivalTime
+                : getArrivalTime(arrivalOrder[nextArrivalIdx]);
+}
+
+ProcessTable::Handle ProcessTable::admitNext() {
+  if (Invariants::checked && !hasPendingArrival()) {
+    throw std::runtime_error(
+        "Error: admitNext() called with no pending arrivals.");
+  }
+  if (!source) {
+    return arrivalOrder[nextArrivalIdx++];
+  }
+  const unsigned int numBursts = pending.cpuBurstTimes.size();
+  const Handle h = allocateSlot(numBursts);
+  slotArrivalTimes[h] = pending.arrivalTime;
+  slotPids[h] = pending.pid;
+  slotNumBursts[h] = numBursts;
+  slotTau0s[h] = pending.tau0;
+  std::copy(pending.cpuBurstTimes.begin(), pending.cpuBurstTimes.end(),
+            slotCpuBurstTimes.begin() + slotBurstOffsets[h]);
+  std::copy(pending.ioBurstTimes.begin(), pending.ioBurstTimes.end(),
+            slotIoBurstTimes.begin() + slotBurstOffsets[h]);
+  updateView();
+  initProcess(h);
+  hasPending = source->next(pending);
+  return h;
+}
+
+ProcessTable::Handle ProcessTable::allocateSlot(unsigned int numBursts) {
+  Handle h;
+  if (!freeSlots.empty()) {
+    h = freeSlots.back();
+    freeSlots.pop_back();
+  } else {
+    h = slotArrivalTimes.size();
+    if (h == Process::NONE) {
+      throw std::runtime_error("Error: too many processes alive at once.");
+    }
+    slotArrivalTimes.push_back(0);
+    slotPids.push_back(0);
+    slotBurstOffsets.push_back(0);
+    slotNumBursts.push_back(0);
+    slotTau0s.push_back(0);
+    slotCapacities.push_back(0);
+    states.push_back(Process::State::TERMINATED);
+    burstIdxs.push_back(0);
+    taus.push_back(0);
+    remainingBurstTimes.push_back(0);
+    waitingTimers.push_back(-1);
+    turnaroundTimers.push_back(-1);
+    numPreempts.push_back(0);
+    numCtxSwitches.push_back(0);
+    burstWaitTimes.push_back(0);
+    waitTimes.push_back(0);
+    turnaroundTimes.push_back(0);
+  }
+  if (slotCapacities[h] < numBursts) {
+    // Give up the old region and append a big enough one
+    garbageBurstSlots += slotCapacities[h];
+    slotCapacities[h] = 0;
+    if (garbageBurstSlots > slotCpuBurstTimes.size() / 2) {
+      compactArena();
+    }
+    const unsigned long long end = slotCpuBurstTimes.size() + numBursts;
+    slotBurstOffsets[h] = slotCpuBurstTimes.size();
+    slotCapacities[h] = numBursts;
+    slotCpuBurstTimes.resize(end, 0);
+    slotIoBurstTimes.resize(end, 0);
+  }
+  return h;
+}
+
+void ProcessTable::compactArena() {
+  const unsigned long long live = slotCpuBurstTimes.size() - garbageBurstSlots;
+  std::vector<unsigned int> cpu, io;
+  cpu.reserve(live);
+  io.reserve(live);
+  for (Handle h = 0; h < slotCapacities.size(); ++h) {
+    if (!slotCapacities[h]) {
+      continue;
+    }
+    const auto begin = slotBurstOffsets[h];
+    const auto end = begin + slotCapacities[h];
+    slotBurstOffsets[h] = cpu.size();
+    cpu.insert(cpu.end(), slotCpuBurstTimes.begin() + begin,
+               slotCpuBurstTimes.begin() + end);
+    io.insert(io.end(), slotIoBurstTimes.begin() + begin,
+              slotIoBurstTimes.begin() + end);
+  }
+  slotCpuBurstTimes.swap(cpu);
+  slotIoBurstTimes.swap(io);
+  garbageBurstSlots = 0;
+}
+
+void ProcessTable::addTotals(Totals &totals, Handle h) const {
+  totals.cpuBurstTime += getTotalCpuBurstTime(h).first;
+  totals.waitTime += getTotalWaitTime(h).first;
+  totals.turnaroundTime += getTotalTurnaroundTime(h).first;
+  totals.numBursts += getNumBursts(h);
+  totals.numCtxSwitches += numCtxSwitches[h];
+  totals.numPreempts += numPreempts[h];
+}
+
+ProcessTable::Totals ProcessTable::totals() const {
+  Totals totals = released;
+  for (Handle h = 0; h < size(); ++h) {
+    // Terminated streamed processes are already in released
+    if (!source || states[h] != Process::State::TERMINATED) {
+      addTotals(totals, h);
+    }
+  }
+  totals.waitTimeHist.merge(waitTimeHist);
+  totals.turnaroundTimeHist.merge(turnaroundTimeHist);
+  return totals;
+}
+
+void ProcessTable::reset() {
+  if (source) {
+    if (hasPending || freeSlots.size() != size()) {
+      throw std::runtime_error("Error: ProcessTable::reset() called before "
+                               "every process has terminated.");
+    }
+    // Every slot stays allocated (and free) for the next run
+    source->rewind();
+    hasPending = source->next(pending);
+    released = Totals();
+    waitTimeHist.clear();
+    turnaroundTimeHist.clear();
+    return;
+  }
+  for (Handle h = 0; h < size(); ++h) {
+    if (burstIdxs[h] < getNumBursts(h)) {
+      throw std::runtime_error("Error: ProcessTable::reset() called for a "
+                               "process that hasn't fully completed.");
+    }
+    if (remainingBurstTimes[h]) {
+      throw std::runtime_error("Error: found a non-zero cpuBurstTime when "
+                               "ProcessTable::reset() called");
+    }
+  }
+
+  for (Handle h = 0; h < size(); ++h) {
+    initProcess(h);
+  }
+  waitTimeHist.clear();
+  turnaroundTimeHist.clear();
+  nextArrivalIdx = 0;
+}
+
+std::uint64_t ProcessTable::fingerprint() const {
+  if (source) {
+    throw std::runtime_error(
+        "Error: a streaming ProcessTable has no fingerprint.");
+  }
+  std::uint64_t hash = fnv1a(&view.numProcs, sizeof(view.numProcs));
+  hash = fnv1a(&view.numBurstSlots, sizeof(view.numBurstSlots), hash);
+  hash = fnv1a(&alpha, sizeof(alpha), hash);
+  hash = fnv1a(view.arrivalTimes, 4 * size(), hash);
+  hash = fnv1a(view.pids, 4 * size(), hash);
+  hash = fnv1a(view.burstOffsets, 8 * size(), hash);
+  hash = fnv1a(view.numBursts, 4 * size(), hash);
+  hash = fnv1a(view.tau0s, 4 * size(), hash);
+  hash = fnv1a(view.cpuBurstTimes, 4 * view.numBurstSlots, hash);
+  return fnv1a(view.ioBurstTimes, 4 * view.numBurstSlots, hash);
+}
+
+void ProcessTable::saveState(SnapshotWriter &out) const {
+  if (source) {
+    throw std::runtime_error(
+        "Error: a simulation with --stream or --trace can't be saved.");
+  }
+  out.put(fingerprint());
+  out.put(nextArrivalIdx);
+  out.putArray(states);
+  out.putArray(burstIdxs);
+  out.putArray(taus);
+  out.putArray(remainingBurstTimes);
+  out.putArray(waitingTimers);
+  out.putArray(turnaroundTimers);
+  out.putArray(numPreempts);
+  out.putArray(numCtxSwitches);
+  out.putArray(burstWaitTimes);
+  out.putArray(waitTimes);
+  out.putArray(turnaroundTimes);
+  waitTimeHist.saveState(out);
+  turnaroundTimeHist.saveState(out);
+}
+
+void ProcessTable::loadState(SnapshotReader &in) {
+  if (source) {
+    throw std::runtime_error(
+        "Error: a simulation with --stream or --trace can't be restored.");
+  }
+  if (in.get<std::uint64_t>() != fingerprint()) {
+    in.fail("was saved from a different workload");
+  }
+  nextArrivalIdx = in.get<unsigned int>();
+  if (nextArrivalIdx > arrivalOrder.size()) {
+    in.fail("doesn't match the simulation it is restored into");
+  }
+  in.getArray(states, size());
+  in.getArray(burstIdxs, size());
+  in.getArray(taus, size());
+  in.getArray(remainingBurstTimes, size());
+  in.getArray(waitingTimers, size());
+  in.getArray(turnaroundTimers, size());
+  in.getArray(numPreempts, size());
+  in.getArray(numCtxSwitches, size());
+  in.getArray(burstWaitTimes, size());
+  in.getArray(waitTimes, size());
+  in.getArray(turnaroundTimes, size());
+  for (Handle h = 0; h < size(); ++h) {
+    if (states[h] > Process::State::SW_TERM ||
+        burstIdxs[h] > getNumBursts(h)) {
+      in.fail("doesn't match the simulation it is restored into");
+    }
+  }
+  waitTimeHist.loadState(in);
+  turnaroundTimeHist.loadState(in);
+}
+
+std::pair<unsigned long long, unsigned long long>
+ProcessTable::getTotalCpuBurstTime(Handle h) const {
+  const unsigned long long begin = view.burstOffsets[h];
+  unsigned long long total = 0;
+  for (unsigned int i = 0; i < getNumBursts(h); ++i) {
+    total += getCpuBurstTime(begin + i);
+  }
+  return {total, getNumBursts(h)};
+}
+std::pair<unsigned long long, unsigned long long>
+ProcessTable::getTotalWaitTime(Handle h) const {
+  return {waitTimes[h], getNumBursts(h)};
+}
+
+std::pair<unsigned long long, unsigned long long>
+ProcessTable::getTotalTurnaroundTime(Handle h) const {
+  return {turnaroundTimes[h], getNumBursts(h)};
+}
+
+unsigned int ProcessTable::getCurrIoBurstTime(Handle h) const {
+  if (Invariants::checked && burstIdxs[h] >= getNumBursts(h) - 1) {
+    throw std::runtime_error(
+        "Error: tried to get burst io time of last cpu burst.");
+  }
+  return view.ioBurstTimes[burstSlot(h)];
+}
+
+unsigned int ProcessTable::getCurrOriginalCpuBurstTime(Handle h) const {
+  if (Invariants::checked && burstIdxs[h] >= getNumBursts(h)) {
+    throw std::runtime_error(
+        "Error: tried to get burst io time of last cpu burst.");
+  }
+  return getCpuBurstTime(burstSlot(h));
+}
+
+void ProcessTable::recalculateTau(Handle h) {
+  if (Invariants::checked && (states[h] != Process::State::SW_WAIT) &&
+      (states[h] != Process::State::SW_TERM)) {
+    throw std::runtime_error("Error: called recalculateTau() for process that "
+                             "isn't in SW_WAIT or SW_TERM");
+  }
+  if (Invariants::checked && burstIdxs[h] >= getNumBursts(h)) {
+    throw std::runtime_error(
+        "Error: called recalculateTau() with out of bounds burstIdx.");
+  }
+  taus[h] = ceil(getCpuBurstTime(burstSlot(h)) * alpha +
+                 (1 - alpha) * taus[h]);
+}
+
+void ProcessTable::startWaitingTimer(Handle h, unsigned int timestamp) {
+  if (Invariants::checked && waitingTimers[h] != -1) {
+    throw std::runtime_error(
+        "Error: startWaitingTimer() called while timer is already running.");
+  }
+  waitingTimers[h] = timestamp;
+}
+void ProcessTable::endWaitingTimer(Handle h, unsigned int timestamp) {
+  if (Invariants::checked && waitingTimers[h] == -1) {
+    throw std::runtime_error(
+        "Error: endWaitingTimer() called while timer is not running.");
+  }
+  if (Invariants::checked && burstIdxs[h] >= getNumBursts(h)) {
+    throw std::runtime_error(
+        "Error: endWaitingTimer() called with out of bounds burstIdx.");
+  }
+  burstWaitTimes[h] += timestamp - waitingTimers[h];
+  waitingTimers[h] = -1;
+}
+void ProcessTable::startTurnaroundTimer(Handle h, unsigned int timestamp) {
+  if (Invariants::checked && turnaroundTimers[h] != -1) {
+    throw std::runtime_error(
+        "Error: startTurnaroundTimer() called while timer is already running.");
+  }
+  turnaroundTimers[h] = timestamp;
+}
+void ProcessTable::endTurnaroundTimer(Handle h, unsigned int timestamp) {
+  if (Invariants::checked && turnaroundTimers[h] == -1) {
+    throw std::runtime_error(
+        "Error: endTurnaroundTimer() called while timer is not running.");
+  }
+  if (Invariants::checked && burstIdxs[h] >= getNumBursts(h)) {
+    throw std::runtime_error(
+        "Error: endTurnaroundTimer() called with out of bounds burstIdx.");
+  }
+  // The burst is over, so its wait time is final too
+  const unsigned int turnaround = timestamp - turnaroundTimers[h];
+  turnaroundTimers[h] = -1;
+  turnaroundTimes[h] += turnaround;
+  turnaroundTimeHist.add(turnaround);
+  waitTimes[h] += burstWaitTimes[h];
+  waitTimeHist.add(burstWaitTimes[h]);
+  burstWaitTimes[h] = 0;
+}
+
+bool ProcessTable::isStartOfBurst(Handle h) const {
+  if (Invariants::checked && burstIdxs[h] >= getNumBursts(h)) {
+    throw std::runtime_error("Error: isStartOfBurst() called for a process "
+                             "with out of bounds burstIdx.");
+  }
+  return remainingBurstTimes[h] == getCpuBurstTime(burstSlot(h));
+}
+
+unsigned int ProcessTable::getElapsedBurstTime(Handle h) const {
+  if (Invariants::checked && burstIdxs[h] >= getNumBursts(h)) {
+    throw std::runtime_error("Error: getElapsedBurstTime() called for a "
+                             "process with out of bounds burstIdx.");
+  }
+
+  if (Invariants::checked &&
+      getCpuBurstTime(burstSlot(h)) < remainingBurstTimes[h]) {
+    throw std::runtime_error("Error: original cpu burst time was lower than "
+                             "current cpu burst time.");
+  }
+  return getCpuBurstTime(burstSlot(h)) - remainingBurstTimes[h];
+}
+
+signed long long ProcessTable::getExpectedRemainingBurstTime(Handle h) const {
+  if (Invariants::checked && burstIdxs[h] >= getNumBursts(h)) {
+    throw std::runtime_error("Error: getExpectedRemainingBurstTime() called "
+                             "for a process with out of bounds burstIdx.");
+  }
+
+  return static_cast<signed long int>(getTau(h)) -
+         static_cast<signed long int>(getElapsedBurstTime(h));
+}
+void ProcessTable::nextState(Handle h, unsigned int timestamp) {
+  switch (states[h]) {
+  case Process::State::UNARRIVED: // -> READY
+    states[h] = Process::State::READY;
+    startWaitingTimer(h, timestamp);
+    startTurnaroundTimer(h, timestamp);
+    break;
+  case Process::State::READY: // -> SW_IN
+    states[h] = Process::State::SW_IN;
+    endWaitingTimer(h, timestamp);
+    break;
+  case Process::State::SW_READY: // -> READY
+    states[h] = Process::State::READY;
+    startWaitingTimer(h, timestamp);
+    break;
+  case Process::State::SW_IN: // -> RUNNING
+    ++numCtxSwitches[h];
+    states[h] = Process::State::RUNNING;
+    break;
+  case Process::State::SW_WAIT: // -> WAITING
+    states[h] = Process::State::WAITING;
+    endTurnaroundTimer(h, timestamp);
+    break;
+  case Process::State::WAITING: // -> READY
+    ++burstIdxs[h];
+    loadBurst(h);
+    states[h] = Process::State::READY;
+    startWaitingTimer(h, timestamp);
+    startTurnaroundTimer(h, timestamp);
+    break;
+  case Process::State::SW_TERM: // -> TERMINATED
+    states[h] = Process::State::TERMINATED;
+    endTurnaroundTimer(h, timestamp);
+    ++burstIdxs[h];
+    if (source) {
+      addTotals(released, h);
+      freeSlots.push_back(h);
+    }
+    break;
+  case Process::State::RUNNING:
+    throw std::runtime_error("Error: next state of RUNNING process must be set "
+                             "by preempt() or decrementBurst().");
+  case Process::State::TERMINATED:
+    throw std::runtime_error(
+        "Error: called nextState() on TERMINATED process.");
+  default:
+    throw std::runtime_error(
+        "Error: nextState() called for unrecognized process state.");
+  }
+}
+
+Process::State ProcessTable::decrementBurst(Handle h) {
+  if (Invariants::checked && states[h] != Process::State::RUNNING) {
+    throw std::runtime_error(
+        "Error: decrementBurst() called for a non-running process.");
+  }
+  if (Invariants::checked && burstIdxs[h] >= getNumBursts(h)) {
+    std::cout << "Burst Idx: " << burstIdxs[h] << std::endl;
+    throw std::runtime_error(
+        "Error: Tried to decrement with burstIdx out of bounds.");
+  }
+  if (0 == --remainingBurstTimes[h]) {
+    if (burstIdxs[h] + 1 == getNumBursts(h)) {
+      states[h] = Process::State::SW_TERM;
+    } else {
+      states[h] = Process::State::SW_WAIT;
+      recalculateTau(h);
+    }
+  }
+  return states[h];
+}
+
+void ProcessTable::advanceBurst(Handle h, unsigned int elapsed) {
+  if (Invariants::checked && states[h] != Process::State::RUNNING) {
+    throw std::runtime_error(
+        "Error: advanceBurst() called for a non-running process.");
+  }
+  if (Invariants::checked && burstIdxs[h] >= getNumBursts(h)) {
+    throw std::runtime_error(
+        "Error: Tried to advance with burstIdx out of bounds.");
+  }
+  if (Invariants::checked && elapsed >= remainingBurstTimes[h]) {
+    throw std::runtime_error("Error: advanceBurst() would complete the burst; "
+                             "use decrementBurst() for the final ms.");
+  }
+  remainingBurstTimes[h] -= elapsed;
+}
+
+unsigned int ProcessTable::getRemainingBurstTime(Handle h) const {
+  if (Invariants::checked && burstIdxs[h] == getNumBursts(h)) {
+    throw std::runtime_error(
+        "Error: getRemainingBurstTime() called for an out of bounds burstIdx.");
+  }
+  return remainingBurstTimes[h];
+}
+
+void ProcessTable::preempt(Handle h) {
+  if (Invariants::checked && states[h] != Process::State::RUNNING) {
+    throw std::runtime_error(
+        "Error: preempt() called for a non-RUNNING process.");
+  }
+  ++numPreempts[h];
+  states[h] = Process::State::SW_READY;
+}
+
+void ProcessTable::printInfo(Handle h) const {
+  const unsigned long long begin = view.burstOffsets[h];
+  const unsigned long long end = begin + getNumBursts(h);
+  std::cout << "pid: " << getName(h) << std::endl;
+  std::cout << "arrival time: " << getArrivalTime(h) << std::endl;
+  std::cout << "current burst index: " << burstIdxs[h] << std::endl;
+
+  std::cout << "remaining cpu burst time: " << remainingBurstTimes[h]
+            << std::endl;
+
+  std::cout << "original cpu burst times: ";
+  for (auto i = begin; i < end; ++i)
+    std::cout << getCpuBurstTime(i) << ' ';
+  std::cout << std::endl;
+
+  std::cout << "io burst times: ";
+  for (auto i = begin; i + 1 < end; ++i)
+    std::cout << view.ioBurstTimes[i] << ' ';
+  std::cout << std::endl;
+
+  std::cout << "total turnaround time: " << turnaroundTimes[h] << std::endl;
+  std::cout << "total wait time: " << waitTimes[h] << std::endl;
+  std::cout << std::endl;
+}
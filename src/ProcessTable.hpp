@@ -0,0 +1,188 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - ProcessTable.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Struct-of-arrays table holding the state of every process of a Workload
+ * during one simulation run. A process is identified by its Process::Handle,
+ * its index into the Workload's and the table's per-process arrays. Fields
+ * the schedulers touch on every event (state, burst index, tau, remaining
+ * time of the current burst) are kept in their own contiguous arrays. The
+ * Workload itself is never modified, so several tables (one per concurrently
+ * running algorithm) can share one.
+ *
+ *    Process states can be changed by either calling nextState(), which moves
+ * the process to the next logical state if it is not originally in the RUNNING
+ * or TERMINATED state, or decrementBurst() which decides the next state of the
+ * process if it is in the RUNNING state. advanceBurst() lets the event-driven
+ * schedulers consume several ms of a burst at once as long as the burst does
+ * not finish. The table internally tracks waiting and turnaround times so that
+ * the scheduling code isn't responsible for it: each burst's times go into
+ * 64-bit per-process sums and into table-wide Histograms as the burst ends,
+ * so the memory used for them doesn't grow with the number of bursts.
+ *
+ *    saveState() and loadState() save and restore the state of every process
+ * for Scheduler snapshots (see Snapshot.hpp). Only tables over a Workload can
+ * be saved; a streaming table's state includes its source's.
+ */
+
+#ifndef PROCESSTABLE_HPP
+#define PROCESSTABLE_HPP
+
+#include "Histogram.hpp"
+#include "Process.hpp"
+#include "ProcessSource.hpp"
+#include "Snapshot.hpp"
+#include "Workload.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ProcessTable {
+
+public:
+  typedef Process::Handle Handle;
+
+  // Sums over every process, including the ones a streaming table released
+  struct Totals {
+    unsigned long long cpuBurstTime = 0;
+    unsigned long long waitTime = 0;
+    unsigned long long turnaroundTime = 0;
+    unsigned long long numBursts = 0;
+    unsigned long long numCtxSwitches = 0;
+    unsigned long long numPreempts = 0;
+    // One value per burst
+    Histogram waitTimeHist;
+    Histogram turnaroundTimeHist;
+  };
+
+  explicit ProcessTable(const Workload &workload);
+  explicit ProcessTable(ProcessSource &source);
+  bool isStreaming() const { return source != nullptr; }
+  // Number of handles; for a streaming table, the most processes that were
+  // ever alive at once.
+  unsigned int size() const { return view.numProcs; }
+
+  // Arrivals in arrival order, then pid
+  bool hasPendingArrival() const;
+  unsigned int nextArrivalTime() const;
+  Handle admitNext();
+
+  void nextState(Handle h, unsigned int timestamp);
+  Process::State getState(Handle h) const { return states[h]; }
+  Process::State decrementBurst(Handle h);
+  void advanceBurst(Handle h, unsigned int elapsed);
+  unsigned int getNumBursts(Handle h) const { return view.numBursts[h]; }
+  void printInfo(Handle h) const;
+  void preempt(Handle h);
+  unsigned int getArrivalTime(Handle h) const {
+    return view.arrivalTimes[h];
+  }
+  std::pair<unsigned long long, unsigned long long>
+  getTotalCpuBurstTime(Handle h) const;
+  std::pair<unsigned long long, unsigned long long>
+  getTotalWaitTime(Handle h) const;
+  std::pair<unsigned long long, unsigned long long>
+  getTotalTurnaroundTime(Handle h) const;
+  unsigned int getCurrOriginalCpuBurstTime(Handle h) const;
+  unsigned int getCurrIoBurstTime(Handle h) const;
+  Process::Pid getPid(Handle h) const { return view.pids[h]; }
+  std::string getName(Handle h) const { return Process::fmtPid(view.pids[h]); }
+  unsigned long long getNumPreempts(Handle h) const { return numPreempts[h]; }
+  unsigned long long getNumCtxSwitches(Handle h) const {
+    return numCtxSwitches[h];
+  }
+  unsigned int getBurstsRemaining(Handle h) const {
+    return view.numBursts[h] - burstIdxs[h] - 1;
+  }
+  unsigned int getRemainingBurstTime(Handle h) const;
+  unsigned int getTau(Handle h) const { return taus[h]; }
+  signed long long getExpectedRemainingBurstTime(Handle h) const;
+  Totals totals() const;
+  void reset();
+  // Hash of the workload and alpha; a snapshot only restores into a table
+  // with the same fingerprint. Not for streaming tables.
+  std::uint64_t fingerprint() const;
+  void saveState(SnapshotWriter &out) const;
+  void loadState(SnapshotReader &in);
+  bool isStartOfBurst(Handle h) const;
+  unsigned int getElapsedBurstTime(Handle h) const;
+
+private:
+  unsigned long long burstSlot(Handle h) const {
+    return view.burstOffsets[h] + burstIdxs[h];
+  }
+  unsigned int getCpuBurstTime(unsigned long long slot) const {
+    return view.cpuBurstTimes[slot];
+  }
+  void initProcess(Handle h);
+  // Makes the current burst of h the one to run, which must take at least 1ms
+  void loadBurst(Handle h);
+  void addTotals(Totals &totals, Handle h) const;
+  Handle allocateSlot(unsigned int numBursts);
+  void compactArena();
+  void updateView();
+  void startWaitingTimer(Handle h, unsigned int timestamp);
+  void endWaitingTimer(Handle h, unsigned int timestamp);
+  void startTurnaroundTimer(Handle h, unsigned int timestamp);
+  void endTurnaroundTimer(Handle h, unsigned int timestamp);
+  void recalculateTau(Handle h);
+
+  // Where the workload data is read from: the Workload's arrays, or the
+  // streaming copies below.
+  Workload::Arrays view;
+  double alpha;
+
+  // Non-streaming: every handle in arrival order
+  std::vector<Handle> arrivalOrder;
+  unsigned int nextArrivalIdx = 0;
+
+  // Streaming: the next process to arrive and copies of the live ones. Each
+  // slot owns slotCapacities[h] arena slots from slotBurstOffsets[h]; slots
+  // left behind when a slot needs a bigger region are counted in
+  // garbageBurstSlots until compactArena() drops them.
+  ProcessSource *source = nullptr;
+  ProcessSpec pending;
+  bool hasPending = false;
+  std::vector<Handle> freeSlots;
+  std::vector<unsigned int> slotArrivalTimes;
+  std::vector<Process::Pid> slotPids;
+  std::vector<unsigned long long> slotBurstOffsets;
+  std::vector<unsigned int> slotNumBursts;
+  std::vector<unsigned int> slotTau0s;
+  std::vector<unsigned int> slotCapacities;
+  std::vector<unsigned int> slotCpuBurstTimes;
+  std::vector<unsigned int> slotIoBurstTimes;
+  unsigned long long garbageBurstSlots = 0;
+  Totals released;
+
+  // Per-process, hot
+  std::vector<Process::State> states;
+  std::vector<unsigned int> burstIdxs;
+  std::vector<unsigned int> taus;
+  std::vector<unsigned int> remainingBurstTimes;
+  std::vector<signed long> waitingTimers;
+  std::vector<signed long> turnaroundTimers;
+  std::vector<unsigned int> numPreempts;
+  std::vector<unsigned int> numCtxSwitches;
+  // Wait time of the current burst so far, and the sums over finished bursts
+  std::vector<unsigned int> burstWaitTimes;
+  std::vector<unsigned long long> waitTimes;
+  std::vector<unsigned long long> turnaroundTimes;
+
+  Histogram waitTimeHist;
+  Histogram turnaroundTimeHist;
+};
+#endif
@@ -0,0 +1,40 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - Rand48.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    The srand48()/drand48() generator with its 48-bit state held in the
+ * object instead of in libc, so that several workloads can be generated at
+ * once on different threads. Rand48(seed) followed by next() calls yields
+ * exactly the sequence srand48(seed) followed by drand48() calls does.
+ */
+
+#ifndef RAND48_HPP
+#define RAND48_HPP
+
+#include <cstdint>
+
+class Rand48 {
+public:
+  explicit Rand48(long int seedval)
+      : state(((std::uint64_t)(seedval & 0xffffffffL) << 16) | 0x330e) {}
+
+  // Uniform in [0, 1)
+  double next() {
+    state = (MULTIPLIER * state + INCREMENT) & MASK;
+    return (double)state / (double)(MASK + 1);
+  }
+
+private:
+  static constexpr std::uint64_t MULTIPLIER = 0x5deece66dULL;
+  static constexpr std::uint64_t INCREMENT = 0xb;
+  static constexpr std::uint64_t MASK = (1ULL << 48) - 1;
+  std::uint64_t state;
+};
+
+#endif
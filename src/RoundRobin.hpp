@@ -8,104 +8,113 @@
  *    Mitesh Kumar  [ kumarm4 ]
  *
  *  Brief:
- *    Implementation of Round Robin (RR) scheduling algorithm that can be
- * converted to First-Come-First-Served (FCFS) by passing fcfs=true to the
- * constructor.
+ *    Scheduler policies for Round Robin (RR) and First-Come-First-Served (FCFS)
+ * scheduling, see Policy.hpp. Both keep a plain FIFO ready queue; FCFS never
+ * preempts, RR preempts the running process when its time slice expires and
+ * puts processes becoming ready at the END or BEGINNING of the ready queue
+ * depending on rr_add.
  *
- *    run() runs the simulation and outputs important events to terminal in
- * chronological order
- *
- *    printInfo() can be called successfully after run() has
- * completed and will print the final calculated statistics of the run to a
- * output stream.
- *
- *    reset() resets the object for a future run and resets the
- * internal processes to their initial state.
+ *    RoundRobin<AddToEnd> and Fcfs are the Scheduler instantiations used by
+ * main(); they are compiled once in RoundRobin.cpp.
  */
 
 #ifndef ROUNDROBIN_HPP
 #define ROUNDROBIN_HPP
 
-#include "Process.hpp"
-#include <algorithm>
+#include "Invariants.hpp"
+#include "Policy.hpp"
+#include "ProcessTable.hpp"
+#include "Scheduler.hpp"
+#include "Snapshot.hpp"
 #include <deque>
-#include <exception>
-#include <functional>
-#include <iostream>
-#include <queue>
-#include <sstream>
 #include <stdexcept>
 #include <string>
-#include <utility>
 #include <vector>
 
-class RoundRobin {
+class FifoReadyQueue {
 public:
-  RoundRobin(std::vector<Process> &processes, unsigned int tslice,
-             unsigned int tcs, bool addToEnd, bool fcfs);
-  void printInfo(std::ostream &os) const;
-  void run();
-  void reset();
-  void printCsv(std::ostream &os) const;
+  typedef ProcessTable::Handle Handle;
 
-private:
-  typedef std::vector<Process>::iterator ProcessPtr;
-  typedef std::pair<unsigned int, ProcessPtr> ioQueueElem;
+  bool empty() const { return readyQueue.empty(); }
+  Handle front() const {
+    if (Invariants::checked && readyQueue.empty()) {
+      throw std::runtime_error(
+          "Error: Attempted to peek first from an empty ready queue.");
+    }
+    return readyQueue.front();
+  }
+  void popFront() { readyQueue.pop_front(); }
+  template <class F> void forEachQueued(F f) const {
+    for (Handle h : readyQueue) {
+      f(h);
+    }
+  }
+  void saveState(SnapshotWriter &out) const {
+    out.putArray(std::vector<Handle>(readyQueue.begin(), readyQueue.end()));
+  }
+  void loadState(SnapshotReader &in, unsigned int numHandles) {
+    std::vector<Handle> handles;
+    in.getIndices(handles, numHandles);
+    readyQueue.assign(handles.begin(), handles.end());
+  }
 
-  void printEvent(const std::string &detail, bool term) const;
-  bool isReadyQueueEmpty() const { return readyQueue.empty(); }
-  ProcessPtr peekLastReady() const;
-  ProcessPtr peekFirstReady() const;
-  void popFirstReady();
-  void pushLastReady(ProcessPtr processPtr);
-  void pushFirstReady(ProcessPtr processPtr);
-  Process::State decrementBurstTimer();
-  void pushIo(ProcessPtr processPtr);
+protected:
+  std::deque<Handle> readyQueue;
+};
 
-  double calcAvgWaitTime() const;
-  double calcAvgTurnaroundTime() const;
-  double calcAvgCpuBurstTime() const;
-  unsigned long long calcTotalNumCtxSwitches() const;
-  unsigned long long calcTotalNumPreemptions() const;
-  double calcCpuUtilization() const {
-    return 100.0 * (double)cpuUsageTime / timestamp;
-  }
-  void resetTcsRemaining();
-  void resetBurstTimer();
+class FcfsPolicy : public FifoReadyQueue {
+public:
+  static constexpr bool timeSliced = false;
+  static constexpr bool preemptive = false;
+  static constexpr bool checksQueueFront = false;
+  static constexpr bool clocked = false;
+  static constexpr bool showTau = false;
+  static constexpr bool alwaysShowRemaining = false;
+  static constexpr bool exclusiveCutoff = true;
 
-  void decrementTcs();
-  void preemptRunningProc();
-  inline bool burstTimerElapsed() const { return burstRemaining == 0; }
+  static const char *name() { return "FCFS"; }
+  std::string describe() const { return name(); }
+  void push(Handle h, ReadyReason) { readyQueue.push_back(h); }
+};
 
-  // Independent
-  static const std::function<bool(const ProcessPtr &, const ProcessPtr &)>
-      processArrivalComparator;
-  static const std::function<bool(const ioQueueElem &, const ioQueueElem &)>
-      processIoComparator;
-  std::deque<ProcessPtr> readyQueue;
-  unsigned int latestProcessIdx = 0;
-  unsigned int timestamp = 0;
-  unsigned int burstRemaining = 0;
-  unsigned int tcsRemaining = 0;
+template <bool AddToEnd> class RoundRobinPolicy : public FifoReadyQueue {
+public:
+  static constexpr bool timeSliced = true;
+  static constexpr bool preemptive = false;
+  static constexpr bool checksQueueFront = false;
+  static constexpr bool clocked = false;
+  static constexpr bool showTau = false;
+  static constexpr bool alwaysShowRemaining = false;
+  static constexpr bool exclusiveCutoff = true;
 
-  unsigned int cpuUsageTime = 0;
+  explicit RoundRobinPolicy(unsigned int tslice) : tslice(tslice) {}
 
-  // Default
-  std::priority_queue<ioQueueElem, std::vector<ioQueueElem>,
-                      decltype(processIoComparator)>
-      ioQueue;
-  const unsigned int tslice;
-  const unsigned int tcs;
-  const unsigned int numProcs;
-  ProcessPtr runningProc;
-  ProcessPtr switchingOutProc;
-  ProcessPtr switchingInProc;
-  const ProcessPtr nullProc;
-  const bool addToEnd;
-  const bool fcfs;
+  static const char *name() { return "RR"; }
+  std::string describe() const {
+    return "RR with time slice " + std::to_string(tslice) +
+           "ms and rr_add to " + (AddToEnd ? "END" : "BEGINNING");
+  }
+  unsigned int timeSlice(Handle) const { return tslice; }
+  // Takes effect the next time a time slice starts
+  void setTimeSlice(unsigned int tslice) { this->tslice = tslice; }
+  void push(Handle h, ReadyReason) {
+    if (AddToEnd) {
+      readyQueue.push_back(h);
+    } else {
+      readyQueue.push_front(h);
+    }
+  }
 
-  // Non-Default
-  std::vector<ProcessPtr> orderedProcesses;
+private:
+  unsigned int tslice;
 };
 
+typedef Scheduler<FcfsPolicy> Fcfs;
+template <bool AddToEnd>
+using RoundRobin = Scheduler<RoundRobinPolicy<AddToEnd>>;
+
+extern template class Scheduler<FcfsPolicy>;
+extern template class Scheduler<RoundRobinPolicy<true>>;
+extern template class Scheduler<RoundRobinPolicy<false>>;
+
 #endif
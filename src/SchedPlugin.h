@@ -0,0 +1,116 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - SchedPlugin.h
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    C interface for scheduling policies built as shared objects and loaded
+ * with --plugin=path[:args] (see PluginPolicy.hpp for how the simulator drives
+ * them). The plugin exports
+ *
+ *      const struct sched_plugin *sched_plugin_get(void);
+ *
+ * returning a static table of callbacks. The simulator creates one instance
+ * per ready queue with create(args) and frees it with destroy(); every other
+ * callback gets the instance. Instances of the same plugin may be used from
+ * different threads at once (one per CPU with --cpus and --cpu-threads), so
+ * they must not share mutable state.
+ *
+ *    Processes are identified by handle, an index into the simulator's
+ * process table; with --stream or --trace a handle is reused once its process
+ * has terminated, after which it is enqueued as SCHED_ARRIVED again.
+ *
+ *    Calls are batched: the processes becoming ready and the bursts that
+ * completed since the last call arrive as arrays, right before the simulator
+ * needs a decision (pick_next(), should_preempt(), time_slice() or
+ * list_queue()). All bursts of a batch come before all enqueues, so a process
+ * returning from I/O has its burst reported first.
+ *
+ *    Stability: a plugin is only loaded if its abi_version matches
+ * SCHED_PLUGIN_ABI_VERSION. Later versions only ever append fields to these
+ * structs and enum values, and bump the version.
+ */
+
+#ifndef SCHEDPLUGIN_H
+#define SCHEDPLUGIN_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SCHED_PLUGIN_ABI_VERSION 1
+#define SCHED_PLUGIN_ENTRY "sched_plugin_get"
+
+/* sched_plugin.flags */
+#define SCHED_PLUGIN_TIME_SLICED 0x1u /* time_slice() is called */
+#define SCHED_PLUGIN_PREEMPTIVE 0x2u  /* should_preempt() is called */
+
+/* Why a process is enqueued; SCHED_RUNNING only describes the running
+ * process passed to should_preempt() */
+enum sched_reason {
+  SCHED_ARRIVED = 0,
+  SCHED_IO_COMPLETED = 1,
+  SCHED_PREEMPTED = 2,
+  SCHED_MIGRATED = 3, /* moved from another CPU's ready queue */
+  SCHED_RUNNING = 4
+};
+
+struct sched_task {
+  uint32_t handle;
+  uint32_t pid;    /* 0 is process A, 1 is B, ... */
+  uint32_t reason; /* enum sched_reason */
+  uint32_t tau;     /* the simulator's estimate of the current CPU burst */
+  uint32_t elapsed; /* ms of that burst that have already run */
+  uint32_t bursts_left; /* CPU bursts after that one */
+};
+
+struct sched_burst {
+  uint32_t handle;
+  uint32_t pid;
+  uint32_t length; /* ms the completed CPU burst took */
+};
+
+struct sched_plugin {
+  uint32_t abi_version; /* SCHED_PLUGIN_ABI_VERSION */
+  uint32_t flags;       /* SCHED_PLUGIN_* */
+  const char *name;     /* reported as "Algorithm <name>" */
+
+  /* args is what followed the ':' in --plugin, "" if nothing; NULL if the
+   * instance can't be created */
+  void *(*create)(const char *args);
+  void (*destroy)(void *self);
+
+  /* Adds tasks to the ready queue */
+  void (*enqueue)(void *self, const struct sched_task *tasks, uint32_t n);
+  /* Removes and returns the handle to run next; only called while at least
+   * one process is queued */
+  uint32_t (*pick_next)(void *self);
+  /* Nonzero if candidate, usually just enqueued, should preempt running.
+   * With --cpus and a global queue the running processes are also ranked
+   * this way, candidate->reason then being SCHED_RUNNING too. */
+  int (*should_preempt)(void *self, const struct sched_task *running,
+                        const struct sched_task *candidate);
+  /* Time slice in ms (at least 1) for task, which is starting to run;
+   * asked again when a slice runs out and nothing else is ready */
+  uint32_t (*time_slice)(void *self, const struct sched_task *task);
+  /* May be NULL */
+  void (*on_burst_complete)(void *self, const struct sched_burst *bursts,
+                            uint32_t n);
+  /* Writes the queued handles in display order, at most max of them, and
+   * returns how many there are */
+  uint32_t (*list_queue)(void *self, uint32_t *handles, uint32_t max);
+};
+
+typedef const struct sched_plugin *(*sched_plugin_get_fn)(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
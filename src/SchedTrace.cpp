@@ -0,0 +1,622 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - SchedTrace.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ */
+
+#include "SchedTrace.hpp"
+#include "Process.hpp"
+#include "WorkloadFile.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+enum class TaskState : std::uint8_t { READY, RUNNING, BLOCKED, EXITED };
+
+struct Event {
+  bool isSwitch;
+  std::uint64_t time; // ns
+  // The task switched out (prev) or woken up
+  std::uint32_t pid;
+  TaskState prevState;
+  std::uint32_t nextPid;
+};
+
+enum class LineKind { OTHER, EVENT, MALFORMED };
+
+const char *find(const char *begin, const char *end, const char *needle) {
+  return static_cast<const char *>(
+      memmem(begin, end - begin, needle, std::strlen(needle)));
+}
+
+bool startsWith(const char *begin, const char *end, const char *prefix) {
+  const std::size_t len = std::strlen(prefix);
+  return (std::size_t)(end - begin) >= len &&
+         std::memcmp(begin, prefix, len) == 0;
+}
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+// The number at p, e.g. right after "pid="
+bool parsePid(const char *p, const char *end, std::uint32_t &pid) {
+  std::uint64_t v = 0;
+  const char *start = p;
+  for (; p < end && isDigit(*p) && v <= UINT32_MAX; ++p) {
+    v = v * 10 + (*p - '0');
+  }
+  pid = v;
+  return p != start && v <= UINT32_MAX;
+}
+
+// The number right before p, skipping spaces, e.g. "bash:1234 [120]"
+bool parsePidBefore(const char *begin, const char *p, std::uint32_t &pid) {
+  while (p > begin && p[-1] == ' ') {
+    --p;
+  }
+  const char *start = p;
+  while (start > begin && isDigit(start[-1])) {
+    --start;
+  }
+  return parsePid(start, p, pid);
+}
+
+bool parseField(const char *begin, const char *end, const char *key,
+                std::uint32_t &pid) {
+  const char *p = find(begin, end, key);
+  return p && parsePid(p + std::strlen(key), end, pid);
+}
+
+// A prev_state such as R, R+, S, D|K or X
+bool parseState(const char *p, const char *end, TaskState &state) {
+  const char *tokenEnd = p;
+  while (tokenEnd < end && *tokenEnd != ' ') {
+    ++tokenEnd;
+  }
+  if (p == tokenEnd) {
+    return false;
+  }
+  if (*p == 'R') {
+    state = TaskState::READY;
+  } else if (memchr(p, 'X', tokenEnd - p) || memchr(p, 'Z', tokenEnd - p) ||
+             memchr(p, 'x', tokenEnd - p)) {
+    state = TaskState::EXITED;
+  } else {
+    state = TaskState::BLOCKED;
+  }
+  return true;
+}
+
+// The "seconds.fraction:" timestamp ending right before p, in ns
+bool parseTimeBefore(const char *begin, const char *p, std::uint64_t &time) {
+  while (p > begin && p[-1] == ' ') {
+    --p;
+  }
+  if (p == begin || p[-1] != ':') {
+    return false;
+  }
+  const char *end = p - 1;
+  const char *start = end;
+  while (start > begin && (isDigit(start[-1]) || start[-1] == '.')) {
+    --start;
+  }
+  std::uint64_t secs = 0, frac = 0;
+  unsigned int fracDigits = 0;
+  bool inFraction = false;
+  for (const char *q = start; q < end; ++q) {
+    if (*q == '.') {
+      if (inFraction) {
+        return false;
+      }
+      inFraction = true;
+    } else if (!inFraction) {
+      if (secs > UINT64_MAX / 1000000000ULL / 10) {
+        return false;
+      }
+      secs = secs * 10 + (*q - '0');
+    } else if (fracDigits < 9) {
+      frac = frac * 10 + (*q - '0');
+      ++fracDigits;
+    }
+  }
+  if (start == end || !inFraction) {
+    return false;
+  }
+  for (; fracDigits < 9; ++fracDigits) {
+    frac *= 10;
+  }
+  time = secs * 1000000000ULL + frac;
+  return true;
+}
+
+LineKind parseLine(const char *begin, const char *end, Event &event) {
+  // Find the event name; a comm may contain "sched_" too
+  const char *name = begin;
+  const char *fields = nullptr;
+  while ((name = find(name, end, "sched_")) != nullptr) {
+    const char *p = name + 6;
+    if (name == begin || (name[-1] != ' ' && name[-1] != ':')) {
+      // Part of another word
+    } else if (startsWith(p, end, "switch:")) {
+      event.isSwitch = true;
+      fields = p + 7;
+    } else if (startsWith(p, end, "wakeup:")) {
+      fields = p + 7;
+    } else if (startsWith(p, end, "wakeup_new:")) {
+      fields = p + 11;
+    } else if (startsWith(p, end, "waking:")) {
+      fields = p + 7;
+    }
+    if (fields) {
+      break;
+    }
+    ++name;
+  }
+  if (!fields) {
+    return LineKind::OTHER;
+  }
+  // perf prefixes the name with its subsystem
+  const char *timeEnd = name;
+  if (name - begin >= 6 && std::memcmp(name - 6, "sched:", 6) == 0) {
+    timeEnd = name - 6;
+  }
+  if (!parseTimeBefore(begin, timeEnd, event.time)) {
+    return LineKind::MALFORMED;
+  }
+
+  if (!event.isSwitch) {
+    // comm=bash pid=1234 ..., or perf's bash:1234 [120] ...
+    if (find(fields, end, " pid=")) {
+      return parseField(fields, end, " pid=", event.pid) ? LineKind::EVENT
+                                                        : LineKind::MALFORMED;
+    }
+    const char *prio = find(fields, end, " [");
+    return prio && parsePidBefore(fields, prio, event.pid)
+               ? LineKind::EVENT
+               : LineKind::MALFORMED;
+  }
+
+  const char *state = find(fields, end, " prev_state=");
+  if (state) {
+    return parseField(fields, end, " prev_pid=", event.pid) &&
+                   parseState(state + 12, end, event.prevState) &&
+                   parseField(state, end, " next_pid=", event.nextPid)
+               ? LineKind::EVENT
+               : LineKind::MALFORMED;
+  }
+  // bash:1234 [120] S ==> swapper/2:0 [120]
+  const char *arrow = find(fields, end, "==>");
+  if (!arrow) {
+    return LineKind::MALFORMED;
+  }
+  const char *prevPrio = nullptr;
+  for (const char *p = fields; (p = find(p, arrow, " [")) != nullptr; ++p) {
+    prevPrio = p;
+  }
+  const char *prioEnd = nullptr;
+  if (prevPrio) {
+    prioEnd =
+        static_cast<const char *>(memchr(prevPrio, ']', arrow - prevPrio));
+  }
+  const char *nextPrio = find(arrow, end, " [");
+  if (!prioEnd || !nextPrio || !parsePidBefore(fields, prevPrio, event.pid) ||
+      !parsePidBefore(arrow, nextPrio, event.nextPid)) {
+    return LineKind::MALFORMED;
+  }
+  const char *p = prioEnd + 1;
+  while (p < arrow && *p == ' ') {
+    ++p;
+  }
+  return parseState(p, arrow, event.prevState) ? LineKind::EVENT
+                                               : LineKind::MALFORMED;
+}
+
+/* Rebuilds every task's bursts from the events, spilling each completed burst
+ * to a file as soon as its I/O time is known. */
+class Importer {
+public:
+  struct Burst {
+    std::uint32_t task;
+    std::uint32_t cpuBurstTime;
+    std::uint32_t ioBurstTime;
+  };
+
+  struct Task {
+    std::uint64_t arrivalTime; // ns
+    // When the task last started running or blocked
+    std::uint64_t since = 0;
+    // CPU time of the current burst
+    std::uint64_t cpuTime = 0;
+    std::uint32_t numBursts = 0;
+    TaskState state = TaskState::READY;
+    // Blocked after a burst that still waits for its I/O time
+    bool burstPending = false;
+  };
+
+  Importer(FILE *spill, std::uint64_t tick, const std::string &path)
+      : spill(spill), tick(tick), path(path) {
+    buffer.reserve(BUFFER_SIZE);
+  }
+
+  void handle(const Event &event) {
+    // perf script doesn't always sort events across CPUs
+    firstTime = numEvents++ ? std::min(firstTime, event.time) : event.time;
+    lastTime = std::max(lastTime, event.time);
+    if (!event.isSwitch) {
+      if (event.pid) {
+        wakeUp(taskOf(event.pid, event.time), event.time);
+      }
+      return;
+    }
+    if (event.pid) {
+      switchOut(event.pid, event.prevState, event.time);
+    }
+    if (event.nextPid) {
+      const std::uint32_t t = taskOf(event.nextPid, event.time);
+      wakeUp(t, event.time);
+      tasks[t].state = TaskState::RUNNING;
+      tasks[t].since = event.time;
+    }
+  }
+
+  // Ends every task still alive at the end of the trace
+  void finish() {
+    for (std::uint32_t t = 0; t < tasks.size(); ++t) {
+      Task &task = tasks[t];
+      if (task.state == TaskState::EXITED) {
+        continue;
+      }
+      if (task.state == TaskState::RUNNING) {
+        task.cpuTime += lastTime - task.since;
+      }
+      if (task.state != TaskState::BLOCKED || task.burstPending) {
+        end(t);
+      }
+    }
+    flush();
+  }
+
+  std::uint64_t getNumEvents() const { return numEvents; }
+  std::uint64_t getFirstTime() const { return firstTime; }
+  const std::vector<Task> &getTasks() const { return tasks; }
+
+private:
+  static constexpr std::size_t BUFFER_SIZE = 1 << 16;
+
+  std::uint32_t taskOf(std::uint32_t pid, std::uint64_t time) {
+    auto it = live.find(pid);
+    if (it != live.end()) {
+      return it->second;
+    }
+    if (tasks.size() >= Process::NONE) {
+      throw std::runtime_error("Error: " + path + " has too many tasks.");
+    }
+    Task task;
+    task.arrivalTime = time;
+    task.since = time;
+    tasks.push_back(task);
+    live.emplace(pid, tasks.size() - 1);
+    return tasks.size() - 1;
+  }
+
+  void wakeUp(std::uint32_t t, std::uint64_t time) {
+    Task &task = tasks[t];
+    if (task.state != TaskState::BLOCKED) {
+      return;
+    }
+    if (task.burstPending) {
+      emit(t, task.cpuTime, time - std::min(time, task.since));
+    }
+    task.cpuTime = 0;
+    task.burstPending = false;
+    task.state = TaskState::READY;
+  }
+
+  void switchOut(std::uint32_t pid, TaskState state, std::uint64_t time) {
+    const std::uint32_t t = taskOf(pid, time);
+    Task &task = tasks[t];
+    if (task.state == TaskState::RUNNING) {
+      task.cpuTime += time - std::min(time, task.since);
+    } else if (task.state == TaskState::BLOCKED) {
+      // Missed its wakeup
+      wakeUp(t, time);
+    }
+    if (state == TaskState::EXITED) {
+      end(t);
+      live.erase(pid);
+      return;
+    }
+    task.state = state;
+    task.since = time;
+    // Seen for the first time blocking: what it ran before is unknown
+    task.burstPending =
+        state == TaskState::BLOCKED && (task.cpuTime || task.numBursts);
+  }
+
+  // Emits the last burst of a task, unless it never ran
+  void end(std::uint32_t t) {
+    Task &task = tasks[t];
+    if (task.cpuTime || task.numBursts) {
+      emit(t, task.cpuTime, 0);
+    }
+    task.state = TaskState::EXITED;
+  }
+
+  void emit(std::uint32_t t, std::uint64_t cpuTime, std::uint64_t ioTime) {
+    Burst burst;
+    burst.task = t;
+    burst.cpuBurstTime = std::max<std::uint32_t>(1, toMs(cpuTime));
+    // Only the last burst of a process has no I/O
+    burst.ioBurstTime = ioTime ? std::max<std::uint32_t>(1, toMs(ioTime)) : 0;
+    if (tasks[t].numBursts == UINT32_MAX) {
+      throw std::runtime_error("Error: a task in " + path +
+                               " has too many bursts.");
+    }
+    ++tasks[t].numBursts;
+    buffer.push_back(burst);
+    if (buffer.size() == BUFFER_SIZE) {
+      flush();
+    }
+  }
+
+  std::uint32_t toMs(std::uint64_t time) const {
+    const std::uint64_t ms = (time + tick / 2) / tick;
+    if (ms > UINT32_MAX) {
+      throw std::runtime_error("Error: a burst in " + path +
+                               " is too long for the time scale.");
+    }
+    return ms;
+  }
+
+  void flush() {
+    if (!buffer.empty() &&
+        fwrite(buffer.data(), sizeof(Burst), buffer.size(), spill) !=
+            buffer.size()) {
+      throw std::runtime_error("Error: could not write the bursts of " +
+                               path + " to a temporary file.");
+    }
+    buffer.clear();
+  }
+
+  FILE *spill;
+  std::uint64_t tick;
+  const std::string &path;
+  std::vector<Task> tasks;
+  // Tasks by pid, until they exit
+  std::unordered_map<std::uint32_t, std::uint32_t> live;
+  std::vector<Burst> buffer;
+  std::uint64_t numEvents = 0;
+  // Of the earliest event
+  std::uint64_t firstTime = 0;
+  std::uint64_t lastTime = 0;
+};
+
+/* Reads fd line by line through a fixed buffer; lines longer than the buffer
+ * are passed to onLong() instead. */
+template <class F, class G>
+void forEachLine(int fd, const std::string &path, F onLine, G onLong) {
+  std::vector<char> buf(1 << 20);
+  std::size_t len = 0;
+  bool skipping = false;
+  while (true) {
+    const ssize_t n = read(fd, buf.data() + len, buf.size() - len);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error("Error: could not read " + path + ": " +
+                               std::strerror(errno));
+    }
+    len += n;
+    const char *p = buf.data();
+    const char *end = p + len;
+    const char *nl;
+    while ((nl = static_cast<const char *>(memchr(p, '\n', end - p)))) {
+      if (!skipping) {
+        onLine(p, nl);
+      }
+      skipping = false;
+      p = nl + 1;
+    }
+    len = end - p;
+    std::memmove(buf.data(), p, len);
+    if (n == 0) {
+      if (len && !skipping) {
+        onLine(buf.data(), buf.data() + len);
+      }
+      return;
+    }
+    if (len == buf.size()) {
+      if (!skipping) {
+        onLong();
+      }
+      skipping = true;
+      len = 0;
+    }
+  }
+}
+
+/* Writes the workload file in place: the process table from the tasks, then
+ * every spilled burst into its process' slots. */
+void writeWorkload(const std::vector<Importer::Task> &tasks,
+                   std::uint64_t firstTime, std::uint64_t tick, FILE *spill,
+                   const std::string &path, double lambda, double alpha,
+                   SchedTrace::Summary &summary) {
+  std::vector<std::uint64_t> cursors(tasks.size(), 0);
+  std::uint64_t numProcs = 0, numBurstSlots = 0;
+  for (std::size_t t = 0; t < tasks.size(); ++t) {
+    cursors[t] = numBurstSlots;
+    numProcs += tasks[t].numBursts != 0;
+    numBurstSlots += tasks[t].numBursts;
+  }
+  const WorkloadFile::Header header =
+      WorkloadFile::makeHeader(numProcs, numBurstSlots, alpha);
+
+  const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    throw std::runtime_error("Error: could not create workload file " + path +
+                             ".");
+  }
+  // Allocating up front turns a full disk into an error instead of a SIGBUS
+  void *addr = MAP_FAILED;
+  if (posix_fallocate(fd, 0, header.fileSize) == 0) {
+    addr = mmap(nullptr, header.fileSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+                fd, 0);
+  }
+  close(fd);
+  if (addr == MAP_FAILED) {
+    throw std::runtime_error("Error: could not write workload file " + path +
+                             ".");
+  }
+  char *base = static_cast<char *>(addr);
+  const std::uint64_t n = numProcs;
+  char *table = base + header.procTableOffset;
+  char *arena = base + header.burstArenaOffset;
+  unsigned long long *burstOffsets =
+      reinterpret_cast<unsigned long long *>(table);
+  unsigned int *arrivalTimes = reinterpret_cast<unsigned int *>(table + 8 * n);
+  Process::Pid *pids = reinterpret_cast<Process::Pid *>(table + 12 * n);
+  unsigned int *numBursts = reinterpret_cast<unsigned int *>(table + 16 * n);
+  unsigned int *tau0s = reinterpret_cast<unsigned int *>(table + 20 * n);
+  unsigned int *cpuBurstTimes = reinterpret_cast<unsigned int *>(arena);
+  unsigned int *ioBurstTimes =
+      reinterpret_cast<unsigned int *>(arena + 4 * numBurstSlots);
+
+  std::string error;
+  std::memcpy(base, &header, sizeof(header));
+  std::uint64_t h = 0;
+  for (std::size_t t = 0; t < tasks.size(); ++t) {
+    if (!tasks[t].numBursts) {
+      continue;
+    }
+    const std::uint64_t arrivalTime =
+        (tasks[t].arrivalTime - firstTime) / tick;
+    if (arrivalTime > UINT_MAX) {
+      error = "Error: " + path + " spans too long for the time scale.";
+      break;
+    }
+    burstOffsets[h] = cursors[t];
+    arrivalTimes[h] = arrivalTime;
+    // Pids are handed out in order, as by a Workload's PidAllocator
+    pids[h] = h;
+    numBursts[h] = tasks[t].numBursts;
+    tau0s[h] = ceil(1 / lambda);
+    ++h;
+  }
+
+  std::vector<Importer::Burst> buffer(1 << 16);
+  rewind(spill);
+  std::size_t read;
+  while (error.empty() &&
+         (read = fread(buffer.data(), sizeof(Importer::Burst), buffer.size(),
+                       spill)) > 0) {
+    for (std::size_t i = 0; i < read; ++i) {
+      const Importer::Burst &burst = buffer[i];
+      const std::uint64_t slot = cursors[burst.task]++;
+      cpuBurstTimes[slot] = burst.cpuBurstTime;
+      ioBurstTimes[slot] = burst.ioBurstTime;
+    }
+  }
+  if (error.empty() && ferror(spill)) {
+    error = "Error: could not read back the bursts of " + path + ".";
+  }
+  if (munmap(addr, header.fileSize) != 0 && error.empty()) {
+    error = "Error: could not write workload file " + path + ".";
+  }
+  if (!error.empty()) {
+    unlink(path.c_str());
+    throw std::runtime_error(error);
+  }
+  summary.numProcs = numProcs;
+  summary.numBursts = numBurstSlots;
+}
+
+} // namespace
+
+SchedTrace::Summary SchedTrace::convert(const std::string &tracePath,
+                                        const std::string &workloadPath,
+                                        double lambda, double alpha,
+                                        unsigned int usPerMs) {
+  if (usPerMs == 0) {
+    throw std::runtime_error("Error: a simulated ms must be at least 1us.");
+  }
+  const bool isStdin = tracePath == "-";
+  const std::string name = isStdin ? "stdin" : tracePath;
+  const int fd = isStdin ? STDIN_FILENO : open(tracePath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Error: could not open " + tracePath + ": " +
+                             std::strerror(errno));
+  }
+  // Unlinked right away, so it goes away however the import ends
+  const std::string spillPath = workloadPath + ".tmp";
+  FILE *spill = fopen(spillPath.c_str(), "w+b");
+  if (spill == NULL) {
+    if (!isStdin) {
+      close(fd);
+    }
+    throw std::runtime_error("Error: could not create temporary file " +
+                             spillPath + ".");
+  }
+  unlink(spillPath.c_str());
+
+  const std::uint64_t tick = 1000ULL * usPerMs;
+  Summary summary;
+  try {
+    Importer importer(spill, tick, name);
+    forEachLine(
+        fd, name,
+        [&](const char *begin, const char *end) {
+          ++summary.numLines;
+          Event event = {};
+          switch (parseLine(begin, end, event)) {
+          case LineKind::EVENT:
+            importer.handle(event);
+            break;
+          case LineKind::MALFORMED:
+            ++summary.numMalformed;
+            break;
+          case LineKind::OTHER:
+            break;
+          }
+        },
+        [&] {
+          ++summary.numLines;
+          ++summary.numMalformed;
+        });
+    importer.finish();
+    summary.numEvents = importer.getNumEvents();
+    if (!summary.numEvents) {
+      throw std::runtime_error("Error: " + name +
+                               " has no sched_switch or sched_wakeup events.");
+    }
+    writeWorkload(importer.getTasks(), importer.getFirstTime(), tick, spill,
+                  workloadPath, lambda, alpha, summary);
+  } catch (...) {
+    fclose(spill);
+    if (!isStdin) {
+      close(fd);
+    }
+    throw;
+  }
+  fclose(spill);
+  if (!isStdin) {
+    close(fd);
+  }
+  return summary;
+}
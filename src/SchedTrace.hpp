@@ -0,0 +1,67 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - SchedTrace.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Imports the text dump of a Linux scheduler trace as a binary workload file
+ * (see WorkloadFile.hpp), so real hosts can be replayed with --workload=. The
+ * dump may come from ftrace (the trace or trace_pipe file) or from perf script
+ * after perf sched record; only the sched_switch, sched_wakeup,
+ * sched_wakeup_new and sched_waking lines are used, in either tool's format:
+ *
+ *      bash-1234  [002] d..3  5678.901234: sched_switch: prev_comm=bash
+ *          prev_pid=1234 prev_prio=120 prev_state=S ==> next_comm=swapper/2
+ *          next_pid=0 next_prio=120
+ *      bash  1234 [002]  5678.901234: sched:sched_switch: bash:1234 [120] S
+ *          ==> swapper/2:0 [120]
+ *
+ * (one line each). Every other line, e.g. the header of the dump, is skipped.
+ *
+ *    Each task (pid, other than the idle task 0) becomes a process arriving
+ * when it is first seen. Its CPU burst is the time it spends on a CPU from
+ * waking up until it switches out blocked (any prev_state but R, X or Z);
+ * being preempted (R) only pauses the burst, since the simulated policy
+ * decides preemption itself. The time until it wakes up again is the burst's
+ * I/O time. A task ends with its last burst when it switches out dead (X or
+ * Z) or when the dump ends; its pid may then be reused by a new process.
+ * Tasks that never ran are left out. Times are rounded to simulated ms of
+ * usPerMs trace microseconds each, at least 1ms per burst, and arrival times
+ * count from the earliest event. How long tasks waited to run is not imported,
+ * as it is what the simulated policy decides; a trace of a host with several
+ * CPUs is best replayed with --cpus=.
+ *
+ *    The dump is read once, in fixed-size chunks, so it may be a pipe ("-"
+ * for stdin) and any size: memory grows with the number of tasks, not the
+ * number of events. Completed bursts are spilled to an unlinked temporary
+ * file next to the workload file and scattered into the mapped workload file
+ * once the number of bursts of every task is known.
+ */
+
+#ifndef SCHEDTRACE_HPP
+#define SCHEDTRACE_HPP
+
+#include <string>
+
+namespace SchedTrace {
+
+struct Summary {
+  unsigned long long numLines = 0;
+  unsigned long long numEvents = 0;
+  // Scheduler event lines that could not be parsed, or too long to read
+  unsigned long long numMalformed = 0;
+  unsigned int numProcs = 0;
+  unsigned long long numBursts = 0;
+};
+
+// tracePath "-" reads stdin; lambda sets every process' tau0 to
+// ceil(1 / lambda), as for a process file
+Summary convert(const std::string &tracePath, const std::string &workloadPath,
+                double lambda, double alpha, unsigned int usPerMs);
+} // namespace SchedTrace
+
+#endif
@@ -0,0 +1,931 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - Scheduler.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Single-CPU scheduling simulation shared by every algorithm. The algorithm
+ * specific parts (ready queue, time slicing, preemption, output flavour) come
+ * from the Policy template argument, see Policy.hpp.
+ *
+ *    run() runs the simulation and outputs important events to the EventLog
+ * (nothing if it is nullptr) in chronological order. Processes are admitted
+ * through ProcessTable::admitNext() as they arrive, so the same loop runs
+ * over streaming tables; those skip the initial [NEW] listing.
+ * The simulation is event-driven: after each event tick it jumps straight to
+ * the next context switch end, burst end, time slice expiry, I/O completion or
+ * arrival instead of stepping every ms. Each event tick goes through the
+ * phases:
+ *
+ *    A: a context switch out of the CPU finishes.
+ *    B: the running process makes progress (burst completion, slice expiry).
+ *    C: a context switch into the CPU finishes.
+ *    D: the front of the ready queue preempts the running process.
+ *    E: I/O completions.
+ *    F: new process arrivals.
+ *    G: the front of the ready queue starts switching in.
+ *
+ *    checkRep() and the process state checks between the phases only run in
+ * checked builds, see Invariants.hpp.
+ *
+ *    With a TimeSeries set through setTimeSeries(), run() also records the
+ * CPU, ready queue and I/O state after every event tick. With an EventHash set
+ * through setEventHash(), every event is hashed, whether it is logged or not,
+ * along with the state after the event ticks the hash asks for (see
+ * EventHash.hpp); a hash recording a range of events stops the run once it
+ * is done, like a pause.
+ *
+ *    printInfo() can be called successfully after run() has
+ * completed and will print the final calculated statistics of the run to a
+ * output stream. With showPercentiles set, the average wait and turnaround
+ * times are each followed by the p50, p90, p99 and max of the per-burst
+ * times.
+ *
+ *    reset() resets the object for a future run and resets the
+ * internal processes to their initial state.
+ *
+ *    runUntil(t) runs like run() but pauses before the first event tick at or
+ * after t; calling it (or run()) again resumes. While paused, save() writes
+ * the state of the simulation (this object, the ProcessTable and the policy)
+ * to a snapshot file, see Snapshot.hpp, and restore() loads one into a
+ * Scheduler that hasn't run yet, over the same workload, so that it picks up
+ * where the saved one paused; what it logs from there on is what the saved
+ * one would have. The policy's settings and tcs are not saved, so a restored
+ * run can change them, e.g. to see what another time slice would have done
+ * from time t on; getPolicy() lets a paused run change its policy's settings
+ * in place.
+ */
+
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include "Event.hpp"
+#include "EventHash.hpp"
+#include "EventLog.hpp"
+#include "Invariants.hpp"
+#include "Policy.hpp"
+#include "ProcessTable.hpp"
+#include "Snapshot.hpp"
+#include "TimeSeries.hpp"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+template <class Policy> class Scheduler {
+public:
+  Scheduler(ProcessTable &procs, unsigned int tcs, const Policy &policy,
+            EventLog *log, unsigned int maxOutputTs = NO_OUTPUT_CUTOFF);
+  void printInfo(std::ostream &os, bool showPercentiles = false) const;
+  void run();
+  // Whether the simulation ended; false if it paused before tick pauseAt
+  bool runUntil(unsigned int pauseAt);
+  void save(const std::string &path) const;
+  void restore(const std::string &path);
+  Policy &getPolicy() { return policy; }
+  void reset();
+  void printCsv(std::ostream &os) const;
+  void setTimeSeries(TimeSeries *series) { this->series = series; }
+  void setEventHash(EventHash *hash) { this->hash = hash; }
+  // Simulated ms and event ticks (iterations of the event loop) of run()
+  unsigned int getElapsedTime() const { return timestamp; }
+  unsigned long long getNumEventTicks() const { return numEventTicks; }
+
+private:
+  typedef ProcessTable::Handle ProcessHandle;
+  typedef std::pair<unsigned int, ProcessHandle> ioQueueElem;
+
+  struct PidOrder {
+    const ProcessTable *procs;
+    bool operator()(ProcessHandle a, ProcessHandle b) const {
+      return procs->getPid(a) < procs->getPid(b);
+    }
+  };
+  struct IoOrder {
+    const ProcessTable *procs;
+    bool operator()(const ioQueueElem &a, const ioQueueElem &b) const {
+      return a.first > b.first ||
+             (a.first == b.first &&
+              procs->getPid(a.second) > procs->getPid(b.second));
+    }
+  };
+
+  // Whether an event at the current time makes it into the log; term events
+  // (termination, end of simulation) ignore the cutoff.
+  bool shouldLog(bool term) const {
+    return log && (term || timestamp <= maxOutputTs);
+  }
+  // Whether an event at the current time is logged or hashed
+  bool wantsEvent(bool term) const { return hash || shouldLog(term); }
+  bool showStateEvent() const {
+    return !Policy::exclusiveCutoff || timestamp < maxOutputTs;
+  }
+  Event makeEvent(Event::Type type, ProcessHandle p) const {
+    Event e{type, timestamp, p};
+    if (p != nullProc) {
+      e.tau = procs.getTau(p);
+    }
+    return e;
+  }
+  // Hashes e and logs it if shouldLog(term); shown is false for the state
+  // events an exclusive cutoff hides
+  void logEvent(const Event &e, bool term = false, bool shown = true) const;
+  std::uint64_t stateHash() const;
+  Process::State decrementBurstTimer();
+  void pushIo(ProcessHandle processHandle);
+  void popFirstReady();
+
+  void finishSwitchOut();   // A
+  void runCpu();            // B
+  void finishSwitchIn();    // C
+  void checkPreemption();   // D
+  void completeIo();        // E
+  void admitArrivals();     // F
+  void dispatch();          // G
+  bool isFinished() const;
+  void startRun();
+  void endRun();
+
+  double calcAvgWaitTime(const ProcessTable::Totals &totals) const {
+    return (double)totals.waitTime / totals.numBursts;
+  }
+  double calcAvgTurnaroundTime(const ProcessTable::Totals &totals) const {
+    return (double)totals.turnaroundTime / totals.numBursts;
+  }
+  double calcAvgCpuBurstTime(const ProcessTable::Totals &totals) const {
+    return (double)totals.cpuBurstTime / totals.numBursts;
+  }
+  double calcCpuUtilization() const {
+    return 100.0 * (double)cpuUsageTime / timestamp;
+  }
+  static void printPercentiles(std::ostream &os, const char *what,
+                               const Histogram &hist);
+  void resetTcsRemaining();
+  void resetBurstTimer();
+  void checkRep() const;
+  void decrementTcs();
+  unsigned int nextEventTime() const;
+  void skipQuietTicks(unsigned int numTicks);
+  void preemptRunningProc();
+  inline bool burstTimerElapsed() const { return burstRemaining == 0; }
+
+  // Independent
+  ProcessTable &procs;
+  Policy policy;
+  EventLog *log;
+  TimeSeries *series = nullptr;
+  EventHash *hash = nullptr;
+  const unsigned int maxOutputTs;
+  unsigned int timestamp = 0;
+  unsigned int burstRemaining = 0;
+  unsigned int tcsRemaining = 0;
+
+  unsigned int cpuUsageTime = 0;
+  unsigned long long numEventTicks = 0;
+  unsigned int numReady = 0;
+  bool started = false;
+  bool ended = false;
+
+  // Default
+  std::priority_queue<ioQueueElem, std::vector<ioQueueElem>, IoOrder> ioQueue;
+  const unsigned int tcs;
+  ProcessHandle runningProc = Process::NONE;
+  ProcessHandle switchingOutProc = Process::NONE;
+  ProcessHandle switchingInProc = Process::NONE;
+  static constexpr ProcessHandle nullProc = Process::NONE;
+};
+
+template <class Policy>
+Scheduler<Policy>::Scheduler(ProcessTable &procs, unsigned int tcs,
+                             const Policy &policy, EventLog *log,
+                             unsigned int maxOutputTs)
+    : procs(procs), policy(policy), log(log), maxOutputTs(maxOutputTs),
+      ioQueue(IoOrder{&procs}), tcs(tcs) {}
+
+template <class Policy> bool Scheduler<Policy>::isFinished() const {
+  return switchingInProc == nullProc && switchingOutProc == nullProc &&
+         runningProc == nullProc && policy.empty() &&
+         !procs.hasPendingArrival() && ioQueue.empty();
+}
+
+template <class Policy> void Scheduler<Policy>::reset() {
+  if (!isFinished()) {
+    throw std::runtime_error(
+        "Error: Scheduler::reset() called while algorithm finish constraints "
+        "not satisfied.");
+  }
+  procs.reset();
+  timestamp = 0;
+  burstRemaining = 0;
+  cpuUsageTime = 0;
+  numReady = 0;
+  runningProc = nullProc;
+  switchingOutProc = nullProc;
+  switchingInProc = nullProc;
+  started = false;
+  ended = false;
+}
+
+template <class Policy> void Scheduler<Policy>::decrementTcs() {
+  if (Invariants::checked && switchingOutProc == nullProc &&
+      switchingInProc == nullProc) {
+    throw std::runtime_error(
+        "Error: decrementTcs() when there isn't a process in context switch.");
+  }
+  if (Invariants::checked && !tcsRemaining) {
+    throw std::runtime_error(
+        "Error: decrementTcs() called when tcsRemaining is 0.");
+  }
+  --tcsRemaining;
+}
+
+template <class Policy> unsigned int Scheduler<Policy>::nextEventTime() const {
+  unsigned int next = std::numeric_limits<unsigned int>::max();
+  if (switchingOutProc != nullProc || switchingInProc != nullProc) {
+    next = std::min(next, timestamp + std::max(tcsRemaining, 1u));
+  }
+  if (runningProc != nullProc) {
+    if constexpr (Policy::preemptive && Policy::checksQueueFront) {
+      // The running process' claim on the CPU only gets stronger while it
+      // runs, so phase D can only newly fire after the ready queue changes.
+      // Fall back to a single step if that ever doesn't hold.
+      if (!policy.empty() &&
+          policy.shouldPreempt(runningProc, policy.front())) {
+        return timestamp + 1;
+      }
+    }
+    if constexpr (Policy::timeSliced) {
+      next = std::min(next, timestamp + std::max(burstRemaining, 1u));
+    }
+    next = std::min(next, timestamp + procs.getRemainingBurstTime(runningProc));
+  }
+  if (!ioQueue.empty()) {
+    next = std::min(next, ioQueue.top().first);
+  }
+  if (procs.hasPendingArrival()) {
+    next = std::min(next, procs.nextArrivalTime());
+  }
+  // Every event at or before timestamp has already been handled by this tick,
+  // and a finished simulation still has to step once to reach the exit check.
+  if (next == std::numeric_limits<unsigned int>::max()) {
+    return timestamp + 1;
+  }
+  return std::max(next, timestamp + 1);
+}
+
+template <class Policy>
+void Scheduler<Policy>::skipQuietTicks(unsigned int numTicks) {
+  if (!numTicks) {
+    return;
+  }
+  if (tcsRemaining) {
+    if (Invariants::checked && tcsRemaining <= numTicks) {
+      throw std::runtime_error(
+          "Error: skipQuietTicks() would skip a context switch completion.");
+    }
+    tcsRemaining -= numTicks;
+  }
+  if (runningProc != nullProc) {
+    if constexpr (Policy::timeSliced) {
+      if (Invariants::checked && burstRemaining <= numTicks) {
+        throw std::runtime_error(
+            "Error: skipQuietTicks() would skip a time slice expiry.");
+      }
+      burstRemaining -= numTicks;
+    }
+    cpuUsageTime += numTicks;
+    procs.advanceBurst(runningProc, numTicks);
+  }
+  timestamp += numTicks;
+}
+
+template <class Policy> void Scheduler<Policy>::popFirstReady() {
+  if (Invariants::checked && policy.empty()) {
+    throw std::runtime_error(
+        "Error: Attempted to pop first from an empty ready queue.");
+  }
+  policy.popFront();
+  --numReady;
+}
+
+template <class Policy>
+Process::State Scheduler<Policy>::decrementBurstTimer() {
+  if (Invariants::checked && runningProc == nullProc) {
+    throw std::runtime_error("Error: decrementBurstTimer() was called without "
+                             "a process in the CPU.");
+  }
+  if (Invariants::checked &&
+      procs.getState(runningProc) != Process::State::RUNNING) {
+    throw std::runtime_error("Error: decrementBurstTimer() was called without "
+                             "a process in RUNNING state.");
+  }
+  if constexpr (Policy::timeSliced) {
+    if (Invariants::checked && burstRemaining == 0) {
+      throw std::runtime_error("Error: decrementBurstTimer() was called on a "
+                               "fully elapsed burst timer.");
+    }
+    --burstRemaining;
+  }
+  return procs.decrementBurst(runningProc);
+}
+
+template <class Policy> void Scheduler<Policy>::resetTcsRemaining() {
+  if (Invariants::checked && tcsRemaining) {
+    throw std::runtime_error(
+        "Error: resetTcsRemaining() called when tcsRemaining was not 0.");
+  }
+  tcsRemaining = tcs / 2;
+}
+
+template <class Policy> void Scheduler<Policy>::resetBurstTimer() {
+  // resetBurstTimer when burstRemaining is non-zero is OK, unlike for
+  // tcsRemaining
+  if (Invariants::checked && tcsRemaining) {
+    throw std::runtime_error(
+        "Error: resetBurstTimer() called when ctxSwitchRemaining was not 0.");
+  }
+  if constexpr (Policy::timeSliced) {
+    burstRemaining = policy.timeSlice(runningProc);
+  }
+}
+
+template <class Policy> void Scheduler<Policy>::preemptRunningProc() {
+  if (Invariants::checked && runningProc == nullProc) {
+    throw std::runtime_error(
+        "Error: preemptRunningProc() called when there was no runningProc.");
+  }
+  if (Invariants::checked &&
+      procs.getState(runningProc) != Process::State::RUNNING) {
+    throw std::runtime_error(
+        "Error: preemptRunningProc() called for a non-RUNNING process.");
+  }
+  procs.preempt(runningProc);
+  resetTcsRemaining();
+  switchingOutProc = runningProc;
+  runningProc = nullProc;
+  if (Invariants::checked &&
+      procs.getState(switchingOutProc) != Process::State::SW_READY) {
+    throw std::runtime_error("Error: preempted process in RUNNING state "
+                             "did not move into SW_READY state");
+  }
+}
+
+template <class Policy>
+void Scheduler<Policy>::pushIo(ProcessHandle processHandle) {
+  if (Invariants::checked &&
+      procs.getState(processHandle) != Process::State::WAITING) {
+    throw std::runtime_error(
+        "Error: pushIo() called for process that isn't in WAITING state.");
+  }
+  ioQueue.push(
+      {procs.getCurrIoBurstTime(processHandle) + timestamp, processHandle});
+}
+
+template <class Policy>
+void Scheduler<Policy>::logEvent(const Event &e, bool term, bool shown) const {
+  if (hash) {
+    hash->addEvent(e, procs);
+  }
+  if (!shown || !shouldLog(term)) {
+    return;
+  }
+  e.write(*log, procs, Policy::showTau);
+  *log << " [Q";
+  bool empty = true;
+  policy.forEachQueued([this, &empty](ProcessHandle h) {
+    *log << ' ' << procs.getName(h);
+    empty = false;
+  });
+  *log << (empty ? " <empty>]\n" : "]\n");
+}
+
+template <class Policy> std::uint64_t Scheduler<Policy>::stateHash() const {
+  auto pid = [this](ProcessHandle h) -> std::uint64_t {
+    return h == nullProc ? UINT32_MAX : procs.getPid(h);
+  };
+  std::uint64_t h = EventHash::mix(timestamp, burstRemaining);
+  h = EventHash::mix(h, (std::uint64_t)tcsRemaining << 32 | numReady);
+  h = EventHash::mix(h, pid(runningProc) << 32 | pid(switchingInProc));
+  h = EventHash::mix(h, pid(switchingOutProc));
+  policy.forEachQueued(
+      [&h, &pid](ProcessHandle p) { h = EventHash::mix(h, pid(p)); });
+  // The I/O queue in completion order
+  auto io = ioQueue;
+  for (; !io.empty(); io.pop()) {
+    h = EventHash::mix(h, (std::uint64_t)io.top().first << 32 |
+                              pid(io.top().second));
+  }
+  // Live processes in any order, so it doesn't matter which handles a
+  // streaming table gave them
+  std::uint64_t live = 0;
+  for (ProcessHandle p = 0; p < procs.size(); ++p) {
+    const Process::State state = procs.getState(p);
+    if (state == Process::State::UNARRIVED ||
+        state == Process::State::TERMINATED) {
+      continue;
+    }
+    const std::uint64_t ph = EventHash::mix(pid(p) << 8 | (unsigned)state,
+                                            procs.getBurstsRemaining(p));
+    live += EventHash::mix(ph, procs.getRemainingBurstTime(p));
+  }
+  return EventHash::mix(h, live);
+}
+
+template <class Policy> void Scheduler<Policy>::checkRep() const {
+  if (!Invariants::checked) {
+    return;
+  }
+  if (runningProc != nullProc && switchingOutProc != nullProc) {
+    throw std::runtime_error(
+        "Error: simultaneous runningProc and switchingOutProc.");
+  }
+  if (runningProc != nullProc && switchingInProc != nullProc) {
+    throw std::runtime_error(
+        "Error: simultaneous runningProc and switchingInProc.");
+  }
+  if (switchingInProc != nullProc && switchingOutProc != nullProc) {
+    throw std::runtime_error(
+        "Error: simultaneous switchingInProc and switchingOutProc.");
+  }
+  if (tcsRemaining && switchingInProc == nullProc &&
+      switchingOutProc == nullProc) {
+    throw std::runtime_error(
+        "Error: no switchingInProc or switchingOutProc while tcsRemaining.");
+  }
+}
+
+template <class Policy> void Scheduler<Policy>::finishSwitchOut() {
+  if (tcsRemaining || switchingOutProc == nullProc) {
+    return;
+  }
+  switch (procs.getState(switchingOutProc)) {
+  case Process::State::SW_WAIT:
+    procs.nextState(switchingOutProc, timestamp);
+    if (Invariants::checked &&
+        procs.getState(switchingOutProc) != Process::State::WAITING) {
+      throw std::runtime_error("Error: switchingOutProcess in SW_WAIT did "
+                               "not switch to WAITING state.");
+    }
+    pushIo(switchingOutProc);
+    break;
+  case Process::State::SW_TERM:
+    procs.nextState(switchingOutProc, timestamp);
+    if (Invariants::checked &&
+        procs.getState(switchingOutProc) != Process::State::TERMINATED) {
+      throw std::runtime_error("Error: switchingOutProcess in SW_TERM did "
+                               "not switch to TERMINATED state.");
+    }
+    break;
+  case Process::State::SW_READY:
+    procs.nextState(switchingOutProc, timestamp);
+    if (Invariants::checked &&
+        procs.getState(switchingOutProc) != Process::State::READY) {
+      throw std::runtime_error("Error: switchingOutProcess in SW_READY did "
+                               "not switch to READY state.");
+    }
+    policy.push(switchingOutProc, ReadyReason::PREEMPTED);
+    ++numReady;
+    break;
+  default:
+    throw std::runtime_error("Error: switching out process was not in "
+                             "SW_WAIT, SW_READY, or SW_TERM state.");
+  }
+  switchingOutProc = nullProc;
+}
+
+template <class Policy> void Scheduler<Policy>::runCpu() {
+  if (runningProc == nullProc) {
+    return;
+  }
+  if (Invariants::checked &&
+      procs.getState(runningProc) != Process::State::RUNNING) {
+    throw std::runtime_error(
+        "Error: SW_IN process did not switch to RUNNING state");
+  }
+  ++cpuUsageTime;
+  // tau is recalculated as soon as the burst completes, but the completion
+  // event still reports the estimate the burst was scheduled with
+  Event completed = makeEvent(Event::Type::BURST_COMPLETED, runningProc);
+  Process::State currState = decrementBurstTimer();
+  if (currState == Process::State::RUNNING) {
+    if constexpr (Policy::timeSliced) {
+      if (burstTimerElapsed()) {
+        if (!policy.empty()) {
+          if (wantsEvent(false)) {
+            Event e = makeEvent(Event::Type::SLICE_EXPIRED, runningProc);
+            e.value = procs.getRemainingBurstTime(runningProc);
+            logEvent(e);
+          }
+          preemptRunningProc();
+        } else {
+          if (wantsEvent(false)) {
+            logEvent(
+                makeEvent(Event::Type::SLICE_EXPIRED_NO_PREEMPTION, nullProc));
+          }
+          resetBurstTimer();
+        }
+      }
+    }
+  } else if (currState == Process::State::SW_WAIT) {
+    if (wantsEvent(false)) {
+      completed.value = procs.getBurstsRemaining(runningProc);
+      logEvent(completed);
+      if (Policy::showTau) {
+        logEvent(makeEvent(Event::Type::TAU_RECALCULATED, runningProc));
+      }
+    }
+    resetTcsRemaining();
+    switchingOutProc = runningProc;
+    runningProc = nullProc;
+    if (wantsEvent(false)) {
+      Event e = makeEvent(Event::Type::SWITCHING_TO_IO, switchingOutProc);
+      e.value =
+          procs.getCurrIoBurstTime(switchingOutProc) + timestamp + tcsRemaining;
+      logEvent(e);
+    }
+  } else if (currState == Process::State::SW_TERM) {
+    if (wantsEvent(true)) {
+      logEvent(makeEvent(Event::Type::TERMINATED, runningProc), true);
+    }
+    resetTcsRemaining();
+    switchingOutProc = runningProc;
+    runningProc = nullProc;
+  } else {
+    throw std::runtime_error(
+        "Error: runningProc wasn't in RUNNING, SW_WAIT, or SW_TERM stage "
+        "after decrementBurst");
+  }
+}
+
+template <class Policy> void Scheduler<Policy>::finishSwitchIn() {
+  if (tcsRemaining || switchingInProc == nullProc) {
+    return;
+  }
+  if (Invariants::checked &&
+      procs.getState(switchingInProc) != Process::State::SW_IN) {
+    throw std::runtime_error("Error: Switching in process did not have "
+                             "correct SW_IN process state.");
+  }
+  if (wantsEvent(false)) {
+    Event e = makeEvent(
+        !Policy::alwaysShowRemaining && procs.isStartOfBurst(switchingInProc)
+            ? Event::Type::STARTED_BURST
+            : Event::Type::RESUMED_BURST,
+        switchingInProc);
+    e.value = procs.getRemainingBurstTime(switchingInProc);
+    logEvent(e, false, showStateEvent());
+  }
+  procs.nextState(switchingInProc, timestamp);
+  if (Invariants::checked &&
+      procs.getState(switchingInProc) != Process::State::RUNNING) {
+    throw std::runtime_error(
+        "Error: SW_IN process did not switch to RUNNING state.");
+  }
+  runningProc = switchingInProc;
+  switchingInProc = nullProc;
+  if constexpr (Policy::timeSliced) {
+    resetBurstTimer();
+  }
+}
+
+template <class Policy> void Scheduler<Policy>::checkPreemption() {
+  if constexpr (Policy::preemptive && Policy::checksQueueFront) {
+    if (runningProc != nullProc && !policy.empty() &&
+        policy.shouldPreempt(runningProc, policy.front())) {
+      if (wantsEvent(false)) {
+        Event e = makeEvent(Event::Type::WILL_PREEMPT, policy.front());
+        e.other = runningProc;
+        logEvent(e);
+      }
+      preemptRunningProc();
+    }
+  }
+}
+
+template <class Policy> void Scheduler<Policy>::completeIo() {
+  while (!ioQueue.empty() && ioQueue.top().first <= timestamp) {
+    const ProcessHandle h = ioQueue.top().second;
+    if (Invariants::checked && procs.getState(h) != Process::State::WAITING) {
+      throw std::runtime_error(
+          "Error: process in ioQueue was not in WAITING state.");
+    }
+    procs.nextState(h, timestamp);
+    if (Invariants::checked && procs.getState(h) != Process::State::READY) {
+      throw std::runtime_error(
+          "Error: WAITING process did not switch to READY state.");
+    }
+    policy.push(h, ReadyReason::IO_COMPLETED);
+    ++numReady;
+
+    bool preempted = false;
+    if constexpr (Policy::preemptive) {
+      if (runningProc != nullProc && switchingOutProc == nullProc &&
+          policy.shouldPreempt(runningProc, h)) {
+        // arriving process preempts running process
+        preemptRunningProc();
+        preempted = true;
+        if (wantsEvent(false)) {
+          Event e = makeEvent(Event::Type::IO_COMPLETED_PREEMPTING, h);
+          e.other = switchingOutProc;
+          logEvent(e);
+        }
+      }
+    }
+    if (!preempted && wantsEvent(false)) {
+      // Finished I/O, back to ready queue
+      logEvent(makeEvent(Event::Type::IO_COMPLETED, h), false,
+               showStateEvent());
+    }
+    ioQueue.pop();
+  }
+}
+
+template <class Policy> void Scheduler<Policy>::admitArrivals() {
+  while (procs.hasPendingArrival() && procs.nextArrivalTime() <= timestamp) {
+    const ProcessHandle h = procs.admitNext();
+    if (Invariants::checked && procs.getState(h) != Process::State::UNARRIVED) {
+      throw std::runtime_error(
+          "Error: unarrived process was not in UNARRIVED state.");
+    }
+    procs.nextState(h, timestamp);
+    if (Invariants::checked && procs.getState(h) != Process::State::READY) {
+      throw std::runtime_error(
+          "Error: UNARRIVED process did not switch to READY state.");
+    }
+    policy.push(h, ReadyReason::ARRIVED);
+    ++numReady;
+    if (series) {
+      series->addArrival(timestamp);
+    }
+
+    bool preempted = false;
+    if constexpr (Policy::preemptive) {
+      if (runningProc != nullProc && switchingOutProc == nullProc &&
+          policy.shouldPreempt(runningProc, h)) {
+        // Newly arrived process preempted running process
+        preemptRunningProc();
+        preempted = true;
+        if (wantsEvent(false)) {
+          Event e = makeEvent(Event::Type::ARRIVED_PREEMPTING, h);
+          e.other = switchingOutProc;
+          logEvent(e);
+        }
+      }
+    }
+    if (!preempted && wantsEvent(false)) {
+      logEvent(makeEvent(Event::Type::ARRIVED, h), false, showStateEvent());
+    }
+  }
+}
+
+template <class Policy> void Scheduler<Policy>::dispatch() {
+  if (tcsRemaining || runningProc != nullProc || switchingInProc != nullProc ||
+      switchingOutProc != nullProc || policy.empty()) {
+    return;
+  }
+  switchingInProc = policy.front();
+  if (Invariants::checked &&
+      procs.getState(switchingInProc) != Process::State::READY) {
+    throw std::runtime_error("Error: process that was pulled from ready "
+                             "queue was not in READY state.");
+  }
+  popFirstReady();
+  procs.nextState(switchingInProc, timestamp);
+  if (Invariants::checked &&
+      procs.getState(switchingInProc) != Process::State::SW_IN) {
+    throw std::runtime_error(
+        "Error: READY process did not switch to SW_IN state.");
+  }
+  resetTcsRemaining();
+}
+
+template <class Policy> void Scheduler<Policy>::startRun() {
+  checkRep();
+  // A streaming table doesn't know its processes before they arrive
+  if (log && !procs.isStreaming()) {
+    std::vector<ProcessHandle> byPid(procs.size());
+    for (ProcessHandle h = 0; h < procs.size(); ++h) {
+      byPid[h] = h;
+    }
+    sort(byPid.begin(), byPid.end(), PidOrder{&procs});
+    for (auto &proc : byPid) {
+      *log << "Process " << procs.getName(proc) << " [NEW] (arrival time "
+           << procs.getArrivalTime(proc) << " ms) ";
+      *log << procs.getNumBursts(proc) << " CPU burst"
+           << (procs.getNumBursts(proc) == 1 ? "" : "s");
+      if (Policy::showTau) {
+        *log << " (tau " << procs.getTau(proc) << "ms)";
+      }
+      *log << '\n';
+    }
+  }
+  if (wantsEvent(false)) {
+    const std::string description = policy.describe();
+    Event e = makeEvent(Event::Type::SIM_STARTED, nullProc);
+    e.text = description.c_str();
+    logEvent(e);
+  }
+  numEventTicks = 0;
+  started = true;
+}
+
+template <class Policy> void Scheduler<Policy>::endRun() {
+  if (timestamp > 0) {
+    --timestamp;
+  }
+  if (series) {
+    series->finish(timestamp);
+  }
+  if (wantsEvent(true)) {
+    Event e = makeEvent(Event::Type::SIM_ENDED, nullProc);
+    e.text = policy.name();
+    logEvent(e, true);
+  }
+  if (hash) {
+    hash->finish(timestamp, stateHash());
+  }
+  ended = true;
+}
+
+template <class Policy> void Scheduler<Policy>::run() {
+  runUntil(std::numeric_limits<unsigned int>::max());
+}
+
+template <class Policy>
+bool Scheduler<Policy>::runUntil(unsigned int pauseAt) {
+  if (!started) {
+    startRun();
+  }
+  while (!ended) { // <<< BEGIN SIMULATION
+    checkRep();
+    if (isFinished()) {
+      endRun();
+      break;
+    }
+    if (timestamp >= pauseAt || (hash && hash->isDone())) {
+      return false;
+    }
+    ++numEventTicks;
+    if constexpr (Policy::clocked) {
+      policy.advanceClock(timestamp);
+    }
+
+    if (tcsRemaining) {
+      // decrement context switch timer
+      decrementTcs();
+    }
+
+    finishSwitchOut(); // A
+    runCpu();          // B: (a) CPU burst completion
+    finishSwitchIn();  // C
+    checkPreemption(); // D
+    completeIo();      // E: (b) I/O burst completions
+    admitArrivals();   // F: (c) new process arrivals
+    dispatch();        // G
+    if (series) {
+      series->record(timestamp,
+                     {runningProc != nullProc,
+                      switchingInProc != nullProc ||
+                          switchingOutProc != nullProc,
+                      numReady, (unsigned int)ioQueue.size()});
+    }
+    if (hash && hash->wantsCheckpoint()) {
+      hash->checkpoint(timestamp, stateHash());
+    }
+
+    skipQuietTicks(nextEventTime() - timestamp - 1);
+    ++timestamp;
+    checkRep();
+  } // <<< END SIMULATION
+  return true;
+}
+
+template <class Policy>
+void Scheduler<Policy>::save(const std::string &path) const {
+  SnapshotWriter out;
+  out.putString(policy.name());
+  procs.saveState(out);
+  policy.saveState(out);
+  // In completion order
+  std::vector<unsigned int> ioTimes;
+  std::vector<ProcessHandle> ioProcs;
+  for (auto io = ioQueue; !io.empty(); io.pop()) {
+    ioTimes.push_back(io.top().first);
+    ioProcs.push_back(io.top().second);
+  }
+  out.putArray(ioTimes);
+  out.putArray(ioProcs);
+  out.put(timestamp);
+  out.put(burstRemaining);
+  out.put(tcsRemaining);
+  out.put(cpuUsageTime);
+  out.put(numEventTicks);
+  out.put(numReady);
+  out.put(runningProc);
+  out.put(switchingOutProc);
+  out.put(switchingInProc);
+  out.put(started);
+  out.put(ended);
+  out.save(path);
+}
+
+template <class Policy>
+void Scheduler<Policy>::restore(const std::string &path) {
+  if (started) {
+    throw std::runtime_error(
+        "Error: Scheduler::restore() called after the simulation started.");
+  }
+  SnapshotReader in = SnapshotReader::load(path);
+  const std::string name = in.getString();
+  if (name != policy.name()) {
+    in.fail("is of " + name + ", not " + policy.name());
+  }
+  procs.loadState(in);
+  policy.loadState(in, procs.size());
+  std::vector<unsigned int> ioTimes;
+  std::vector<ProcessHandle> ioProcs;
+  in.getArray(ioTimes);
+  in.getIndices(ioProcs, procs.size());
+  if (ioProcs.size() != ioTimes.size()) {
+    in.fail("is truncated or corrupt");
+  }
+  for (std::size_t i = 0; i < ioTimes.size(); ++i) {
+    ioQueue.push({ioTimes[i], ioProcs[i]});
+  }
+  timestamp = in.get<unsigned int>();
+  burstRemaining = in.get<unsigned int>();
+  tcsRemaining = in.get<unsigned int>();
+  cpuUsageTime = in.get<unsigned int>();
+  numEventTicks = in.get<unsigned long long>();
+  numReady = in.get<unsigned int>();
+  runningProc = in.get<ProcessHandle>();
+  switchingOutProc = in.get<ProcessHandle>();
+  switchingInProc = in.get<ProcessHandle>();
+  started = in.get<bool>();
+  ended = in.get<bool>();
+  in.finish();
+  for (ProcessHandle h : {runningProc, switchingOutProc, switchingInProc}) {
+    if (h != nullProc && h >= procs.size()) {
+      in.fail("doesn't match the simulation it is restored into");
+    }
+  }
+  checkRep();
+}
+
+template <class Policy>
+void Scheduler<Policy>::printPercentiles(std::ostream &os, const char *what,
+                                         const Histogram &hist) {
+  os << "-- " << what << " p50/p90/p99/max: " << hist.percentile(50) << "/"
+     << hist.percentile(90) << "/" << hist.percentile(99) << "/" << hist.max()
+     << " ms" << std::endl;
+}
+
+template <class Policy>
+void Scheduler<Policy>::printInfo(std::ostream &os,
+                                  bool showPercentiles) const {
+  const ProcessTable::Totals totals = procs.totals();
+  os << "Algorithm " + std::string(policy.name()) << std::endl;
+
+  os.precision(3);
+  os << "-- average CPU burst time: " << std::fixed
+     << calcAvgCpuBurstTime(totals) << " ms" << std::endl;
+  os << "-- average wait time: " << std::fixed << calcAvgWaitTime(totals)
+     << " ms" << std::endl;
+  if (showPercentiles) {
+    printPercentiles(os, "wait time", totals.waitTimeHist);
+  }
+  os << "-- average turnaround time: " << std::fixed
+     << calcAvgTurnaroundTime(totals) << " ms" << std::endl;
+  if (showPercentiles) {
+    printPercentiles(os, "turnaround time", totals.turnaroundTimeHist);
+  }
+
+  os.precision(0);
+  os << "-- total number of context switches: " << totals.numCtxSwitches
+     << std::endl;
+  os << "-- total number of preemptions: " << totals.numPreempts << std::endl;
+
+  os.precision(3);
+  os << "-- CPU utilization: " << std::fixed << calcCpuUtilization() << "%"
+     << std::endl;
+}
+
+template <class Policy>
+void Scheduler<Policy>::printCsv(std::ostream &os) const {
+  const ProcessTable::Totals totals = procs.totals();
+  os << policy.name() << "," << calcAvgCpuBurstTime(totals) << ",";
+  os << calcAvgWaitTime(totals) << "," << calcAvgTurnaroundTime(totals) << ",";
+  os << totals.numCtxSwitches << "," << totals.numPreempts << ",";
+  os << calcCpuUtilization() << "," << std::endl;
+}
+
+#endif
@@ -9,32 +9,215 @@
  */
 
 #include "SeqGenerator.hpp"
+#include "ExpSampler.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
 
-inline double SeqGenerator::nextExp(double lambda) {
-  return -log(drand48()) / lambda;
+template <class Rng>
+inline double SeqGenerator::nextExp(Rng &rng, double lambda) {
+  return -log(rng.next()) / lambda;
 }
 
-inline unsigned int SeqGenerator::randNumBursts() {
-  return 1 + drand48() * 100;
+template <class Rng> inline unsigned int SeqGenerator::randNumBursts(Rng &rng) {
+  return 1 + rng.next() * 100;
 }
 
-unsigned int SeqGenerator::floorNextExp(double lambda, double maxval) {
+template <class Rng>
+unsigned int SeqGenerator::floorNextExp(Rng &rng, double lambda,
+                                        double maxval) {
   double res = std::numeric_limits<unsigned int>::max();
   while (res > maxval)
-    res = floor(nextExp(lambda));
+    res = floor(nextExp(rng, lambda));
   return res;
 }
 
-unsigned int SeqGenerator::ceilNextExp(double lambda, double maxval) {
+template <class Rng>
+unsigned int SeqGenerator::ceilNextExp(Rng &rng, double lambda,
+                                       double maxval) {
   double res = std::numeric_limits<unsigned int>::max();
   while (res > maxval)
-    res = ceil(nextExp(lambda));
+    res = ceil(nextExp(rng, lambda));
   return res;
 }
 
-std::vector<Process>
-SeqGenerator::parseProcesses(std::string fname, double lambda, unsigned int tcs,
-                             double alpha, unsigned int tslice) {
+template unsigned int SeqGenerator::floorNextExp(Rand48 &, double, double);
+template unsigned int SeqGenerator::ceilNextExp(Rand48 &, double, double);
+template unsigned int SeqGenerator::floorNextExp(Philox::Stream &, double,
+                                                 double);
+template unsigned int SeqGenerator::ceilNextExp(Philox::Stream &, double,
+                                                double);
+
+namespace {
+
+// Counter word c2 of a PHILOX draw; c0 is the process, c1 the burst
+enum PhiloxDraw : std::uint32_t { ARRIVAL, NUM_BURSTS, CPU_BURST, IO_BURST };
+
+/* Uniforms of one process for the INVERSE_CDF sampler and what they map to */
+struct InverseCdfBuffers {
+  std::vector<double> cpuUniforms;
+  std::vector<double> ioUniforms;
+  std::vector<unsigned int> cpuBurstTimes;
+  std::vector<unsigned int> ioBurstTimes;
+
+  void resize(unsigned int numBursts) {
+    cpuUniforms.resize(numBursts);
+    ioUniforms.resize(numBursts - 1);
+  }
+  // Maps the uniforms to bursts; the I/O time of the last burst is 0
+  void sample(double lambda, double maxval) {
+    const unsigned int numBursts = cpuUniforms.size();
+    cpuBurstTimes.resize(numBursts);
+    ioBurstTimes.resize(numBursts);
+    ExpSampler::ceilTruncated(cpuUniforms.data(), cpuBurstTimes.data(),
+                              numBursts, lambda, maxval);
+    ExpSampler::ceilTruncated(ioUniforms.data(), ioBurstTimes.data(),
+                              numBursts - 1, lambda, maxval);
+    for (unsigned int j = 0; j + 1 < numBursts; ++j) {
+      ioBurstTimes[j] *= 10;
+    }
+    ioBurstTimes[numBursts - 1] = 0;
+  }
+};
+
+/* The PHILOX draws of process i: every value comes from its own stream, the
+ * REJECTION sampler using as many draws of it as it needs and INVERSE_CDF
+ * only the first. */
+class PhiloxProcess {
+public:
+  PhiloxProcess(const Philox::Key &key, unsigned int i, double lambda,
+                double maxval, SeqGenerator::Sampler sampler)
+      : key(key), i(i), lambda(lambda), maxval(maxval), sampler(sampler) {}
+
+  unsigned int arrivalTime() const {
+    Philox::Stream rng(key, i, 0, ARRIVAL);
+    if (sampler == SeqGenerator::Sampler::INVERSE_CDF) {
+      const double u = rng.next();
+      unsigned int arrival;
+      ExpSampler::floorTruncated(&u, &arrival, 1, lambda, maxval);
+      return arrival;
+    }
+    return SeqGenerator::floorNextExp(rng, lambda, maxval);
+  }
+
+  unsigned int numBursts() const {
+    Philox::Stream rng(key, i, 0, NUM_BURSTS);
+    return SeqGenerator::randNumBursts(rng);
+  }
+
+  // Fills the bursts into cpuBurstTimes and ioBurstTimes
+  void bursts(unsigned int numBursts, InverseCdfBuffers &buf) const {
+    if (sampler == SeqGenerator::Sampler::INVERSE_CDF) {
+      buf.resize(numBursts);
+      for (unsigned int j = 0; j < numBursts; ++j) {
+        buf.cpuUniforms[j] = Philox::Stream(key, i, j, CPU_BURST).next();
+        if (j + 1 != numBursts) {
+          buf.ioUniforms[j] = Philox::Stream(key, i, j, IO_BURST).next();
+        }
+      }
+      buf.sample(lambda, maxval);
+      return;
+    }
+    buf.cpuBurstTimes.resize(numBursts);
+    buf.ioBurstTimes.resize(numBursts);
+    for (unsigned int j = 0; j < numBursts; ++j) {
+      Philox::Stream cpu(key, i, j, CPU_BURST);
+      Philox::Stream io(key, i, j, IO_BURST);
+      buf.cpuBurstTimes[j] = SeqGenerator::ceilNextExp(cpu, lambda, maxval);
+      buf.ioBurstTimes[j] =
+          j + 1 != numBursts
+              ? 10 * SeqGenerator::ceilNextExp(io, lambda, maxval)
+              : 0;
+    }
+  }
+
+private:
+  Philox::Key key;
+  unsigned int i;
+  double lambda;
+  double maxval;
+  SeqGenerator::Sampler sampler;
+};
+
+Workload generatePhilox(unsigned int n, double lambda, double maxval,
+                        long int seedval, double alpha,
+                        SeqGenerator::Sampler sampler,
+                        unsigned int numThreads) {
+  const Philox::Key key = Philox::keyFor(seedval);
+  Workload processes(alpha);
+  processes.reserve(n, 51ULL * n);
+  for (unsigned int i = 0; i < n; ++i) {
+    const PhiloxProcess proc(key, i, lambda, maxval, sampler);
+    processes.add(proc.arrivalTime(), proc.numBursts(), ceil(1 / lambda));
+  }
+
+  // Every burst only depends on its own counter, so the arena is filled in
+  // parallel, each task writing the bursts of a disjoint range of processes.
+  static constexpr unsigned int CHUNK = 4096;
+  ThreadPool pool(numThreads);
+  for (unsigned int begin = 0; begin < n; begin += CHUNK) {
+    pool.submit([&processes, &key, begin, n, lambda, maxval, sampler] {
+      const unsigned int end = std::min(n, begin + CHUNK);
+      InverseCdfBuffers buf;
+      for (Workload::Handle h = begin; h < end; ++h) {
+        const unsigned int numBursts = processes.getNumBursts(h);
+        PhiloxProcess(key, h, lambda, maxval, sampler).bursts(numBursts, buf);
+        for (unsigned int j = 0; j < numBursts; ++j) {
+          processes.setBurst(h, j, buf.cpuBurstTimes[j], buf.ioBurstTimes[j]);
+        }
+      }
+    });
+  }
+  pool.wait();
+  return processes;
+}
+
+} // namespace
+
+void SeqGenerator::generateProcess(unsigned int i, double lambda,
+                                   double maxval, long int seedval,
+                                   ProcessSpec &spec, Sampler sampler) {
+  const PhiloxProcess proc(Philox::keyFor(seedval), i, lambda, maxval,
+                           sampler);
+  InverseCdfBuffers buf;
+  spec.arrivalTime = proc.arrivalTime();
+  spec.pid = i;
+  spec.tau0 = ceil(1 / lambda);
+  proc.bursts(proc.numBursts(), buf);
+  spec.cpuBurstTimes.swap(buf.cpuBurstTimes);
+  spec.ioBurstTimes.swap(buf.ioBurstTimes);
+}
+
+std::vector<unsigned int>
+SeqGenerator::arrivalOrder(unsigned int n, double lambda, double maxval,
+                           long int seedval, Sampler sampler) {
+  const Philox::Key key = Philox::keyFor(seedval);
+  std::vector<std::pair<unsigned int, unsigned int>> arrivals(n);
+  for (unsigned int i = 0; i < n; ++i) {
+    arrivals[i] = {PhiloxProcess(key, i, lambda, maxval, sampler).arrivalTime(),
+                   i};
+  }
+  std::sort(arrivals.begin(), arrivals.end());
+  std::vector<unsigned int> order(n);
+  for (unsigned int i = 0; i < n; ++i) {
+    order[i] = arrivals[i].second;
+  }
+  return order;
+}
+
+/* Reads the next unsigned integer of a process file, closing fp on failure. */
+static unsigned int readUnsigned(FILE *fp, const std::string &fname) {
+  unsigned int value;
+  if (fscanf(fp, "%u", &value) != 1) {
+    fclose(fp);
+    throw std::runtime_error("Error: " + fname +
+                             " is truncated or not a process file.");
+  }
+  return value;
+}
+
+Workload SeqGenerator::parseProcesses(std::string fname, double lambda,
+                                          unsigned int tcs, double alpha,
+                                          unsigned int tslice) {
   FILE *fp;
   if (NULL == (fp = fopen(fname.c_str(), "r"))) {
     throw std::runtime_error("Error: could not open file.");
@@ -45,54 +228,121 @@ SeqGenerator::parseProcesses(std::string fname, double lambda, unsigned int tcs,
   unsigned int nCpuBursts;
   unsigned int nIoBursts;
 
-  fscanf(fp, "%u", &n);
-  std::vector<Process> processes;
-  processes.reserve(n);
+  n = readUnsigned(fp, fname);
+  Workload processes(alpha);
+  processes.reserve(n, 0);
   for (unsigned int i = 0; i < n; ++i) {
-    fscanf(fp, "%u", &arrivalTime);
-    fscanf(fp, "%u", &nCpuBursts);
+    arrivalTime = readUnsigned(fp, fname);
+    nCpuBursts = readUnsigned(fp, fname);
     if (nCpuBursts == 0) {
+      fclose(fp);
       throw std::runtime_error("Error: nCpuBursts was 0.");
     }
     nIoBursts = nCpuBursts - 1;
     std::vector<unsigned int> cpuBurstTimes(nCpuBursts);
     std::vector<unsigned int> ioBurstTimes(nIoBursts);
     for (unsigned int j = 0; j < nCpuBursts; ++j) {
-      fscanf(fp, "%u", &cpuBurstTimes[j]);
+      cpuBurstTimes[j] = readUnsigned(fp, fname);
+      if (cpuBurstTimes[j] == 0) {
+        fclose(fp);
+        throw std::runtime_error("Error: " + fname +
+                                 " has a 0ms CPU burst for process " +
+                                 Process::fmtPid(i) + ".");
+      }
     }
 
     for (unsigned int j = 0; j < nIoBursts; ++j) {
-      fscanf(fp, "%u", &ioBurstTimes[j]);
+      ioBurstTimes[j] = readUnsigned(fp, fname);
+    }
+    Workload::Handle h =
+        processes.add(arrivalTime, nCpuBursts, ceil(1 / lambda));
+    for (unsigned int j = 0; j < nCpuBursts; ++j) {
+      processes.setBurst(h, j, cpuBurstTimes[j],
+                         j < nIoBursts ? ioBurstTimes[j] : 0);
     }
-    processes.push_back(Process(arrivalTime, cpuBurstTimes, ioBurstTimes,
-                                ceil(1 / lambda), alpha));
   }
+  fclose(fp);
 
   return processes;
 }
 
-std::vector<Process>
-SeqGenerator::generateProccesses(unsigned short n, double lambda, double maxval,
-                                 long int seedval, double alpha) {
-  srand48(seedval);
+void SeqGenerator::writeProcesses(const Workload &workload,
+                                  std::string fname) {
+  FILE *fp;
+  if (NULL == (fp = fopen(fname.c_str(), "w"))) {
+    throw std::runtime_error("Error: could not create " + fname + ".");
+  }
+  fprintf(fp, "%u\n", workload.size());
+  for (Workload::Handle h = 0; h < workload.size(); ++h) {
+    const unsigned long long begin = workload.getBurstOffset(h);
+    const unsigned int numBursts = workload.getNumBursts(h);
+    fprintf(fp, "%u %u\n", workload.getArrivalTime(h), numBursts);
+    for (unsigned int j = 0; j < numBursts; ++j) {
+      fprintf(fp, j ? " %u" : "%u", workload.getCpuBurstTime(begin + j));
+    }
+    fputc('\n', fp);
+    for (unsigned int j = 0; j + 1 < numBursts; ++j) {
+      fprintf(fp, j ? " %u" : "%u", workload.getIoBurstTime(begin + j));
+    }
+    fputc('\n', fp);
+  }
+  if (fclose(fp) != 0) {
+    throw std::runtime_error("Error: could not write " + fname + ".");
+  }
+}
+
+Workload SeqGenerator::generateProccesses(unsigned int n, double lambda,
+                                              double maxval, long int seedval,
+                                              double alpha, RngMode mode,
+                                              Sampler sampler,
+                                              unsigned int numThreads) {
+  if (mode == RngMode::PHILOX) {
+    return generatePhilox(n, lambda, maxval, seedval, alpha, sampler,
+                          numThreads);
+  }
+  Rand48 rng(seedval);
   unsigned int arrivalTime;
   unsigned int numBursts;
-  std::vector<Process> processes;
-  processes.reserve(n);
-  for (unsigned short i = 0; i < n; ++i) {
-
-    arrivalTime = floorNextExp(lambda, maxval);
-    numBursts = randNumBursts();
-    std::vector<unsigned int> cpuBurstTimes(numBursts);
-    std::vector<unsigned int> ioBurstTimes(numBursts - 1);
+  unsigned int cpuBurstTime;
+  unsigned int ioBurstTime;
+  Workload processes(alpha);
+  // Bursts per process are uniform in [1, 100]
+  processes.reserve(n, 51ULL * n);
+  InverseCdfBuffers buf;
+  for (unsigned int i = 0; i < n; ++i) {
+    if (sampler == Sampler::INVERSE_CDF) {
+      // Same draw order as below, but exactly one draw per value
+      const double u = rng.next();
+      ExpSampler::floorTruncated(&u, &arrivalTime, 1, lambda, maxval);
+      numBursts = randNumBursts(rng);
+      buf.resize(numBursts);
+      for (unsigned int j = 0; j < numBursts; ++j) {
+        buf.cpuUniforms[j] = rng.next();
+        if (j + 1 != numBursts) {
+          buf.ioUniforms[j] = rng.next();
+        }
+      }
+      buf.sample(lambda, maxval);
+      Workload::Handle h =
+          processes.add(arrivalTime, numBursts, ceil(1 / lambda));
+      for (unsigned int j = 0; j < numBursts; ++j) {
+        processes.setBurst(h, j, buf.cpuBurstTimes[j], buf.ioBurstTimes[j]);
+      }
+      continue;
+    }
+
+    arrivalTime = floorNextExp(rng, lambda, maxval);
+    numBursts = randNumBursts(rng);
+    Workload::Handle h =
+        processes.add(arrivalTime, numBursts, ceil(1 / lambda));
     for (unsigned int j = 0; j < numBursts; ++j) {
-      cpuBurstTimes[j] = ceilNextExp(lambda, maxval);
+      cpuBurstTime = ceilNextExp(rng, lambda, maxval);
+      ioBurstTime = 0;
       if (j + 1 != numBursts) {
-        ioBurstTimes[j] = 10 * ceilNextExp(lambda, maxval);
+        ioBurstTime = 10 * ceilNextExp(rng, lambda, maxval);
       }
+      processes.setBurst(h, j, cpuBurstTime, ioBurstTime);
     }
-    processes.push_back(Process(arrivalTime, cpuBurstTimes, ioBurstTimes,
-                                ceil(1 / lambda), alpha));
   }
   return processes;
 }
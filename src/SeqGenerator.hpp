@@ -13,7 +13,10 @@
 #ifndef SEQGENERATOR_HPP
 #define SEQGENERATOR_HPP
 
-#include "Process.hpp"
+#include "Philox.hpp"
+#include "ProcessSource.hpp"
+#include "Rand48.hpp"
+#include "Workload.hpp"
 #include <fcntl.h>
 #include <limits>
 #include <math.h>
@@ -27,16 +30,44 @@
 
 namespace SeqGenerator {
 
-inline double nextExp(double lambda);
-inline unsigned int randNumBursts();
-unsigned int floorNextExp(double lambda, double maxval);
-unsigned int ceilNextExp(double lambda, double maxval);
-std::vector<Process> generateProccesses(unsigned short n, double lambda,
-                                        double maxval, long int seedval,
-                                        double alpha);
-std::vector<Process> parseProcesses(std::string fname, double lambda,
-                                    unsigned int tcs, double alpha,
-                                    unsigned int tslice);
+/* DRAND48 reproduces the original srand48()/drand48() workloads exactly: one
+ * sequential stream, so process i depends on every draw made for processes
+ * 0..i-1. PHILOX keys every draw by (seed, process, burst, what is drawn)
+ * instead, so processes can be generated in parallel and any one of them on
+ * its own (see generateProcess()); the workloads differ from DRAND48's. */
+enum class RngMode { DRAND48, PHILOX };
+
+/* REJECTION is the original sampler: redraw until the rounded value is at most
+ * maxval. INVERSE_CDF maps one draw per value straight to the truncated
+ * distribution in batches (see ExpSampler.hpp): same distribution, different
+ * values. */
+enum class Sampler { REJECTION, INVERSE_CDF };
+
+// Rng is Rand48 or Philox::Stream
+template <class Rng> inline double nextExp(Rng &rng, double lambda);
+template <class Rng> inline unsigned int randNumBursts(Rng &rng);
+template <class Rng>
+unsigned int floorNextExp(Rng &rng, double lambda, double maxval);
+template <class Rng>
+unsigned int ceilNextExp(Rng &rng, double lambda, double maxval);
+Workload generateProccesses(unsigned int n, double lambda, double maxval,
+                                long int seedval, double alpha,
+                                RngMode mode = RngMode::DRAND48,
+                                Sampler sampler = Sampler::REJECTION,
+                                unsigned int numThreads = 1);
+// Process i of the PHILOX workload for seedval, with pid i
+void generateProcess(unsigned int i, double lambda, double maxval,
+                     long int seedval, ProcessSpec &spec,
+                     Sampler sampler = Sampler::REJECTION);
+// The indices of the n processes of the PHILOX workload for seedval, in
+// arrival order (arrival time, then pid); only their arrival times are drawn
+std::vector<unsigned int> arrivalOrder(unsigned int n, double lambda,
+                                       double maxval, long int seedval,
+                                       Sampler sampler = Sampler::REJECTION);
+Workload parseProcesses(std::string fname, double lambda, unsigned int tcs,
+                            double alpha, unsigned int tslice);
+// Writes workload in the format parseProcesses() reads
+void writeProcesses(const Workload &workload, std::string fname);
 } // namespace SeqGenerator
 
 #endif
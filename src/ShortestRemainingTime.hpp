@@ -8,102 +8,95 @@
  *    Mitesh Kumar  [ kumarm4 ]
  *
  *  Brief:
- *    Implementation of Shortest Remaining Time (SRT) scheduling algorithm that
- * can be converted to Shortest Job First (SJF) by passing sjf=true to the
- * constructor.
+ *    Scheduler policies for Shortest Remaining Time (SRT) and Shortest Job
+ * First (SJF) scheduling, see Policy.hpp. SJF never preempts; SRT preempts the
+ * running process as soon as a ready process is expected to finish sooner.
  *
- *    run() runs the simulation and outputs important events to terminal in
- * chronological order
+ *    The ready queue is an IndexedHeap ordered by expected remaining burst time
+ * (tau minus elapsed time of the current burst), ties broken by pid, so pushes
+ * and pops are O(log n) however many processes are waiting.
  *
- *    printInfo() can be called successfully after run() has
- * completed and will print the final calculated statistics of the run to a
- * output stream.
- *
- *    reset() resets the object for a future run and resets the
- * internal processes to their initial state.
+ *    Sjf and Srt are the Scheduler instantiations used by main(); they are
+ * compiled once in ShortestRemainingTime.cpp.
  */
 
 #ifndef SHORTESTREMAININGTIME_HPP
 #define SHORTESTREMAININGTIME_HPP
 
-#include "Process.hpp"
-#include <algorithm>
-#include <deque>
-#include <exception>
-#include <functional>
-#include <iostream>
-#include <queue>
-#include <sstream>
-#include <stdexcept>
+#include "IndexedHeap.hpp"
+#include "Policy.hpp"
+#include "ProcessTable.hpp"
+#include "Scheduler.hpp"
+#include "Snapshot.hpp"
 #include <string>
-#include <utility>
 #include <vector>
 
-class ShortestRemainingTime {
+struct ExpectedRemainingOrder {
+  const ProcessTable *procs;
+  bool operator()(ProcessTable::Handle left, ProcessTable::Handle right) const {
+    signed long long lv = procs->getExpectedRemainingBurstTime(left);
+    signed long long rv = procs->getExpectedRemainingBurstTime(right);
+    return lv > rv ||
+           (lv == rv && procs->getPid(left) > procs->getPid(right));
+  }
+};
+
+template <bool Preemptive> class ShortestFirstPolicy {
 public:
-  ShortestRemainingTime(std::vector<Process> &processes, unsigned int tcs,
-                        bool sjf);
-  void printInfo(std::ostream &os) const;
-  void run();
-  void reset();
-  void printCsv(std::ostream &os) const;
+  typedef ProcessTable::Handle Handle;
 
-private:
-  typedef std::vector<Process>::iterator ProcessPtr;
-  typedef std::pair<unsigned int, ProcessPtr> ioQueueElem;
-  void printEvent(const std::string &detail, bool term) const;
-  bool isReadyQueueEmpty() const { return readyQueue.empty(); }
-  ProcessPtr peekFirstReady() const;
-  void popFirstReady();
-  void pushReady(ProcessPtr processPtr);
-  Process::State decrementBurstTimer();
-  void pushIo(ProcessPtr processPtr);
+  static constexpr bool timeSliced = false;
+  static constexpr bool preemptive = Preemptive;
+  static constexpr bool checksQueueFront = Preemptive;
+  static constexpr bool clocked = false;
+  static constexpr bool showTau = true;
+  static constexpr bool alwaysShowRemaining = Preemptive;
+  static constexpr bool exclusiveCutoff = false;
+
+  explicit ShortestFirstPolicy(const ProcessTable &procs)
+      : procs(&procs),
+        readyQueue(ExpectedRemainingOrder{&procs}, procs.size()) {}
 
-  double calcAvgWaitTime() const;
-  double calcAvgTurnaroundTime() const;
-  double calcAvgCpuBurstTime() const;
-  unsigned long long calcTotalNumCtxSwitches() const;
-  unsigned long long calcTotalNumPreemptions() const;
-  double calcCpuUtilization() const {
-    return 100.0 * (double)cpuUsageTime / timestamp;
+  static const char *name() { return Preemptive ? "SRT" : "SJF"; }
+  std::string describe() const { return name(); }
+  bool shouldPreempt(Handle running, Handle candidate) const {
+    return procs->getExpectedRemainingBurstTime(candidate) <
+           procs->getExpectedRemainingBurstTime(running);
   }
-  void resetTcsRemaining();
-  void checkRep() const;
-  void decrementTcs();
-  void preemptRunningProc();
-  inline bool burstTimerElapsed() const { return burstRemaining == 0; }
-  std::string fmtProc(const ProcessPtr &p) const;
-  std::string fmtRecalcTau(const ShortestRemainingTime::ProcessPtr &p) const;
 
-  // Independent
-  static const std::function<bool(const ProcessPtr &, const ProcessPtr &)>
-      processArrivalComparator;
-  static const std::function<bool(const ioQueueElem &, const ioQueueElem &)>
-      processIoComparator;
-  static const std::function<bool(const ProcessPtr &, const ProcessPtr &)>
-      readyQueueComparator;
-  std::deque<ProcessPtr> readyQueue;
-  unsigned int latestProcessIdx = 0;
-  unsigned int timestamp = 0;
-  unsigned int burstRemaining = 0;
-  unsigned int tcsRemaining = 0;
+  bool empty() const { return readyQueue.empty(); }
+  Handle front() const { return readyQueue.top(); }
+  void popFront() { readyQueue.pop(); }
+  void push(Handle h, ReadyReason) { readyQueue.push(h); }
+  template <class F> void forEachQueued(F f) const {
+    // The heap only keeps the front in place; sort a copy for display.
+    for (Handle h : readyQueue.sorted()) {
+      f(h);
+    }
+  }
+  // The order is the table's, so only the queued handles are saved
+  void saveState(SnapshotWriter &out) const {
+    out.putArray(readyQueue.sorted());
+  }
+  void loadState(SnapshotReader &in, unsigned int numHandles) {
+    std::vector<Handle> handles;
+    in.getIndices(handles, numHandles);
+    for (Handle h : handles) {
+      readyQueue.push(h);
+    }
+  }
 
-  unsigned int cpuUsageTime = 0;
+private:
+  const ProcessTable *procs;
+  IndexedHeap<ExpectedRemainingOrder> readyQueue;
+};
 
-  // Default
-  std::priority_queue<ioQueueElem, std::vector<ioQueueElem>,
-                      decltype(processIoComparator)>
-      ioQueue;
-  const unsigned int tcs;
-  const unsigned int numProcs;
-  ProcessPtr runningProc;
-  ProcessPtr switchingOutProc;
-  ProcessPtr switchingInProc;
-  const ProcessPtr nullProc;
-  const bool sjf;
+typedef ShortestFirstPolicy<false> SjfPolicy;
+typedef ShortestFirstPolicy<true> SrtPolicy;
+typedef Scheduler<SjfPolicy> Sjf;
+typedef Scheduler<SrtPolicy> Srt;
 
-  // Non-Default
-  std::vector<ProcessPtr> orderedProcesses;
-};
+extern template class Scheduler<SjfPolicy>;
+extern template class Scheduler<SrtPolicy>;
 
 #endif
@@ -0,0 +1,24 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - SmpScheduler.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ */
+
+#include "SmpScheduler.hpp"
+
+template class SmpScheduler<FcfsPolicy>;
+template class SmpScheduler<RoundRobinPolicy<true>>;
+template class SmpScheduler<RoundRobinPolicy<false>>;
+template class SmpScheduler<SjfPolicy>;
+template class SmpScheduler<SrtPolicy>;
+template class SmpScheduler<CfsPolicy>;
+template class SmpScheduler<MlfqPolicy>;
+template class SmpScheduler<PluginPolicy<false, false>>;
+template class SmpScheduler<PluginPolicy<false, true>>;
+template class SmpScheduler<PluginPolicy<true, false>>;
+template class SmpScheduler<PluginPolicy<true, true>>;
@@ -0,0 +1,1028 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - SmpScheduler.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Multi-CPU version of Scheduler for any of its policies. Every CPU has
+ * its own running, switching in and switching out process and its own
+ * context switch and time slice timers; the processes share one ProcessTable.
+ * The ready queue is either one Policy instance shared by all CPUs (GLOBAL)
+ * or one per CPU (PER_CPU), and so is the I/O queue. With per-CPU queues, a
+ * process that becomes ready goes back to the queue of the CPU it last ran
+ * on, or to the least loaded CPU's queue if it never ran, and the queues are
+ * kept balanced by either:
+ *
+ *    STEAL: a CPU with nothing to run or queued takes the front of the
+ * longest other queue, except the one process an idle CPU is about to take
+ * from its own queue.
+ *    PERIODIC: every balanceInterval ms, fronts move from the longest to the
+ * shortest queue until their lengths differ by at most one.
+ *
+ *    A process that starts running on another CPU than the one it last ran
+ * on pays migrationPenalty ms on top of the usual tcs / 2.
+ *
+ *    The event loop follows Scheduler's phases, with phases A to D run for
+ * every CPU in order. A process becoming ready only preempts a CPU its queue
+ * feeds: with per-CPU queues, the CPU of the queue; with a global queue,
+ * the CPU running the process the policy ranks last, and only when no idle
+ * or switching out CPU would pick up the queue's processes anyway. Queues
+ * are balanced just before phase G. With one CPU and a GLOBAL queue every
+ * decision is the same as Scheduler's, so the statistics match its.
+ *
+ *    With per-CPU queues and numThreads set, run() splits the CPUs over that
+ * many threads. Between arrivals, periodic balancing and possible steals, a
+ * CPU only touches its own queues and the processes in them, so each thread
+ * advances its CPUs on their own up to the next tick where one of those may
+ * happen, and that tick runs on all CPUs at once as usual. When a steal may
+ * happen is bounded conservatively from the lookahead every cross-CPU move
+ * has: a process that stops running takes at least max(tcs / 2, 1) ms to
+ * switch out before it lands in any queue, and a CPU takes at least twice
+ * that plus 1 ms to get through each process queued on it. Terminations are
+ * applied at the end of the stretch in (time, CPU) order and the burst
+ * histograms are updated under a lock, so the results are exactly those of
+ * the single-threaded run, whatever the number of threads.
+ *
+ *    No events are logged, but with setEventHash() every event Scheduler
+ * would log is hashed, from every CPU in the order they happen, along with
+ * the state after the event ticks the hash asks for. With one CPU and a
+ * GLOBAL queue the events, states and so hashes are the same as Scheduler's.
+ * A hashed run ignores numThreads, so the events keep their order, and a hash
+ * recording a range of events stops run() once it has them all. printInfo()
+ * prints Scheduler's statistics for the whole machine (utilization is busy
+ * time over numCpus times the elapsed time), the number of migrations, and a
+ * line per CPU. getNumEventTicks() counts ticks run on all CPUs plus, with
+ * threads, every CPU's own ticks.
+ */
+
+#ifndef SMPSCHEDULER_HPP
+#define SMPSCHEDULER_HPP
+
+#include "CompletelyFair.hpp"
+#include "EventHash.hpp"
+#include "Invariants.hpp"
+#include "MultilevelFeedback.hpp"
+#include "PluginPolicy.hpp"
+#include "Policy.hpp"
+#include "ProcessTable.hpp"
+#include "RoundRobin.hpp"
+#include "ShortestRemainingTime.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+struct SmpConfig {
+  enum class Queues : char { GLOBAL, PER_CPU };
+  enum class Balance : char { STEAL, PERIODIC };
+
+  unsigned int numCpus = 1;
+  Queues queues = Queues::GLOBAL;
+  Balance balance = Balance::STEAL;
+  unsigned int balanceInterval = 100;
+  unsigned int migrationPenalty = 0;
+  // Threads to run PER_CPU machines on; 0 runs everything on the caller
+  unsigned int numThreads = 0;
+};
+
+template <class Policy> class SmpScheduler {
+public:
+  SmpScheduler(ProcessTable &procs, unsigned int tcs, const Policy &policy,
+               const SmpConfig &config);
+  void setEventHash(EventHash *hash) { this->hash = hash; }
+  // False if the hash's detail range ended the run early
+  bool run();
+  void printInfo(std::ostream &os, bool showPercentiles = false) const;
+  unsigned int getElapsedTime() const { return timestamp; }
+  unsigned long long getNumEventTicks() const { return numEventTicks; }
+
+private:
+  typedef ProcessTable::Handle ProcessHandle;
+  typedef std::pair<unsigned int, ProcessHandle> ioQueueElem;
+  static constexpr ProcessHandle nullProc = Process::NONE;
+  static constexpr unsigned int NO_CPU = std::numeric_limits<unsigned>::max();
+  static constexpr unsigned int NEVER = std::numeric_limits<unsigned>::max();
+
+  struct IoOrder {
+    const ProcessTable *procs;
+    bool operator()(const ioQueueElem &a, const ioQueueElem &b) const {
+      return a.first > b.first ||
+             (a.first == b.first &&
+              procs->getPid(a.second) > procs->getPid(b.second));
+    }
+  };
+
+  typedef std::priority_queue<ioQueueElem, std::vector<ioQueueElem>, IoOrder>
+      IoQueue;
+
+  // Cache line aligned, as each thread updates its own CPUs
+  struct alignas(64) Cpu {
+    ProcessHandle runningProc = nullProc;
+    ProcessHandle switchingInProc = nullProc;
+    ProcessHandle switchingOutProc = nullProc;
+    unsigned int tcsRemaining = 0;
+    unsigned int burstRemaining = 0;
+    unsigned long long busyTime = 0;
+    unsigned long long numCtxSwitches = 0;
+    unsigned long long numPreempts = 0;
+    unsigned long long numMigrations = 0;
+
+    // Left by runCpuTicks() for runStretch()
+    std::vector<std::pair<unsigned int, ProcessHandle>> terminations;
+    unsigned int lastTick = 0;
+    unsigned long long numTicks = 0;
+  };
+
+  unsigned int queueOf(unsigned int c) const {
+    return config.queues == SmpConfig::Queues::GLOBAL ? 0 : c;
+  }
+  // Nothing running or about to run; it dispatches once tcsRemaining is 0
+  bool isFree(const Cpu &cpu) const {
+    return cpu.runningProc == nullProc && cpu.switchingInProc == nullProc;
+  }
+  bool isIdle(const Cpu &cpu) const {
+    return isFree(cpu) && cpu.switchingOutProc == nullProc &&
+           !cpu.tcsRemaining;
+  }
+  void push(unsigned int q, ProcessHandle h, ReadyReason reason) {
+    queues[q].push(h, reason);
+    ++queueLengths[q];
+  }
+  ProcessHandle popFront(unsigned int q);
+  // Hashes e, made as Scheduler's makeEvent() does, if there is a hash
+  void hashEvent(Event::Type type, unsigned int t, ProcessHandle p,
+                 unsigned int value = 0, ProcessHandle other = nullProc) {
+    Event e{type, t, p};
+    e.tau = p == nullProc ? 0 : procs.getTau(p);
+    e.value = value;
+    e.other = other;
+    hash->addEvent(e, procs);
+  }
+  std::uint64_t stateHash() const;
+
+  void finishSwitchOut(unsigned int c, unsigned int t); // A
+  void runCpu(unsigned int c, unsigned int t);          // B
+  void finishSwitchIn(unsigned int c, unsigned int t);  // C
+  void checkPreemption(unsigned int c, unsigned int t); // D
+  void completeIo(unsigned int q, unsigned int t);      // E
+  void admitArrivals();                                 // F
+  void balance();
+  void dispatch(unsigned int c, unsigned int t); // G
+  bool isFinished() const;
+  void runTick();
+
+  void makeReady(ProcessHandle h, ReadyReason reason, unsigned int t);
+  unsigned int preemptionTarget(unsigned int q) const;
+  unsigned int leastLoadedCpu() const;
+  // The CPU whose queue h goes to: where it last ran, else the least loaded
+  unsigned int homeCpu(ProcessHandle h) const {
+    return lastCpus[h] == NO_CPU ? leastLoadedCpu() : lastCpus[h];
+  }
+  void preemptRunningProc(unsigned int c);
+  void resetBurstTimer(unsigned int c);
+  // The next tick of c's own events after t, NEVER if none
+  unsigned int nextCpuEventTime(unsigned int c, unsigned int t) const;
+  unsigned int nextEventTime() const;
+  void skipCpuTicks(unsigned int c, unsigned int numTicks);
+  void skipQuietTicks(unsigned int numTicks);
+  void checkRep() const;
+
+  unsigned int stretchEnd() const;
+  unsigned int stealHorizon() const;
+  void runCpuTicks(unsigned int c, unsigned int end);
+  void runStretch(unsigned int end);
+
+  ProcessTable &procs;
+  const unsigned int tcs;
+  const SmpConfig config;
+  std::vector<Cpu> cpus;
+  std::vector<Policy> queues;
+  std::vector<unsigned int> queueLengths;
+  // The CPU each handle last ran on, NO_CPU if it hasn't run yet
+  std::vector<unsigned int> lastCpus;
+  // Indexed like queues: the queue of the CPU a process switched out of
+  std::vector<IoQueue> ioQueues;
+  unsigned int timestamp = 0;
+  unsigned long long numEventTicks = 0;
+  EventHash *hash = nullptr;
+
+  std::unique_ptr<ThreadPool> pool;
+  // Set while threads run CPUs on their own
+  bool inStretch = false;
+  std::mutex burstLock;
+};
+
+template <class Policy>
+SmpScheduler<Policy>::SmpScheduler(ProcessTable &procs, unsigned int tcs,
+                                   const Policy &policy,
+                                   const SmpConfig &config)
+    : procs(procs), tcs(tcs), config(config), cpus(config.numCpus),
+      queues(config.queues == SmpConfig::Queues::GLOBAL ? 1 : config.numCpus,
+             policy),
+      queueLengths(queues.size(), 0),
+      ioQueues(queues.size(), IoQueue(IoOrder{&procs})) {
+  if (!config.numCpus) {
+    throw std::runtime_error("Error: SmpScheduler needs at least one CPU.");
+  }
+  if (config.balance == SmpConfig::Balance::PERIODIC &&
+      !config.balanceInterval) {
+    throw std::runtime_error(
+        "Error: SmpScheduler balance interval must be at least 1ms.");
+  }
+}
+
+template <class Policy> bool SmpScheduler<Policy>::isFinished() const {
+  for (const Cpu &cpu : cpus) {
+    if (!isFree(cpu) || cpu.switchingOutProc != nullProc) {
+      return false;
+    }
+  }
+  for (unsigned int q = 0; q < queues.size(); ++q) {
+    if (queueLengths[q] || !ioQueues[q].empty()) {
+      return false;
+    }
+  }
+  return !procs.hasPendingArrival();
+}
+
+template <class Policy>
+typename SmpScheduler<Policy>::ProcessHandle
+SmpScheduler<Policy>::popFront(unsigned int q) {
+  if (Invariants::checked && !queueLengths[q]) {
+    throw std::runtime_error(
+        "Error: Attempted to pop first from an empty ready queue.");
+  }
+  const ProcessHandle h = queues[q].front();
+  queues[q].popFront();
+  --queueLengths[q];
+  return h;
+}
+
+template <class Policy> void SmpScheduler<Policy>::checkRep() const {
+  if (!Invariants::checked) {
+    return;
+  }
+  for (const Cpu &cpu : cpus) {
+    if ((cpu.runningProc != nullProc) + (cpu.switchingInProc != nullProc) +
+            (cpu.switchingOutProc != nullProc) >
+        1) {
+      throw std::runtime_error(
+          "Error: a CPU has more than one running or switching process.");
+    }
+    if (cpu.tcsRemaining && cpu.switchingInProc == nullProc &&
+        cpu.switchingOutProc == nullProc) {
+      throw std::runtime_error(
+          "Error: no switchingInProc or switchingOutProc while tcsRemaining.");
+    }
+  }
+}
+
+/* Scheduler::stateHash() with every CPU's timers and processes, then every
+ * queue's ready and I/O processes, so one CPU hashes the same as Scheduler. */
+template <class Policy>
+std::uint64_t SmpScheduler<Policy>::stateHash() const {
+  auto pid = [this](ProcessHandle h) -> std::uint64_t {
+    return h == nullProc ? UINT32_MAX : procs.getPid(h);
+  };
+  std::uint64_t h = timestamp;
+  for (unsigned int c = 0; c < cpus.size(); ++c) {
+    const Cpu &cpu = cpus[c];
+    h = EventHash::mix(h, cpu.burstRemaining);
+    h = EventHash::mix(h, (std::uint64_t)cpu.tcsRemaining << 32 |
+                              queueLengths[queueOf(c)]);
+    h = EventHash::mix(h, pid(cpu.runningProc) << 32 |
+                              pid(cpu.switchingInProc));
+    h = EventHash::mix(h, pid(cpu.switchingOutProc));
+  }
+  for (unsigned int q = 0; q < queues.size(); ++q) {
+    queues[q].forEachQueued(
+        [&h, &pid](ProcessHandle p) { h = EventHash::mix(h, pid(p)); });
+    for (IoQueue io = ioQueues[q]; !io.empty(); io.pop()) {
+      h = EventHash::mix(h, (std::uint64_t)io.top().first << 32 |
+                                pid(io.top().second));
+    }
+  }
+  std::uint64_t live = 0;
+  for (ProcessHandle p = 0; p < procs.size(); ++p) {
+    const Process::State state = procs.getState(p);
+    if (state == Process::State::UNARRIVED ||
+        state == Process::State::TERMINATED) {
+      continue;
+    }
+    const std::uint64_t ph = EventHash::mix(pid(p) << 8 | (unsigned)state,
+                                            procs.getBurstsRemaining(p));
+    live += EventHash::mix(ph, procs.getRemainingBurstTime(p));
+  }
+  return EventHash::mix(h, live);
+}
+
+template <class Policy>
+void SmpScheduler<Policy>::preemptRunningProc(unsigned int c) {
+  Cpu &cpu = cpus[c];
+  if (Invariants::checked &&
+      (cpu.runningProc == nullProc ||
+       procs.getState(cpu.runningProc) != Process::State::RUNNING)) {
+    throw std::runtime_error(
+        "Error: preemptRunningProc() called without a RUNNING process.");
+  }
+  procs.preempt(cpu.runningProc);
+  ++cpu.numPreempts;
+  cpu.tcsRemaining = tcs / 2;
+  cpu.switchingOutProc = cpu.runningProc;
+  cpu.runningProc = nullProc;
+}
+
+template <class Policy>
+void SmpScheduler<Policy>::resetBurstTimer(unsigned int c) {
+  if constexpr (Policy::timeSliced) {
+    cpus[c].burstRemaining =
+        queues[queueOf(c)].timeSlice(cpus[c].runningProc);
+  }
+}
+
+template <class Policy>
+unsigned int SmpScheduler<Policy>::nextCpuEventTime(unsigned int c,
+                                                    unsigned int t) const {
+  const Cpu &cpu = cpus[c];
+  unsigned int next = NEVER;
+  if (cpu.switchingOutProc != nullProc || cpu.switchingInProc != nullProc) {
+    next = t + std::max(cpu.tcsRemaining, 1u);
+  }
+  if (cpu.runningProc == nullProc) {
+    return next;
+  }
+  if constexpr (Policy::preemptive && Policy::checksQueueFront) {
+    // As in Scheduler, phase D only newly fires after a queue changes
+    const unsigned int q = queueOf(c);
+    if (queueLengths[q] && preemptionTarget(q) == c &&
+        queues[q].shouldPreempt(cpu.runningProc, queues[q].front())) {
+      return t + 1;
+    }
+  }
+  if constexpr (Policy::timeSliced) {
+    next = std::min(next, t + std::max(cpu.burstRemaining, 1u));
+  }
+  return std::min(next, t + procs.getRemainingBurstTime(cpu.runningProc));
+}
+
+template <class Policy>
+unsigned int SmpScheduler<Policy>::nextEventTime() const {
+  unsigned int next = NEVER;
+  for (unsigned int c = 0; c < cpus.size(); ++c) {
+    next = std::min(next, nextCpuEventTime(c, timestamp));
+  }
+  for (const IoQueue &ioQueue : ioQueues) {
+    if (!ioQueue.empty()) {
+      next = std::min(next, ioQueue.top().first);
+    }
+  }
+  if (procs.hasPendingArrival()) {
+    next = std::min(next, procs.nextArrivalTime());
+  }
+  if (config.queues == SmpConfig::Queues::PER_CPU &&
+      config.balance == SmpConfig::Balance::PERIODIC && cpus.size() > 1) {
+    // Queue lengths only change in event ticks, so a balancing tick only has
+    // anything to do if they are already apart
+    const auto minmax =
+        std::minmax_element(queueLengths.begin(), queueLengths.end());
+    if (*minmax.second - *minmax.first > 1) {
+      next = std::min(next, (timestamp / config.balanceInterval + 1) *
+                                config.balanceInterval);
+    }
+  }
+  if (next == NEVER) {
+    return timestamp + 1;
+  }
+  return std::max(next, timestamp + 1);
+}
+
+template <class Policy>
+void SmpScheduler<Policy>::skipCpuTicks(unsigned int c,
+                                        unsigned int numTicks) {
+  Cpu &cpu = cpus[c];
+  if (!numTicks) {
+    return;
+  }
+  if (cpu.tcsRemaining) {
+    if (Invariants::checked && cpu.tcsRemaining <= numTicks) {
+      throw std::runtime_error(
+          "Error: skipCpuTicks() would skip a context switch completion.");
+    }
+    cpu.tcsRemaining -= numTicks;
+  }
+  if (cpu.runningProc != nullProc) {
+    if constexpr (Policy::timeSliced) {
+      if (Invariants::checked && cpu.burstRemaining <= numTicks) {
+        throw std::runtime_error(
+            "Error: skipCpuTicks() would skip a time slice expiry.");
+      }
+      cpu.burstRemaining -= numTicks;
+    }
+    cpu.busyTime += numTicks;
+    procs.advanceBurst(cpu.runningProc, numTicks);
+  }
+}
+
+template <class Policy>
+void SmpScheduler<Policy>::skipQuietTicks(unsigned int numTicks) {
+  for (unsigned int c = 0; c < cpus.size(); ++c) {
+    skipCpuTicks(c, numTicks);
+  }
+  timestamp += numTicks;
+}
+
+template <class Policy>
+void SmpScheduler<Policy>::finishSwitchOut(unsigned int c, unsigned int t) {
+  Cpu &cpu = cpus[c];
+  if (cpu.tcsRemaining || cpu.switchingOutProc == nullProc) {
+    return;
+  }
+  const ProcessHandle h = cpu.switchingOutProc;
+  switch (procs.getState(h)) {
+  case Process::State::SW_WAIT:
+    if (inStretch) {
+      // Adds to the table's burst histograms
+      std::lock_guard<std::mutex> guard(burstLock);
+      procs.nextState(h, t);
+    } else {
+      procs.nextState(h, t);
+    }
+    ioQueues[queueOf(c)].push({procs.getCurrIoBurstTime(h) + t, h});
+    break;
+  case Process::State::SW_TERM:
+    if (inStretch) {
+      // May release h's slot, which has to happen in the same order as
+      // without threads
+      cpu.terminations.push_back({t, h});
+    } else {
+      procs.nextState(h, t);
+    }
+    break;
+  case Process::State::SW_READY:
+    procs.nextState(h, t);
+    push(queueOf(c), h, ReadyReason::PREEMPTED);
+    break;
+  default:
+    throw std::runtime_error("Error: switching out process was not in "
+                             "SW_WAIT, SW_READY, or SW_TERM state.");
+  }
+  cpu.switchingOutProc = nullProc;
+}
+
+template <class Policy>
+void SmpScheduler<Policy>::runCpu(unsigned int c, unsigned int t) {
+  Cpu &cpu = cpus[c];
+  const ProcessHandle h = cpu.runningProc;
+  if (h == nullProc) {
+    return;
+  }
+  ++cpu.busyTime;
+  if constexpr (Policy::timeSliced) {
+    --cpu.burstRemaining;
+  }
+  // The completion reports the estimate the burst was scheduled with
+  const unsigned int tau = procs.getTau(h);
+  const Process::State currState = procs.decrementBurst(h);
+  if (currState == Process::State::RUNNING) {
+    if constexpr (Policy::timeSliced) {
+      if (cpu.burstRemaining == 0) {
+        if (queueLengths[queueOf(c)]) {
+          if (hash) {
+            hashEvent(Event::Type::SLICE_EXPIRED, t, h,
+                      procs.getRemainingBurstTime(h));
+          }
+          preemptRunningProc(c);
+        } else {
+          if (hash) {
+            hashEvent(Event::Type::SLICE_EXPIRED_NO_PREEMPTION, t, nullProc);
+          }
+          resetBurstTimer(c);
+        }
+      }
+    }
+  } else if (currState == Process::State::SW_WAIT ||
+             currState == Process::State::SW_TERM) {
+    cpu.tcsRemaining = tcs / 2;
+    cpu.switchingOutProc = h;
+    cpu.runningProc = nullProc;
+    if (hash && currState == Process::State::SW_WAIT) {
+      Event completed{Event::Type::BURST_COMPLETED, t, h};
+      completed.tau = tau;
+      completed.value = procs.getBurstsRemaining(h);
+      hash->addEvent(completed, procs);
+      if (Policy::showTau) {
+        hashEvent(Event::Type::TAU_RECALCULATED, t, h);
+      }
+      hashEvent(Event::Type::SWITCHING_TO_IO, t, h,
+                procs.getCurrIoBurstTime(h) + t + cpu.tcsRemaining);
+    } else if (hash) {
+      hashEvent(Event::Type::TERMINATED, t, h);
+    }
+  } else {
+    throw std::runtime_error(
+        "Error: runningProc wasn't in RUNNING, SW_WAIT, or SW_TERM stage "
+        "after decrementBurst");
+  }
+}
+
+template <class Policy>
+void SmpScheduler<Policy>::finishSwitchIn(unsigned int c, unsigned int t) {
+  Cpu &cpu = cpus[c];
+  if (cpu.tcsRemaining || cpu.switchingInProc == nullProc) {
+    return;
+  }
+  if (hash) {
+    hashEvent(!Policy::alwaysShowRemaining &&
+                      procs.isStartOfBurst(cpu.switchingInProc)
+                  ? Event::Type::STARTED_BURST
+                  : Event::Type::RESUMED_BURST,
+              t, cpu.switchingInProc,
+              procs.getRemainingBurstTime(cpu.switchingInProc));
+  }
+  procs.nextState(cpu.switchingInProc, t);
+  if (Invariants::checked &&
+      procs.getState(cpu.switchingInProc) != Process::State::RUNNING) {
+    throw std::runtime_error(
+        "Error: SW_IN process did not switch to RUNNING state.");
+  }
+  ++cpu.numCtxSwitches;
+  cpu.runningProc = cpu.switchingInProc;
+  cpu.switchingInProc = nullProc;
+  resetBurstTimer(c);
+}
+
+/* The CPU a process in queue q may preempt, NO_CPU if none. With a global
+ * queue, that's the CPU running the process the policy ranks last, and none
+ * while a free CPU is going to take a queued process anyway. */
+template <class Policy>
+unsigned int SmpScheduler<Policy>::preemptionTarget(unsigned int q) const {
+  if (config.queues == SmpConfig::Queues::PER_CPU) {
+    return q;
+  }
+  unsigned int numFree = 0;
+  unsigned int target = NO_CPU;
+  if constexpr (Policy::preemptive) {
+    for (unsigned int c = 0; c < cpus.size(); ++c) {
+      const Cpu &cpu = cpus[c];
+      if (isFree(cpu)) {
+        ++numFree;
+      } else if (cpu.runningProc != nullProc &&
+                 (target == NO_CPU ||
+                  queues[q].shouldPreempt(cpu.runningProc,
+                                          cpus[target].runningProc))) {
+        target = c;
+      }
+    }
+  }
+  return queueLengths[q] > numFree ? target : NO_CPU;
+}
+
+template <class Policy>
+void SmpScheduler<Policy>::checkPreemption(unsigned int c, unsigned int t) {
+  if constexpr (Policy::preemptive && Policy::checksQueueFront) {
+    Cpu &cpu = cpus[c];
+    const unsigned int q = queueOf(c);
+    if (cpu.runningProc == nullProc || !queueLengths[q]) {
+      return;
+    }
+    if (preemptionTarget(q) == c &&
+        queues[q].shouldPreempt(cpu.runningProc, queues[q].front())) {
+      if (hash) {
+        hashEvent(Event::Type::WILL_PREEMPT, t, queues[q].front(), 0,
+                  cpu.runningProc);
+      }
+      preemptRunningProc(c);
+    }
+  }
+}
+
+template <class Policy>
+unsigned int SmpScheduler<Policy>::leastLoadedCpu() const {
+  unsigned int best = 0;
+  unsigned int bestLoad = std::numeric_limits<unsigned int>::max();
+  for (unsigned int c = 0; c < cpus.size(); ++c) {
+    const unsigned int load = queueLengths[queueOf(c)] + !isFree(cpus[c]);
+    if (load < bestLoad) {
+      best = c;
+      bestLoad = load;
+    }
+  }
+  return best;
+}
+
+/* Queues h and lets it preempt the CPU that queue feeds, like Scheduler's
+ * phases E and F. */
+template <class Policy>
+void SmpScheduler<Policy>::makeReady(ProcessHandle h, ReadyReason reason,
+                                     unsigned int t) {
+  const unsigned int q =
+      config.queues == SmpConfig::Queues::GLOBAL ? 0 : homeCpu(h);
+  push(q, h, reason);
+  const bool arrived = reason == ReadyReason::ARRIVED;
+  if constexpr (Policy::preemptive) {
+    const unsigned int c = preemptionTarget(q);
+    if (c != NO_CPU && cpus[c].runningProc != nullProc &&
+        queues[q].shouldPreempt(cpus[c].runningProc, h)) {
+      preemptRunningProc(c);
+      if (hash) {
+        hashEvent(arrived ? Event::Type::ARRIVED_PREEMPTING
+                          : Event::Type::IO_COMPLETED_PREEMPTING,
+                  t, h, 0, cpus[c].switchingOutProc);
+      }
+      return;
+    }
+  }
+  if (hash) {
+    hashEvent(arrived ? Event::Type::ARRIVED : Event::Type::IO_COMPLETED, t,
+              h);
+  }
+}
+
+/* The processes in I/O queue q all go back to ready queue q, so the I/O
+ * queues are independent of each other. */
+template <class Policy>
+void SmpScheduler<Policy>::completeIo(unsigned int q, unsigned int t) {
+  IoQueue &ioQueue = ioQueues[q];
+  while (!ioQueue.empty() && ioQueue.top().first <= t) {
+    const ProcessHandle h = ioQueue.top().second;
+    ioQueue.pop();
+    procs.nextState(h, t);
+    makeReady(h, ReadyReason::IO_COMPLETED, t);
+  }
+}
+
+template <class Policy> void SmpScheduler<Policy>::admitArrivals() {
+  while (procs.hasPendingArrival() && procs.nextArrivalTime() <= timestamp) {
+    const ProcessHandle h = procs.admitNext();
+    if (h >= lastCpus.size()) {
+      lastCpus.resize(h + 1, NO_CPU);
+    }
+    // A streaming table reuses the handles of terminated processes
+    lastCpus[h] = NO_CPU;
+    procs.nextState(h, timestamp);
+    makeReady(h, ReadyReason::ARRIVED, timestamp);
+  }
+}
+
+template <class Policy> void SmpScheduler<Policy>::balance() {
+  if (config.queues == SmpConfig::Queues::GLOBAL || cpus.size() == 1) {
+    return;
+  }
+  if (config.balance == SmpConfig::Balance::STEAL) {
+    for (unsigned int c = 0; c < cpus.size(); ++c) {
+      if (!isIdle(cpus[c]) || queueLengths[c]) {
+        continue;
+      }
+      // A queue whose own CPU is idle keeps its front for that CPU
+      unsigned int victim = NO_CPU;
+      unsigned int victimSpare = 0;
+      for (unsigned int v = 0; v < cpus.size(); ++v) {
+        const unsigned int spare = queueLengths[v] - (queueLengths[v] &&
+                                                      isIdle(cpus[v]));
+        if (spare > victimSpare) {
+          victim = v;
+          victimSpare = spare;
+        }
+      }
+      if (victim != NO_CPU) {
+        push(c, popFront(victim), ReadyReason::MIGRATED);
+      }
+    }
+    return;
+  }
+  if (timestamp % config.balanceInterval) {
+    return;
+  }
+  while (true) {
+    const auto minmax =
+        std::minmax_element(queueLengths.begin(), queueLengths.end());
+    if (*minmax.second - *minmax.first <= 1) {
+      break;
+    }
+    const unsigned int to = minmax.first - queueLengths.begin();
+    const unsigned int from = minmax.second - queueLengths.begin();
+    push(to, popFront(from), ReadyReason::MIGRATED);
+  }
+}
+
+template <class Policy>
+void SmpScheduler<Policy>::dispatch(unsigned int c, unsigned int t) {
+  Cpu &cpu = cpus[c];
+  const unsigned int q = queueOf(c);
+  if (!isIdle(cpu) || !queueLengths[q]) {
+    return;
+  }
+  const ProcessHandle h = popFront(q);
+  if (Invariants::checked && procs.getState(h) != Process::State::READY) {
+    throw std::runtime_error("Error: process that was pulled from ready "
+                             "queue was not in READY state.");
+  }
+  procs.nextState(h, t);
+  cpu.switchingInProc = h;
+  cpu.tcsRemaining = tcs / 2;
+  if (lastCpus[h] != NO_CPU && lastCpus[h] != c) {
+    ++cpu.numMigrations;
+    cpu.tcsRemaining += config.migrationPenalty;
+  }
+  lastCpus[h] = c;
+}
+
+/* One tick of every CPU at timestamp. */
+template <class Policy> void SmpScheduler<Policy>::runTick() {
+  if constexpr (Policy::clocked) {
+    for (Policy &queue : queues) {
+      queue.advanceClock(timestamp);
+    }
+  }
+  for (Cpu &cpu : cpus) {
+    if (cpu.tcsRemaining) {
+      --cpu.tcsRemaining;
+    }
+  }
+  for (unsigned int c = 0; c < cpus.size(); ++c) {
+    finishSwitchOut(c, timestamp); // A
+    runCpu(c, timestamp);          // B
+    finishSwitchIn(c, timestamp);  // C
+    checkPreemption(c, timestamp); // D
+  }
+  for (unsigned int q = 0; q < queues.size(); ++q) {
+    completeIo(q, timestamp); // E
+  }
+  admitArrivals(); // F
+  balance();
+  for (unsigned int c = 0; c < cpus.size(); ++c) {
+    dispatch(c, timestamp); // G
+  }
+}
+
+/* The earliest tick after timestamp that may take more than one CPU:
+ * an arrival, periodic balancing or a steal. */
+template <class Policy>
+unsigned int SmpScheduler<Policy>::stretchEnd() const {
+  unsigned int end = NEVER;
+  if (procs.hasPendingArrival()) {
+    end = procs.nextArrivalTime();
+  }
+  if (config.balance == SmpConfig::Balance::PERIODIC) {
+    // The queues may drift apart on their own before then
+    return std::min(end, (timestamp / config.balanceInterval + 1) *
+                             config.balanceInterval);
+  }
+  return std::min(end, stealHorizon());
+}
+
+/* A steal needs a CPU that is idle with an empty queue, a thief, and a queue
+ * with a process its own CPU won't take right away, a spare. Neither exists
+ * before the earliest tick a CPU may go idle with its queue drained, or a
+ * process may be pushed onto a queue. */
+template <class Policy>
+unsigned int SmpScheduler<Policy>::stealHorizon() const {
+  const unsigned long long lookahead = std::max(tcs / 2, 1u);
+  const unsigned long long now = timestamp;
+  bool hasThief = false;
+  bool hasSpare = false;
+  unsigned long long thiefTick = NEVER;
+  unsigned long long pushTick = NEVER;
+  for (unsigned int c = 0; c < cpus.size(); ++c) {
+    const Cpu &cpu = cpus[c];
+    const unsigned int length = queueLengths[c];
+    if (!ioQueues[c].empty()) {
+      pushTick = std::min<unsigned long long>(pushTick,
+                                              ioQueues[c].top().first);
+    }
+    if (isIdle(cpu)) {
+      hasThief = hasThief || !length;
+      hasSpare = hasSpare || length > 1;
+      continue;
+    }
+    hasSpare = hasSpare || length;
+    // When c next goes idle, and whether its own switch out refills it
+    unsigned long long idleTick = now + 1 + lookahead;
+    unsigned int refill = 0;
+    if (cpu.switchingOutProc != nullProc) {
+      idleTick = now + std::max(cpu.tcsRemaining, 1u);
+      refill = procs.getState(cpu.switchingOutProc) == Process::State::SW_READY;
+    }
+    // The switch out may push c's process back, or send it to I/O, and a
+    // running process may be preempted, which pushes it a switch out later
+    pushTick = std::min(pushTick, idleTick);
+    thiefTick = std::min(thiefTick,
+                         idleTick + (length + refill) * (2 * lookahead + 1));
+  }
+  const unsigned long long first =
+      std::max(hasThief ? now + 1 : thiefTick, hasSpare ? now + 1 : pushTick);
+  return std::min<unsigned long long>(first, NEVER);
+}
+
+/* Advances CPU c on its own from timestamp to end - 1, including its I/O
+ * queue. */
+template <class Policy>
+void SmpScheduler<Policy>::runCpuTicks(unsigned int c, unsigned int end) {
+  Cpu &cpu = cpus[c];
+  unsigned int t = timestamp;
+  while (true) {
+    unsigned int next = nextCpuEventTime(c, t);
+    if (!ioQueues[c].empty()) {
+      next = std::min(next, ioQueues[c].top().first);
+    }
+    if (next >= end) {
+      break;
+    }
+    skipCpuTicks(c, next - t - 1);
+    t = next;
+    ++cpu.numTicks;
+    if constexpr (Policy::clocked) {
+      queues[c].advanceClock(t);
+    }
+
+    if (cpu.tcsRemaining) {
+      --cpu.tcsRemaining;
+    }
+    finishSwitchOut(c, t); // A
+    runCpu(c, t);          // B
+    finishSwitchIn(c, t);  // C
+    checkPreemption(c, t); // D
+    completeIo(c, t);      // E
+    dispatch(c, t);        // G
+  }
+  cpu.lastTick = t;
+  if (end != NEVER) {
+    skipCpuTicks(c, end - 1 - t);
+  }
+}
+
+/* Runs every CPU on its own up to end - 1 on the pool, then leaves timestamp
+ * at end, or at the tick after the last event if that finished the run. */
+template <class Policy>
+void SmpScheduler<Policy>::runStretch(unsigned int end) {
+  const unsigned int numTasks =
+      std::min<unsigned int>(pool->size(), cpus.size());
+  inStretch = true;
+  for (unsigned int i = 0; i < numTasks; ++i) {
+    pool->submit([this, i, numTasks, end] {
+      for (unsigned int c = i * cpus.size() / numTasks;
+           c < (i + 1) * cpus.size() / numTasks; ++c) {
+        runCpuTicks(c, end);
+      }
+    });
+  }
+  try {
+    pool->wait();
+  } catch (...) {
+    inStretch = false;
+    throw;
+  }
+  inStretch = false;
+
+  std::vector<std::tuple<unsigned int, unsigned int, ProcessHandle>> terms;
+  unsigned int lastTick = timestamp;
+  for (unsigned int c = 0; c < cpus.size(); ++c) {
+    Cpu &cpu = cpus[c];
+    for (const auto &term : cpu.terminations) {
+      terms.emplace_back(term.first, c, term.second);
+    }
+    cpu.terminations.clear();
+    numEventTicks += cpu.numTicks;
+    cpu.numTicks = 0;
+    lastTick = std::max(lastTick, cpu.lastTick);
+  }
+  std::sort(terms.begin(), terms.end());
+  for (const auto &term : terms) {
+    procs.nextState(std::get<2>(term), std::get<0>(term));
+  }
+
+  if (isFinished()) {
+    timestamp = lastTick + 1;
+  } else if (end == NEVER) {
+    throw std::runtime_error(
+        "Error: CPUs ran out of events before the simulation finished.");
+  } else {
+    timestamp = end;
+  }
+}
+
+template <class Policy> bool SmpScheduler<Policy>::run() {
+  checkRep();
+  numEventTicks = 0;
+  if (config.numThreads && config.queues == SmpConfig::Queues::PER_CPU &&
+      cpus.size() > 1 && !hash) {
+    pool.reset(new ThreadPool(config.numThreads));
+  }
+  if (hash) {
+    hashEvent(Event::Type::SIM_STARTED, timestamp, nullProc);
+  }
+  while (true) {
+    checkRep();
+    if (isFinished()) {
+      break;
+    }
+    if (hash && hash->isDone()) {
+      return false;
+    }
+    ++numEventTicks;
+    runTick();
+    if (hash && hash->wantsCheckpoint()) {
+      hash->checkpoint(timestamp, stateHash());
+    }
+
+    const unsigned int next = nextEventTime();
+    if (pool) {
+      const unsigned int end = stretchEnd();
+      if (next < end) {
+        runStretch(end);
+        continue;
+      }
+    }
+    skipQuietTicks(next - timestamp - 1);
+    ++timestamp;
+  }
+  if (timestamp > 0) {
+    --timestamp;
+  }
+  pool.reset();
+  if (hash) {
+    hashEvent(Event::Type::SIM_ENDED, timestamp, nullProc);
+    hash->finish(timestamp, stateHash());
+  }
+  return true;
+}
+
+template <class Policy>
+void SmpScheduler<Policy>::printInfo(std::ostream &os,
+                                     bool showPercentiles) const {
+  const ProcessTable::Totals totals = procs.totals();
+  unsigned long long busyTime = 0;
+  unsigned long long numMigrations = 0;
+  for (const Cpu &cpu : cpus) {
+    busyTime += cpu.busyTime;
+    numMigrations += cpu.numMigrations;
+  }
+  os << "Algorithm " + std::string(queues[0].name()) << std::endl;
+
+  os.precision(3);
+  os << "-- average CPU burst time: " << std::fixed
+     << (double)totals.cpuBurstTime / totals.numBursts << " ms" << std::endl;
+  os << "-- average wait time: " << std::fixed
+     << (double)totals.waitTime / totals.numBursts << " ms" << std::endl;
+  if (showPercentiles) {
+    os << "-- wait time p50/p90/p99/max: "
+       << totals.waitTimeHist.percentile(50) << "/"
+       << totals.waitTimeHist.percentile(90) << "/"
+       << totals.waitTimeHist.percentile(99) << "/"
+       << totals.waitTimeHist.max() << " ms" << std::endl;
+  }
+  os << "-- average turnaround time: " << std::fixed
+     << (double)totals.turnaroundTime / totals.numBursts << " ms"
+     << std::endl;
+  if (showPercentiles) {
+    os << "-- turnaround time p50/p90/p99/max: "
+       << totals.turnaroundTimeHist.percentile(50) << "/"
+       << totals.turnaroundTimeHist.percentile(90) << "/"
+       << totals.turnaroundTimeHist.percentile(99) << "/"
+       << totals.turnaroundTimeHist.max() << " ms" << std::endl;
+  }
+
+  os.precision(0);
+  os << "-- total number of context switches: " << totals.numCtxSwitches
+     << std::endl;
+  os << "-- total number of preemptions: " << totals.numPreempts << std::endl;
+  os << "-- total number of migrations: " << numMigrations << std::endl;
+
+  os.precision(3);
+  os << "-- CPU utilization: " << std::fixed
+     << 100.0 * (double)busyTime / ((double)timestamp * cpus.size()) << "%"
+     << std::endl;
+  for (unsigned int c = 0; c < cpus.size(); ++c) {
+    const Cpu &cpu = cpus[c];
+    os << "-- CPU " << c << ": utilization " << std::fixed
+       << 100.0 * (double)cpu.busyTime / timestamp << "%, "
+       << cpu.numCtxSwitches << " context switches, " << cpu.numPreempts
+       << " preemptions, " << cpu.numMigrations << " migrations" << std::endl;
+  }
+}
+
+extern template class SmpScheduler<FcfsPolicy>;
+extern template class SmpScheduler<RoundRobinPolicy<true>>;
+extern template class SmpScheduler<RoundRobinPolicy<false>>;
+extern template class SmpScheduler<SjfPolicy>;
+extern template class SmpScheduler<SrtPolicy>;
+extern template class SmpScheduler<CfsPolicy>;
+extern template class SmpScheduler<MlfqPolicy>;
+extern template class SmpScheduler<PluginPolicy<false, false>>;
+extern template class SmpScheduler<PluginPolicy<false, true>>;
+extern template class SmpScheduler<PluginPolicy<true, false>>;
+extern template class SmpScheduler<PluginPolicy<true, true>>;
+
+#endif
@@ -0,0 +1,139 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - Snapshot.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ */
+
+#include "Snapshot.hpp"
+#include <stdexcept>
+#include <stdio.h>
+
+static_assert(sizeof(SnapshotReader::Header) == 32,
+              "SnapshotReader::Header must be 32 bytes");
+
+constexpr char SnapshotReader::MAGIC[8];
+
+std::uint64_t fnv1a(const void *data, std::size_t len, std::uint64_t hash) {
+  const unsigned char *p = static_cast<const unsigned char *>(data);
+  for (std::size_t i = 0; i < len; ++i) {
+    hash = (hash ^ p[i]) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+void SnapshotWriter::append(const void *data, std::size_t len) {
+  const char *p = static_cast<const char *>(data);
+  bytes.insert(bytes.end(), p, p + len);
+}
+
+void SnapshotWriter::putString(const std::string &s) {
+  put<std::uint64_t>(s.size());
+  append(s.data(), s.size());
+}
+
+void SnapshotWriter::save(const std::string &path) const {
+  SnapshotReader::Header header;
+  std::memcpy(header.magic, SnapshotReader::MAGIC, sizeof(header.magic));
+  header.version = SnapshotReader::VERSION;
+  header.byteOrder = SnapshotReader::BYTE_ORDER_MARK;
+  header.dataSize = bytes.size();
+  header.checksum = fnv1a(bytes.data(), bytes.size());
+
+  FILE *fp = fopen(path.c_str(), "wb");
+  if (fp == NULL) {
+    throw std::runtime_error("Error: could not create snapshot " + path + ".");
+  }
+  const bool written =
+      fwrite(&header, sizeof(header), 1, fp) == 1 &&
+      (bytes.empty() || fwrite(bytes.data(), bytes.size(), 1, fp) == 1);
+  if (fclose(fp) != 0 || !written) {
+    throw std::runtime_error("Error: could not write snapshot " + path + ".");
+  }
+}
+
+SnapshotReader SnapshotReader::load(const std::string &path) {
+  SnapshotReader reader;
+  reader.path = path;
+  FILE *fp = fopen(path.c_str(), "rb");
+  if (fp == NULL) {
+    throw std::runtime_error("Error: could not open snapshot " + path + ".");
+  }
+  Header header;
+  if (fread(&header, sizeof(header), 1, fp) != 1 ||
+      std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+    fclose(fp);
+    reader.fail("is not a snapshot");
+  }
+  if (header.byteOrder != BYTE_ORDER_MARK) {
+    fclose(fp);
+    reader.fail("was written with a different byte order");
+  }
+  if (header.version != VERSION) {
+    fclose(fp);
+    reader.fail("has unsupported version " + std::to_string(header.version));
+  }
+  // The file size bounds dataSize before anything is allocated for it
+  long size = -1;
+  if (fseek(fp, 0, SEEK_END) == 0) {
+    size = ftell(fp);
+  }
+  bool valid = size >= 0 && header.dataSize == size - sizeof(header) &&
+               fseek(fp, sizeof(header), SEEK_SET) == 0;
+  if (valid) {
+    reader.bytes.resize(header.dataSize);
+    valid = reader.bytes.empty() ||
+            fread(reader.bytes.data(), reader.bytes.size(), 1, fp) == 1;
+  }
+  fclose(fp);
+  if (!valid ||
+      fnv1a(reader.bytes.data(), reader.bytes.size()) != header.checksum) {
+    reader.fail("is truncated or corrupt");
+  }
+  return reader;
+}
+
+void SnapshotReader::take(void *data, std::size_t len) {
+  if (len > bytes.size() - pos) {
+    fail("is truncated or corrupt");
+  }
+  // data may be the null data() of an empty vector
+  if (len == 0) {
+    return;
+  }
+  std::memcpy(data, bytes.data() + pos, len);
+  pos += len;
+}
+
+void SnapshotReader::getIndices(std::vector<std::uint32_t> &indices,
+                                std::uint32_t limit) {
+  getArray(indices);
+  for (std::uint32_t i : indices) {
+    if (i >= limit) {
+      fail("doesn't match the simulation it is restored into");
+    }
+  }
+}
+
+std::string SnapshotReader::getString() {
+  const std::uint64_t size = get<std::uint64_t>();
+  if (size > bytes.size() - pos) {
+    fail("is truncated or corrupt");
+  }
+  std::string s(bytes.data() + pos, size);
+  pos += size;
+  return s;
+}
+
+void SnapshotReader::finish() const {
+  if (pos != bytes.size()) {
+    fail("doesn't match the simulation it is restored into");
+  }
+}
+
+void SnapshotReader::fail(const std::string &what) const {
+  throw std::runtime_error("Error: snapshot " + path + " " + what + ".");
+}
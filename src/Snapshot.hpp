@@ -0,0 +1,121 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - Snapshot.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Snapshot files of a simulation paused between two event ticks, see
+ * Scheduler::save() and Scheduler::restore(). The state is a flat sequence
+ * of integers and arrays that the Scheduler, the ProcessTable and the policy
+ * append to a SnapshotWriter in turn and read back from a SnapshotReader in
+ * the same order, so the layout of the state is defined by those
+ * saveState() / loadState() pairs, which are kept next to each other.
+ *
+ *    Version 1 layout, all integers in the byte order of the machine that
+ * wrote the file:
+ *
+ *      Header (32 bytes, see below)
+ *      dataSize bytes of state
+ *
+ *    checksum is the 64-bit FNV-1a hash of the state, so a damaged file is
+ * rejected instead of being restored into an inconsistent simulation. A
+ * snapshot holds no workload, only its fingerprint (see
+ * ProcessTable::fingerprint()), and no settings that are given to the
+ * policy's constructor.
+ */
+
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// FNV-1a over len bytes, continuing from hash
+std::uint64_t fnv1a(const void *data, std::size_t len,
+                    std::uint64_t hash = 0xcbf29ce484222325ULL);
+
+class SnapshotWriter {
+public:
+  template <class T> void put(T value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Snapshots only hold plain values");
+    append(&value, sizeof(value));
+  }
+  template <class T> void putArray(const std::vector<T> &values) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Snapshots only hold plain values");
+    put<std::uint64_t>(values.size());
+    append(values.data(), values.size() * sizeof(T));
+  }
+  void putString(const std::string &s);
+  void save(const std::string &path) const;
+
+private:
+  void append(const void *data, std::size_t len);
+
+  std::vector<char> bytes;
+};
+
+class SnapshotReader {
+public:
+  static constexpr char MAGIC[8] = {'C', 'P', 'U', 'S', 'S', 'N', 'A', 'P'};
+  static constexpr std::uint32_t VERSION = 1;
+  static constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+  struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint64_t dataSize;
+    std::uint64_t checksum;
+  };
+
+  static SnapshotReader load(const std::string &path);
+
+  const std::string &getPath() const { return path; }
+  template <class T> T get() {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Snapshots only hold plain values");
+    T value;
+    take(&value, sizeof(value));
+    return value;
+  }
+  // Reads an array of any length
+  template <class T> void getArray(std::vector<T> &values) {
+    const std::uint64_t size = get<std::uint64_t>();
+    if (size > (bytes.size() - pos) / sizeof(T)) {
+      fail("is truncated or corrupt");
+    }
+    values.resize(size);
+    take(values.data(), size * sizeof(T));
+  }
+  // Reads an array that must hold exactly size values
+  template <class T> void getArray(std::vector<T> &values, std::size_t size) {
+    getArray(values);
+    if (values.size() != size) {
+      fail("doesn't match the simulation it is restored into");
+    }
+  }
+  // Reads an array of indices (e.g. handles), each less than limit
+  void getIndices(std::vector<std::uint32_t> &indices, std::uint32_t limit);
+  std::string getString();
+  // Throws unless all of the state has been read
+  void finish() const;
+  [[noreturn]] void fail(const std::string &what) const;
+
+private:
+  void take(void *data, std::size_t len);
+
+  std::string path;
+  std::vector<char> bytes;
+  std::size_t pos = 0;
+};
+
+#endif
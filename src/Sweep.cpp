@@ -0,0 +1,206 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - Sweep.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ */
+
+#include "Sweep.hpp"
+#include "ProcessTable.hpp"
+#include "RoundRobin.hpp"
+#include "SeqGenerator.hpp"
+#include "ShortestRemainingTime.hpp"
+#include "ThreadPool.hpp"
+#include "Workload.hpp"
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace {
+
+std::vector<std::string> splitList(const std::string &field) {
+  std::vector<std::string> values;
+  std::stringstream ss(field);
+  std::string value;
+  while (std::getline(ss, value, ',')) {
+    if (value.empty()) {
+      throw std::runtime_error("Error: empty value in sweep field \"" + field +
+                               "\".");
+    }
+    values.push_back(value);
+  }
+  return values;
+}
+
+template <class T> T parseValue(const std::string &value) {
+  std::stringstream ss(value);
+  T res;
+  // >> wraps a negative value around rather than failing
+  if ((std::is_unsigned<T>::value && value[0] == '-') || !(ss >> res) ||
+      !ss.eof()) {
+    throw std::runtime_error("Error: bad sweep value \"" + value + "\".");
+  }
+  return res;
+}
+
+Sweep::Config makeConfig(const std::vector<std::string> &fields) {
+  Sweep::Config config;
+  config.n = parseValue<unsigned int>(fields[0]);
+  config.seed = parseValue<long int>(fields[1]);
+  config.lambda = parseValue<double>(fields[2]);
+  config.limit = parseValue<int>(fields[3]);
+  config.tcs = parseValue<unsigned int>(fields[4]);
+  config.alpha = parseValue<double>(fields[5]);
+  config.tslice = parseValue<unsigned int>(fields[6]);
+  config.addToEnd = true;
+  if (fields.size() == 8) {
+    if (fields[7] == "BEGINNING") {
+      config.addToEnd = false;
+    } else if (fields[7] != "END") {
+      throw std::runtime_error(
+          "Error: rr_add must be either BEGINNING or END in a sweep.");
+    }
+  }
+  // As the command line checks them
+  if (config.n == 0) {
+    throw std::runtime_error("Error: n isn't a positive number.");
+  }
+  if (!(config.lambda > 0 && config.lambda < HUGE_VAL)) {
+    throw std::runtime_error("Error: lambda isn't a positive number.");
+  }
+  // The burst sampler redraws until a value fits under limit
+  if (config.limit <= 0) {
+    throw std::runtime_error("Error: limit isn't a positive number.");
+  }
+  if (config.tcs == 0 || config.tcs % 2 != 0) {
+    throw std::runtime_error("Error: tcs isn't a positive even number.");
+  }
+  if (config.tslice == 0) {
+    throw std::runtime_error("Error: tslice isn't a positive number.");
+  }
+  // As --import-sched checks it
+  if (!(config.alpha >= 0 && config.alpha <= 1)) {
+    throw std::runtime_error("Error: alpha isn't a weight from 0 to 1.");
+  }
+  return config;
+}
+
+template <class MakePolicy>
+void simulateCsv(const Workload &workload, unsigned int tcs,
+                 MakePolicy makePolicy, const std::string &prefix,
+                 std::ostream &os) {
+  ProcessTable processes(workload);
+  auto policy = makePolicy(processes);
+  Scheduler<decltype(policy)> scheduler(processes, tcs, policy, nullptr);
+  scheduler.run();
+  os << prefix;
+  scheduler.printCsv(os);
+}
+
+} // namespace
+
+std::vector<Sweep::Config> Sweep::parseGrid(std::istream &is) {
+  std::vector<Config> configs;
+  std::string line;
+  while (std::getline(is, line)) {
+    std::stringstream ss(line);
+    std::vector<std::vector<std::string>> fields;
+    std::string field;
+    while (ss >> field) {
+      fields.push_back(splitList(field));
+    }
+    if (fields.empty() || fields[0][0][0] == '#') {
+      continue;
+    }
+    if (fields.size() != 7 && fields.size() != 8) {
+      throw std::runtime_error("Error: sweep line \"" + line +
+                               "\" doesn't have 7 or 8 fields.");
+    }
+
+    // Odometer over the value lists, last field changing fastest
+    std::vector<unsigned int> idx(fields.size(), 0);
+    std::vector<std::string> values(fields.size());
+    while (true) {
+      for (unsigned int i = 0; i < fields.size(); ++i) {
+        values[i] = fields[i][idx[i]];
+      }
+      configs.push_back(makeConfig(values));
+      int i = fields.size() - 1;
+      while (i >= 0 && ++idx[i] == fields[i].size()) {
+        idx[i--] = 0;
+      }
+      if (i < 0) {
+        break;
+      }
+    }
+  }
+  return configs;
+}
+
+void Sweep::printCsvHeader(std::ostream &os) {
+  os << "n,seed,lambda,limit,tcs,alpha,tslice,rr_add,";
+  os << "algorithm,avg_cpu_burst_time,avg_wait_time,avg_turnaround_time,";
+  os << "num_ctx_switches,num_preemptions,cpu_utilization," << std::endl;
+}
+
+void Sweep::runConfig(const Config &config, std::ostream &os) {
+  std::ostringstream prefix;
+  prefix << config.n << "," << config.seed << "," << config.lambda << ",";
+  prefix << config.limit << "," << config.tcs << "," << config.alpha << ",";
+  prefix << config.tslice << "," << (config.addToEnd ? "END" : "BEGINNING")
+         << ",";
+
+  const Workload workload = SeqGenerator::generateProccesses(
+      config.n, config.lambda, config.limit, config.seed, config.alpha);
+  const unsigned int tslice = config.tslice;
+  simulateCsv(
+      workload, config.tcs, [](const ProcessTable &) { return FcfsPolicy(); },
+      prefix.str(), os);
+  simulateCsv(
+      workload, config.tcs,
+      [](const ProcessTable &procs) { return SjfPolicy(procs); },
+      prefix.str(), os);
+  simulateCsv(
+      workload, config.tcs,
+      [](const ProcessTable &procs) { return SrtPolicy(procs); },
+      prefix.str(), os);
+  if (config.addToEnd) {
+    simulateCsv(
+        workload, config.tcs,
+        [tslice](const ProcessTable &) {
+          return RoundRobinPolicy<true>(tslice);
+        },
+        prefix.str(), os);
+  } else {
+    simulateCsv(
+        workload, config.tcs,
+        [tslice](const ProcessTable &) {
+          return RoundRobinPolicy<false>(tslice);
+        },
+        prefix.str(), os);
+  }
+}
+
+void Sweep::run(const std::vector<Config> &configs, std::ostream &os,
+                unsigned int numThreads) {
+  std::vector<std::string> rows(configs.size());
+  {
+    ThreadPool pool(numThreads);
+    for (unsigned int i = 0; i < configs.size(); ++i) {
+      pool.submit([&configs, &rows, i] {
+        std::ostringstream ss;
+        runConfig(configs[i], ss);
+        rows[i] = ss.str();
+      });
+    }
+    pool.wait();
+  }
+  printCsvHeader(os);
+  for (const auto &row : rows) {
+    os << row;
+  }
+}
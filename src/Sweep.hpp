@@ -0,0 +1,56 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - Sweep.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Parameter sweeps: runs all four algorithms for many configurations on a
+ * ThreadPool and writes one CSV row per (configuration, algorithm) with the
+ * configuration followed by the Scheduler::printCsv() columns.
+ *
+ *    A grid file holds one configuration per line, with the same fields in
+ * the same order as the command line:
+ *
+ *      n seed lambda limit tcs alpha tslice [rr_add]
+ *
+ * Any field may be a comma separated list of values, in which case the line
+ * stands for every combination of them, e.g.
+ *
+ *      64 1,2,3 0.01 256 2,4,8 0.5 32,64 END,BEGINNING
+ *
+ * is 36 configurations. Blank lines and lines starting with '#' are skipped.
+ * Rows come out in grid order however the runs were scheduled.
+ */
+
+#ifndef SWEEP_HPP
+#define SWEEP_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Sweep {
+
+struct Config {
+  unsigned int n;
+  long int seed;
+  double lambda;
+  int limit;
+  unsigned int tcs;
+  double alpha;
+  unsigned int tslice;
+  bool addToEnd;
+};
+
+std::vector<Config> parseGrid(std::istream &is);
+void printCsvHeader(std::ostream &os);
+void runConfig(const Config &config, std::ostream &os);
+void run(const std::vector<Config> &configs, std::ostream &os,
+         unsigned int numThreads);
+} // namespace Sweep
+
+#endif
@@ -0,0 +1,115 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - ThreadPool.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ */
+
+#include "ThreadPool.hpp"
+
+ThreadPool::ThreadPool(unsigned int numThreads) {
+  if (!numThreads) {
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (unsigned int i = 0; i < numThreads; ++i) {
+    workers.emplace_back(new Worker());
+  }
+  threads.reserve(numThreads);
+  for (unsigned int i = 0; i < numThreads; ++i) {
+    threads.emplace_back(&ThreadPool::workerLoop, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> guard(stateLock);
+    stopping = true;
+  }
+  workAvailable.notify_all();
+  for (auto &t : threads) {
+    t.join();
+  }
+}
+
+void ThreadPool::submit(Task task) {
+  Worker &w = *workers[nextWorker++ % workers.size()];
+  {
+    std::lock_guard<std::mutex> guard(stateLock);
+    ++pending;
+    ++queued;
+  }
+  {
+    std::lock_guard<std::mutex> guard(w.lock);
+    w.tasks.push_back(std::move(task));
+  }
+  workAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+  std::unique_lock<std::mutex> guard(stateLock);
+  allDone.wait(guard, [this] { return pending == 0; });
+  if (firstError) {
+    std::exception_ptr err = firstError;
+    firstError = nullptr;
+    std::rethrow_exception(err);
+  }
+}
+
+bool ThreadPool::popOwn(unsigned int self, Task &task) {
+  Worker &w = *workers[self];
+  std::lock_guard<std::mutex> guard(w.lock);
+  if (w.tasks.empty()) {
+    return false;
+  }
+  task = std::move(w.tasks.back());
+  w.tasks.pop_back();
+  return true;
+}
+
+bool ThreadPool::steal(unsigned int self, Task &task) {
+  for (unsigned int i = 1; i < workers.size(); ++i) {
+    Worker &victim = *workers[(self + i) % workers.size()];
+    std::lock_guard<std::mutex> guard(victim.lock);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::workerLoop(unsigned int self) {
+  Task task;
+  while (true) {
+    if (popOwn(self, task) || steal(self, task)) {
+      {
+        std::lock_guard<std::mutex> guard(stateLock);
+        --queued;
+      }
+      std::exception_ptr err;
+      try {
+        task();
+      } catch (...) {
+        err = std::current_exception();
+      }
+      task = nullptr;
+      std::lock_guard<std::mutex> guard(stateLock);
+      if (err && !firstError) {
+        firstError = err;
+      }
+      if (--pending == 0) {
+        allDone.notify_all();
+      }
+      continue;
+    }
+    std::unique_lock<std::mutex> guard(stateLock);
+    workAvailable.wait(guard, [this] { return queued > 0 || stopping; });
+    if (stopping && queued == 0) {
+      return;
+    }
+  }
+}
@@ -0,0 +1,75 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - ThreadPool.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Fixed-size work-stealing thread pool. Every worker owns a deque of tasks:
+ * it takes its own work from the back and, once that runs dry, steals from the
+ * front of the other workers' deques, so a worker stuck with a few long
+ * simulations doesn't hold up the rest of a sweep.
+ *
+ *    submit() hands tasks to the workers in turn. wait() blocks until every
+ * submitted task has finished and rethrows the first exception a task threw,
+ * if any; the remaining tasks still run to completion first.
+ */
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+  typedef std::function<void()> Task;
+
+  // numThreads == 0 means one worker per hardware thread
+  explicit ThreadPool(unsigned int numThreads = 0);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  void submit(Task task);
+  void wait();
+  unsigned int size() const { return workers.size(); }
+
+private:
+  struct Worker {
+    std::mutex lock;
+    std::deque<Task> tasks;
+  };
+
+  void workerLoop(unsigned int self);
+  bool popOwn(unsigned int self, Task &task);
+  bool steal(unsigned int self, Task &task);
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::vector<std::thread> threads;
+  std::atomic<unsigned int> nextWorker{0};
+
+  // Guards queued, pending, stopping and firstError. A task is queued from
+  // just before submit() adds it to a deque until a worker takes it, and
+  // pending until it has finished running.
+  std::mutex stateLock;
+  std::condition_variable workAvailable;
+  std::condition_variable allDone;
+  unsigned long long queued = 0;
+  unsigned long long pending = 0;
+  bool stopping = false;
+  std::exception_ptr firstError;
+};
+
+#endif
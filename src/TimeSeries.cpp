@@ -0,0 +1,200 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - TimeSeries.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ */
+
+#include "TimeSeries.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <stdio.h>
+
+static_assert(sizeof(TimeSeries::Header) == 48,
+              "TimeSeries::Header must be 48 bytes");
+
+constexpr char TimeSeries::MAGIC[8];
+
+namespace {
+
+void writeBytes(FILE *fp, const void *data, std::size_t len,
+                const std::string &path) {
+  if (len && fwrite(data, 1, len, fp) != len) {
+    throw std::runtime_error("Error: could not write time series file " +
+                             path + ".");
+  }
+}
+
+template <class T>
+void readColumn(FILE *fp, std::vector<T> &column, std::size_t len,
+                const std::string &path) {
+  column.resize(len);
+  if (len && fread(column.data(), sizeof(T), len, fp) != len) {
+    throw std::runtime_error("Error: time series file " + path +
+                             " is truncated.");
+  }
+}
+
+} // namespace
+
+TimeSeries::TimeSeries(unsigned int windowMs) : windowMs(windowMs) {
+  if (!windowMs) {
+    throw std::runtime_error(
+        "Error: time series window must be at least 1ms.");
+  }
+}
+
+void TimeSeries::ensureWindow(std::size_t window) {
+  if (window < cpuBusyMs.size()) {
+    return;
+  }
+  readyQueueMs.resize(window + 1, 0);
+  ioMs.resize(window + 1, 0);
+  cpuBusyMs.resize(window + 1, 0);
+  ctxSwitchMs.resize(window + 1, 0);
+  arrivals.resize(window + 1, 0);
+}
+
+void TimeSeries::accumulateUntil(unsigned long long time) {
+  while (lastTime < time) {
+    const std::size_t window = lastTime / windowMs;
+    const unsigned long long end =
+        std::min(time, (unsigned long long)(window + 1) * windowMs);
+    const unsigned long long span = end - lastTime;
+    ensureWindow(window);
+    readyQueueMs[window] += span * current.numReady;
+    ioMs[window] += span * current.numIo;
+    if (current.cpuBusy) {
+      cpuBusyMs[window] += span;
+    }
+    if (current.switching) {
+      ctxSwitchMs[window] += span;
+    }
+    lastTime = end;
+  }
+}
+
+void TimeSeries::record(unsigned int time, const Sample &sample) {
+  accumulateUntil(time);
+  current = sample;
+}
+
+void TimeSeries::addArrival(unsigned int time) {
+  const std::size_t window = time / windowMs;
+  ensureWindow(window);
+  ++arrivals[window];
+}
+
+void TimeSeries::finish(unsigned int endTime) {
+  accumulateUntil(endTime);
+  current = Sample{false, false, 0, 0};
+  if (endTime) {
+    ensureWindow((endTime - 1) / windowMs);
+  }
+}
+
+void TimeSeries::save(const std::string &path) const {
+  const std::uint64_t n = numWindows();
+  Header header;
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.byteOrder = BYTE_ORDER_MARK;
+  header.windowMs = windowMs;
+  header.reserved = 0;
+  header.numWindows = n;
+  header.endTime = lastTime;
+  header.dataOffset = sizeof(Header);
+
+  FILE *fp = fopen(path.c_str(), "wb");
+  if (fp == NULL) {
+    throw std::runtime_error("Error: could not create time series file " +
+                             path + ".");
+  }
+  try {
+    writeBytes(fp, &header, sizeof(header), path);
+    writeBytes(fp, readyQueueMs.data(), 8 * n, path);
+    writeBytes(fp, ioMs.data(), 8 * n, path);
+    writeBytes(fp, cpuBusyMs.data(), 4 * n, path);
+    writeBytes(fp, ctxSwitchMs.data(), 4 * n, path);
+    writeBytes(fp, arrivals.data(), 4 * n, path);
+  } catch (...) {
+    fclose(fp);
+    throw;
+  }
+  if (fclose(fp) != 0) {
+    throw std::runtime_error("Error: could not write time series file " +
+                             path + ".");
+  }
+}
+
+TimeSeries TimeSeries::load(const std::string &path) {
+  FILE *fp = fopen(path.c_str(), "rb");
+  if (fp == NULL) {
+    throw std::runtime_error("Error: could not open time series file " + path +
+                             ".");
+  }
+  try {
+    Header header;
+    if (fread(&header, sizeof(header), 1, fp) != 1 ||
+        std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+      throw std::runtime_error("Error: " + path +
+                               " is not a time series file.");
+    }
+    if (header.byteOrder != BYTE_ORDER_MARK) {
+      throw std::runtime_error("Error: time series file " + path +
+                               " was written with a different byte order.");
+    }
+    if (header.version != VERSION) {
+      throw std::runtime_error("Error: time series file " + path +
+                               " has unsupported version " +
+                               std::to_string(header.version) + ".");
+    }
+    // Every column is complete if the file is exactly as long as they are
+    if (fseek(fp, 0, SEEK_END) != 0) {
+      throw std::runtime_error("Error: could not read time series file " +
+                               path + ".");
+    }
+    const std::uint64_t size = ftell(fp);
+    if (!header.windowMs || header.dataOffset % 8 ||
+        header.dataOffset < sizeof(Header) || header.dataOffset > size ||
+        header.numWindows > size ||
+        size - header.dataOffset != header.numWindows * (8 * 2 + 4 * 3) ||
+        fseek(fp, header.dataOffset, SEEK_SET) != 0) {
+      throw std::runtime_error("Error: time series file " + path +
+                               " is corrupt.");
+    }
+    TimeSeries series(header.windowMs);
+    const std::size_t n = header.numWindows;
+    readColumn(fp, series.readyQueueMs, n, path);
+    readColumn(fp, series.ioMs, n, path);
+    readColumn(fp, series.cpuBusyMs, n, path);
+    readColumn(fp, series.ctxSwitchMs, n, path);
+    readColumn(fp, series.arrivals, n, path);
+    series.lastTime = header.endTime;
+    fclose(fp);
+    return series;
+  } catch (...) {
+    fclose(fp);
+    throw;
+  }
+}
+
+void TimeSeries::writeCsv(std::ostream &os) const {
+  os << "start_ms,cpu_busy_ms,ctx_switch_ms,arrivals,avg_ready_queue,"
+        "avg_io"
+     << std::endl;
+  for (std::size_t w = 0; w < numWindows(); ++w) {
+    const unsigned long long start = (unsigned long long)w * windowMs;
+    const double length =
+        lastTime > start
+            ? std::min<unsigned long long>(windowMs, lastTime - start)
+            : 0;
+    os << start << "," << cpuBusyMs[w] << "," << ctxSwitchMs[w] << ","
+       << arrivals[w] << "," << (length ? readyQueueMs[w] / length : 0) << ","
+       << (length ? ioMs[w] / length : 0) << "\n";
+  }
+}
@@ -0,0 +1,101 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - TimeSeries.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Per-window load figures of one simulation run. The Scheduler calls
+ * record() at the end of every event tick with what the CPU, the ready queue
+ * and the I/O queue look like until the next tick, and addArrival() for each
+ * arrival; the state is piecewise constant between ticks, so each call only
+ * adds the time since the previous one to the window(s) it covers. The cost
+ * is a few counters per event whatever the window size.
+ *
+ *    For every window of windowMs ms the series holds:
+ *
+ *    cpuBusyMs: ms a process was running on the CPU.
+ *    ctxSwitchMs: ms a context switch (in or out) was in progress.
+ *    arrivals: processes that arrived.
+ *    readyQueueMs: the ready queue length summed over the window's ms, i.e.
+ * windowMs times the average length.
+ *    ioMs: the same for the number of processes doing I/O.
+ *
+ *    save() writes the columns one after the other (version 1 layout, all
+ * integers in the byte order of the machine that wrote the file):
+ *
+ *      Header (48 bytes, see below)
+ *      at dataOffset (8-byte aligned):
+ *        u64 readyQueueMs[numWindows], ioMs[numWindows]
+ *        u32 cpuBusyMs[numWindows], ctxSwitchMs[numWindows],
+ *            arrivals[numWindows]
+ *
+ *    The last window ends at endTime and may be shorter than windowMs.
+ * load() reads a file back, e.g. to print it with writeCsv().
+ */
+
+#ifndef TIMESERIES_HPP
+#define TIMESERIES_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class TimeSeries {
+public:
+  static constexpr char MAGIC[8] = {'C', 'P', 'U', 'S', 'T', 'S', 'E', 'R'};
+  static constexpr std::uint32_t VERSION = 1;
+  static constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+  struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint32_t windowMs;
+    std::uint32_t reserved;
+    std::uint64_t numWindows;
+    std::uint64_t endTime;
+    std::uint64_t dataOffset;
+  };
+
+  // What the scheduler looks like from one event tick to the next
+  struct Sample {
+    bool cpuBusy;
+    bool switching;
+    unsigned int numReady;
+    unsigned int numIo;
+  };
+
+  explicit TimeSeries(unsigned int windowMs);
+  void record(unsigned int time, const Sample &sample);
+  void addArrival(unsigned int time);
+  // Accounts for the time up to endTime; no record() may follow.
+  void finish(unsigned int endTime);
+
+  unsigned int getWindowMs() const { return windowMs; }
+  std::size_t numWindows() const { return cpuBusyMs.size(); }
+
+  void save(const std::string &path) const;
+  static TimeSeries load(const std::string &path);
+  void writeCsv(std::ostream &os) const;
+
+private:
+  void accumulateUntil(unsigned long long time);
+  void ensureWindow(std::size_t window);
+
+  unsigned int windowMs;
+  unsigned long long lastTime = 0;
+  Sample current = {false, false, 0, 0};
+
+  std::vector<std::uint64_t> readyQueueMs;
+  std::vector<std::uint64_t> ioMs;
+  std::vector<std::uint32_t> cpuBusyMs;
+  std::vector<std::uint32_t> ctxSwitchMs;
+  std::vector<std::uint32_t> arrivals;
+};
+
+#endif
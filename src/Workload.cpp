@@ -0,0 +1,97 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - Workload.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ */
+
+#include "Workload.hpp"
+#include <algorithm>
+
+void Workload::reserve(unsigned int numProcs,
+                       unsigned long long numBurstSlots) {
+  if (storage) {
+    throw std::runtime_error("Error: Workload::reserve() called for a "
+                             "read-only workload.");
+  }
+  arrivalTimes.reserve(numProcs);
+  pids.reserve(numProcs);
+  burstOffsets.reserve(numProcs);
+  numBursts.reserve(numProcs);
+  tau0s.reserve(numProcs);
+
+  cpuBurstTimes.reserve(numBurstSlots);
+  ioBurstTimes.reserve(numBurstSlots);
+  updateView();
+}
+
+void Workload::updateView() {
+  view.numProcs = arrivalTimes.size();
+  view.numBurstSlots = cpuBurstTimes.size();
+  view.arrivalTimes = arrivalTimes.data();
+  view.pids = pids.data();
+  view.burstOffsets = burstOffsets.data();
+  view.numBursts = numBursts.data();
+  view.tau0s = tau0s.data();
+  view.cpuBurstTimes = cpuBurstTimes.data();
+  view.ioBurstTimes = ioBurstTimes.data();
+}
+
+Workload::Handle Workload::add(unsigned int arrivalTime, unsigned int nBursts,
+                               unsigned int tau) {
+  if (storage) {
+    throw std::runtime_error("Error: Workload::add() called for a read-only "
+                             "workload.");
+  }
+  if (nBursts == 0) {
+    throw std::runtime_error("Error: Workload::add() called with 0 bursts.");
+  }
+  if (size() >= Process::NONE) {
+    throw std::runtime_error("Error: Workload is full.");
+  }
+  Handle h = size();
+  arrivalTimes.push_back(arrivalTime);
+  pids.push_back(pidAllocator.next());
+  burstOffsets.push_back(cpuBurstTimes.size());
+  numBursts.push_back(nBursts);
+  tau0s.push_back(tau);
+
+  cpuBurstTimes.resize(cpuBurstTimes.size() + nBursts, 0);
+  ioBurstTimes.resize(ioBurstTimes.size() + nBursts, 0);
+  updateView();
+  return h;
+}
+
+void Workload::setBurst(Handle h, unsigned int burst,
+                        unsigned int cpuBurstTime, unsigned int ioBurstTime) {
+  if (h >= size()) {
+    throw std::runtime_error(
+        "Error: setBurst() called for an unknown process.");
+  }
+  if (storage) {
+    throw std::runtime_error("Error: Workload::setBurst() called for a "
+                             "read-only workload.");
+  }
+  if (burst >= numBursts[h]) {
+    throw std::runtime_error("Error: setBurst() called with out of bounds "
+                             "burst index.");
+  }
+  cpuBurstTimes[burstOffsets[h] + burst] = cpuBurstTime;
+  ioBurstTimes[burstOffsets[h] + burst] =
+      burst + 1 == numBursts[h] ? 0 : ioBurstTime;
+}
+
+std::vector<Workload::Handle> Workload::byArrival() const {
+  std::vector<Handle> order(size());
+  for (Handle h = 0; h < size(); ++h) {
+    order[h] = h;
+  }
+  std::sort(order.begin(), order.end(), [this](Handle a, Handle b) {
+    return getArrivalTime(a) < getArrivalTime(b) ||
+           (getArrivalTime(a) == getArrivalTime(b) && getPid(a) < getPid(b));
+  });
+  return order;
+}
@@ -0,0 +1,112 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - Workload.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Immutable description of a workload: every process' arrival time, pid,
+ * initial tau and CPU/I/O bursts, plus the alpha used to recalculate tau. A
+ * Workload is built once (by SeqGenerator) through reserve(), add() and
+ * setBurst() and is then only read, so a single const Workload can be shared
+ * by any number of simulations running at the same time; everything a
+ * simulation changes lives in its own ProcessTable (see ProcessTable.hpp).
+ *
+ *    Processes are identified by Process::Handles, their index into the
+ * per-process arrays. All bursts of all processes live in one flat arena
+ * where process h owns the slots [getBurstOffset(h), getBurstOffset(h) +
+ * getNumBursts(h)).
+ *
+ *    The getters read through an Arrays view rather than the vectors, so a
+ * Workload can equally be backed by a memory-mapped workload file (see
+ * WorkloadFile.hpp) without copying anything; such a Workload can't be added
+ * to and keeps the mapping alive through storage.
+ */
+
+#ifndef WORKLOAD_HPP
+#define WORKLOAD_HPP
+
+#include "Process.hpp"
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class Workload {
+public:
+  typedef Process::Handle Handle;
+
+  struct Arrays {
+    unsigned int numProcs = 0;
+    unsigned long long numBurstSlots = 0;
+    const unsigned int *arrivalTimes = nullptr;
+    const Process::Pid *pids = nullptr;
+    const unsigned long long *burstOffsets = nullptr;
+    const unsigned int *numBursts = nullptr;
+    const unsigned int *tau0s = nullptr;
+    const unsigned int *cpuBurstTimes = nullptr;
+    const unsigned int *ioBurstTimes = nullptr;
+  };
+
+  explicit Workload(double alpha) : alpha(alpha) {}
+  // Read-only workload over arrays that storage keeps alive
+  Workload(double alpha, const Arrays &arrays,
+           std::shared_ptr<const void> storage)
+      : alpha(alpha), view(arrays), storage(std::move(storage)) {}
+  Workload(Workload &&) = default;
+  Workload &operator=(Workload &&) = default;
+  Workload(const Workload &) = delete;
+  Workload &operator=(const Workload &) = delete;
+
+  void reserve(unsigned int numProcs, unsigned long long numBurstSlots);
+  Handle add(unsigned int arrivalTime, unsigned int numBursts,
+             unsigned int tau);
+  void setBurst(Handle h, unsigned int burst, unsigned int cpuBurstTime,
+                unsigned int ioBurstTime);
+
+  unsigned int size() const { return view.numProcs; }
+  unsigned long long numBurstSlots() const { return view.numBurstSlots; }
+  double getAlpha() const { return alpha; }
+  unsigned int getArrivalTime(Handle h) const { return view.arrivalTimes[h]; }
+  Process::Pid getPid(Handle h) const { return view.pids[h]; }
+  std::string getName(Handle h) const { return Process::fmtPid(view.pids[h]); }
+  unsigned int getNumBursts(Handle h) const { return view.numBursts[h]; }
+  unsigned int getTau0(Handle h) const { return view.tau0s[h]; }
+  unsigned long long getBurstOffset(Handle h) const {
+    return view.burstOffsets[h];
+  }
+  // Indexed by arena slot, see getBurstOffset()
+  unsigned int getCpuBurstTime(unsigned long long slot) const {
+    return view.cpuBurstTimes[slot];
+  }
+  unsigned int getIoBurstTime(unsigned long long slot) const {
+    return view.ioBurstTimes[slot];
+  }
+  const Arrays &arrays() const { return view; }
+  // Every handle, by arrival time and then pid
+  std::vector<Handle> byArrival() const;
+
+private:
+  void updateView();
+
+  PidAllocator pidAllocator;
+  double alpha;
+  Arrays view;
+  std::shared_ptr<const void> storage;
+
+  // Only used by workloads built with add()
+  std::vector<unsigned int> arrivalTimes;
+  std::vector<Process::Pid> pids;
+  std::vector<unsigned long long> burstOffsets;
+  std::vector<unsigned int> numBursts;
+  std::vector<unsigned int> tau0s;
+
+  // Burst arena. The I/O slot of a process' last burst is always 0.
+  std::vector<unsigned int> cpuBurstTimes;
+  std::vector<unsigned int> ioBurstTimes;
+};
+
+#endif
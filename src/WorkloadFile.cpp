@@ -0,0 +1,213 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - WorkloadFile.cpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ */
+
+#include "WorkloadFile.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <stdexcept>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+static_assert(sizeof(WorkloadFile::Header) == 64,
+              "WorkloadFile::Header must be 64 bytes");
+static_assert(sizeof(unsigned int) == 4 && sizeof(Process::Pid) == 4 &&
+                  sizeof(unsigned long long) == 8,
+              "Workload arrays must match the file's integer sizes");
+
+constexpr char WorkloadFile::MAGIC[8];
+
+namespace {
+
+std::uint64_t align8(std::uint64_t n) { return (n + 7) & ~7ULL; }
+
+std::uint64_t procTableSize(std::uint64_t numProcs) {
+  return numProcs * (8 + 4 * 4);
+}
+
+std::uint64_t burstArenaSize(std::uint64_t numBurstSlots) {
+  return numBurstSlots * 4 * 2;
+}
+
+void writeBytes(FILE *fp, const void *data, std::size_t len,
+                const std::string &path) {
+  if (len && fwrite(data, 1, len, fp) != len) {
+    throw std::runtime_error("Error: could not write workload file " + path +
+                             ".");
+  }
+}
+
+void writePadding(FILE *fp, std::uint64_t written, const std::string &path) {
+  static const char zeros[8] = {};
+  writeBytes(fp, zeros, align8(written) - written, path);
+}
+
+} // namespace
+
+Workload WorkloadFile::load(const std::string &path, bool full) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Error: could not open workload file " + path +
+                             ": " + std::strerror(errno));
+  }
+  struct stat st;
+  if (fstat(fd, &st) < 0 || (std::uint64_t)st.st_size < sizeof(Header)) {
+    close(fd);
+    throw std::runtime_error("Error: " + path + " is not a workload file.");
+  }
+  const std::uint64_t size = st.st_size;
+  void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    throw std::runtime_error("Error: could not map workload file " + path +
+                             ": " + std::strerror(errno));
+  }
+  std::shared_ptr<const void> mapping(
+      addr, [size](const void *p) { munmap(const_cast<void *>(p), size); });
+
+  const char *base = static_cast<const char *>(addr);
+  const Header &header = *reinterpret_cast<const Header *>(base);
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+    throw std::runtime_error("Error: " + path + " is not a workload file.");
+  }
+  if (header.byteOrder != BYTE_ORDER_MARK) {
+    throw std::runtime_error("Error: workload file " + path +
+                             " was written with a different byte order.");
+  }
+  if (header.version != VERSION) {
+    throw std::runtime_error("Error: workload file " + path +
+                             " has unsupported version " +
+                             std::to_string(header.version) + ".");
+  }
+  if (header.fileSize != size || header.numProcs >= Process::NONE ||
+      header.procTableOffset % 8 || header.burstArenaOffset % 8 ||
+      header.procTableOffset < sizeof(Header) ||
+      header.procTableOffset > size ||
+      procTableSize(header.numProcs) > size - header.procTableOffset ||
+      header.burstArenaOffset > size ||
+      // Divided rather than multiplied, as a bad count could wrap around
+      header.numBurstSlots >
+          (size - header.burstArenaOffset) / burstArenaSize(1)) {
+    throw std::runtime_error("Error: workload file " + path +
+                             " is truncated or corrupt.");
+  }
+
+  Workload::Arrays arrays;
+  const std::uint64_t n = header.numProcs;
+  const char *table = base + header.procTableOffset;
+  const char *arena = base + header.burstArenaOffset;
+  arrays.numProcs = n;
+  arrays.numBurstSlots = header.numBurstSlots;
+  arrays.burstOffsets = reinterpret_cast<const unsigned long long *>(table);
+  arrays.arrivalTimes = reinterpret_cast<const unsigned int *>(table + 8 * n);
+  arrays.pids = reinterpret_cast<const Process::Pid *>(table + 12 * n);
+  arrays.numBursts = reinterpret_cast<const unsigned int *>(table + 16 * n);
+  arrays.tau0s = reinterpret_cast<const unsigned int *>(table + 20 * n);
+  arrays.cpuBurstTimes = reinterpret_cast<const unsigned int *>(arena);
+  arrays.ioBurstTimes =
+      reinterpret_cast<const unsigned int *>(arena + 4 * header.numBurstSlots);
+
+  // A process' bursts must lie in the arena; what they hold is only checked
+  // by verify(), which has to read all of them
+  for (std::uint64_t h = 0; h < n; ++h) {
+    if (arrays.numBursts[h] == 0 ||
+        arrays.burstOffsets[h] > header.numBurstSlots ||
+        arrays.numBursts[h] > header.numBurstSlots - arrays.burstOffsets[h]) {
+      throw std::runtime_error("Error: workload file " + path +
+                               " has bad bursts for process " +
+                               std::to_string(h) + ".");
+    }
+  }
+  Workload workload(header.alpha, arrays, std::move(mapping));
+  if (full) {
+    verify(workload, path);
+  }
+  return workload;
+}
+
+void WorkloadFile::verify(const Workload &workload, const std::string &path) {
+  // Every CPU burst must take at least 1ms; I/O bursts are any u32 values.
+  // Pids must be unique, as ties are broken by pid.
+  const Workload::Arrays &arrays = workload.arrays();
+  const std::uint64_t n = arrays.numProcs;
+  for (std::uint64_t h = 0; h < n; ++h) {
+    const unsigned int *cpuBurstTimes =
+        arrays.cpuBurstTimes + arrays.burstOffsets[h];
+    if (std::find(cpuBurstTimes, cpuBurstTimes + arrays.numBursts[h], 0u) !=
+        cpuBurstTimes + arrays.numBursts[h]) {
+      throw std::runtime_error("Error: " + path +
+                               " has a 0ms CPU burst for process " +
+                               Process::fmtPid(arrays.pids[h]) + ".");
+    }
+  }
+  std::vector<Process::Pid> pids(arrays.pids, arrays.pids + n);
+  std::sort(pids.begin(), pids.end());
+  const auto dup = std::adjacent_find(pids.begin(), pids.end());
+  if (dup != pids.end()) {
+    throw std::runtime_error("Error: workload file " + path +
+                             " has more than one process " +
+                             Process::fmtPid(*dup) + ".");
+  }
+}
+
+WorkloadFile::Header WorkloadFile::makeHeader(std::uint64_t numProcs,
+                                              std::uint64_t numBurstSlots,
+                                              double alpha) {
+  Header header;
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.byteOrder = BYTE_ORDER_MARK;
+  header.numProcs = numProcs;
+  header.numBurstSlots = numBurstSlots;
+  header.alpha = alpha;
+  header.procTableOffset = align8(sizeof(Header));
+  header.burstArenaOffset =
+      align8(header.procTableOffset + procTableSize(numProcs));
+  header.fileSize = header.burstArenaOffset + burstArenaSize(numBurstSlots);
+  return header;
+}
+
+void WorkloadFile::save(const Workload &workload, const std::string &path) {
+  const Workload::Arrays &arrays = workload.arrays();
+  const std::uint64_t n = arrays.numProcs;
+  const Header header =
+      makeHeader(n, arrays.numBurstSlots, workload.getAlpha());
+  verify(workload, path);
+
+  FILE *fp = fopen(path.c_str(), "wb");
+  if (fp == NULL) {
+    throw std::runtime_error("Error: could not create workload file " + path +
+                             ".");
+  }
+  try {
+    writeBytes(fp, &header, sizeof(header), path);
+    writePadding(fp, sizeof(header), path);
+    writeBytes(fp, arrays.burstOffsets, 8 * n, path);
+    writeBytes(fp, arrays.arrivalTimes, 4 * n, path);
+    writeBytes(fp, arrays.pids, 4 * n, path);
+    writeBytes(fp, arrays.numBursts, 4 * n, path);
+    writeBytes(fp, arrays.tau0s, 4 * n, path);
+    writePadding(fp, header.procTableOffset + procTableSize(n), path);
+    writeBytes(fp, arrays.cpuBurstTimes, 4 * arrays.numBurstSlots, path);
+    writeBytes(fp, arrays.ioBurstTimes, 4 * arrays.numBurstSlots, path);
+  } catch (...) {
+    fclose(fp);
+    throw;
+  }
+  if (fclose(fp) != 0) {
+    throw std::runtime_error("Error: could not write workload file " + path +
+                             ".");
+  }
+}
@@ -0,0 +1,77 @@
+/**
+ *  CSCI 4210 Operating Systems
+ *  2021 Spring
+ *
+ *  Simulation Project - WorkloadFile.hpp
+ *
+ *  Author:
+ *    Mitesh Kumar  [ kumarm4 ]
+ *
+ *  Brief:
+ *    Binary workload files. A file is laid out so that the Workload's arrays
+ * can be used straight from an mmap() of it: load() maps the file, checks the
+ * header and returns a read-only Workload whose arrays point into the mapping,
+ * so nothing is parsed or copied however many bursts the file holds. save()
+ * writes any Workload, generated or parsed, in the same format.
+ *
+ *    load() only checks that the header and every process' bursts fit the
+ * file, which takes no more than a pass over the process table. verify() reads
+ * every burst to check what the simulation assumes of them (no 0ms CPU burst,
+ * unique pids); save() runs it on what it writes, SchedTrace writes valid
+ * files by construction, and load() runs it only if asked to, for files from
+ * anywhere else. A 0ms CPU burst in an unverified file still fails the run,
+ * when the ProcessTable reaches it, instead of hanging it.
+ *
+ *    Version 1 layout, all integers in the byte order of the machine that
+ * wrote the file (checked through byteOrder on load):
+ *
+ *      Header (64 bytes, see below)
+ *      process table at procTableOffset (8-byte aligned):
+ *        u64 burstOffsets[numProcs]
+ *        u32 arrivalTimes[numProcs], pids[numProcs], numBursts[numProcs],
+ *            tau0s[numProcs]
+ *      burst arena at burstArenaOffset (8-byte aligned):
+ *        u32 cpuBurstTimes[numBurstSlots], ioBurstTimes[numBurstSlots]
+ *
+ *    The offsets are stored rather than implied so later versions can add
+ * sections without moving the existing ones.
+ */
+
+#ifndef WORKLOADFILE_HPP
+#define WORKLOADFILE_HPP
+
+#include "Workload.hpp"
+#include <cstdint>
+#include <string>
+
+class WorkloadFile {
+public:
+  static constexpr char MAGIC[8] = {'C', 'P', 'U', 'S', 'W', 'K', 'L', 'D'};
+  static constexpr std::uint32_t VERSION = 1;
+  static constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+  struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint64_t numProcs;
+    std::uint64_t numBurstSlots;
+    double alpha;
+    std::uint64_t procTableOffset;
+    std::uint64_t burstArenaOffset;
+    std::uint64_t fileSize;
+  };
+
+  // Runs verify() on the file too if full is set
+  static Workload load(const std::string &path, bool full = false);
+  static void save(const Workload &workload, const std::string &path);
+  // Throws if workload, from or for the file at path, has a 0ms CPU burst or
+  // two processes with the same pid
+  static void verify(const Workload &workload, const std::string &path);
+  // Header of a file with these sizes; its offsets and fileSize say where
+  // each array goes, for writers that fill the file in place
+  static Header makeHeader(std::uint64_t numProcs,
+                           std::uint64_t numBurstSlots, double alpha);
+};
+
+#endif
@@ -10,14 +10,23 @@
  *  Brief:
  *    Place to store any global constants defined at compile time (e.g.
  * DISPLAY_MAX_T)
+ *
+ *    The output cutoff is a runtime setting (see Scheduler and main.cpp's
+ * --cutoff option); DISPLAY_MAX_T only picks the cutoff a binary uses when
+ * none is given on the command line.
  */
 
 #ifndef GLOBALS_HPP
 #define GLOBALS_HPP
 
 #include <limits>
+
+// Output cutoff that lets every event through
+constexpr unsigned int NO_OUTPUT_CUTOFF =
+    std::numeric_limits<unsigned int>::max();
+
 #ifndef DISPLAY_MAX_T
-#define MAX_OUTPUT_TS std::numeric_limits<unsigned int>::max()
+#define MAX_OUTPUT_TS NO_OUTPUT_CUTOFF
 #else
 #define MAX_OUTPUT_TS DISPLAY_MAX_T
 #endif
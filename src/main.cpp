@@ -13,31 +13,1000 @@
  *  Autograde Score: 71/73 (cap = 60)
  */
 
-#include "Process.hpp"
+#include "Bench.hpp"
+#include "Branch.hpp"
+#include "CompletelyFair.hpp"
+#include "EventHash.hpp"
+#include "EventLog.hpp"
+#include "MultilevelFeedback.hpp"
+#include "PluginPolicy.hpp"
+#include "ProcessSource.hpp"
+#include "ProcessTable.hpp"
 #include "RoundRobin.hpp"
+#include "SchedTrace.hpp"
 #include "SeqGenerator.hpp"
 #include "ShortestRemainingTime.hpp"
+#include "SmpScheduler.hpp"
+#include "Sweep.hpp"
+#include "ThreadPool.hpp"
+#include "TimeSeries.hpp"
+#include "Workload.hpp"
+#include "WorkloadFile.hpp"
+#include "globals.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <sstream>
 #include <stdlib.h>
 #include <string>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
+/* What the simulations run on: workload, streamed if stream is set, or if
+ * workload is nullptr, the PHILOX workload for seedval generated one process
+ * at a time in arrivalOrder through a GeneratorSource if arrivalOrder is set,
+ * else the process file tracePath streamed through a TraceSource. */
+struct Input {
+  const Workload *workload;
+  bool stream;
+  std::string tracePath;
+  double lambda;
+  double alpha;
+  const std::vector<unsigned int> *arrivalOrder;
+  double maxval;
+  long seedval;
+  SeqGenerator::Sampler sampler;
+};
+
+/* What every algorithm reports besides its events. A time series is saved to
+ * timeSeriesPrefix-<algorithm>.ts unless the prefix is empty. With smp set,
+ * the algorithms run on an SmpScheduler with smpConfig instead, which logs
+ * no events and records no time series. With checkpointPrefix set, every
+ * algorithm pauses before its first event tick at or after checkpointAt and
+ * saves a snapshot to checkpointPrefix-<algorithm>.ckpt, reporting no
+ * statistics unless it already ended; with restorePrefix set, it starts from
+ * the snapshot restorePrefix-<algorithm>.ckpt. With hashPrefix set, the
+ * events are hashed to hashPrefix-<algorithm>.hash with hashSettings (see
+ * EventHash.hpp); with hashAlgorithm set too, only that algorithm runs, until
+ * its detail range has been hashed. */
+struct Output {
+  unsigned int maxOutputTs;
+  bool showPercentiles;
+  std::string timeSeriesPrefix;
+  unsigned int windowMs;
+  bool smp;
+  SmpConfig smpConfig;
+  std::string checkpointPrefix;
+  unsigned int checkpointAt;
+  std::string restorePrefix;
+  std::string hashPrefix;
+  EventHash::Settings hashSettings;
+  std::string hashAlgorithm;
+};
+
+static std::string snapshotPath(const std::string &prefix, const char *name) {
+  return prefix + "-" + name + ".ckpt";
+}
+
+/* Runs one algorithm on its own ProcessTable over input, writing events to
+ * log and the final statistics to stats. makePolicy builds the policy for the
+ * table. */
+template <class MakePolicy>
+static void simulate(const Input &input, unsigned int tcs,
+                     MakePolicy makePolicy, EventLog *log,
+                     const Output &output, std::ostream &stats) {
+  std::unique_ptr<ProcessSource> source;
+  if (input.arrivalOrder) {
+    source.reset(new GeneratorSource(*input.arrivalOrder, input.lambda,
+                                     input.maxval, input.seedval, input.alpha,
+                                     input.sampler));
+  } else if (!input.workload) {
+    source.reset(new TraceSource(input.tracePath, input.lambda, input.alpha));
+  } else if (input.stream) {
+    source.reset(new WorkloadSource(*input.workload));
+  }
+  ProcessTable processes =
+      source ? ProcessTable(*source) : ProcessTable(*input.workload);
+  auto policy = makePolicy(processes);
+  if (!output.hashAlgorithm.empty() && output.hashAlgorithm != policy.name()) {
+    return;
+  }
+  std::unique_ptr<EventHash> hash;
+  if (!output.hashPrefix.empty()) {
+    hash.reset(new EventHash(output.hashPrefix + "-" + policy.name() +
+                                 ".hash",
+                             policy.name(), output.hashSettings));
+  }
+  if (output.smp) {
+    SmpScheduler<decltype(policy)> scheduler(processes, tcs, policy,
+                                             output.smpConfig);
+    scheduler.setEventHash(hash.get());
+    if (!scheduler.run()) {
+      // The hash has recorded its detail range
+      return;
+    }
+    scheduler.printInfo(stats, output.showPercentiles);
+    return;
+  }
+  Scheduler<decltype(policy)> scheduler(processes, tcs, policy, log,
+                                        output.maxOutputTs);
+  std::unique_ptr<TimeSeries> series;
+  if (!output.timeSeriesPrefix.empty()) {
+    series.reset(new TimeSeries(output.windowMs));
+    scheduler.setTimeSeries(series.get());
+  }
+  scheduler.setEventHash(hash.get());
+  if (!output.restorePrefix.empty()) {
+    scheduler.restore(snapshotPath(output.restorePrefix, policy.name()));
+  }
+  if (!output.checkpointPrefix.empty()) {
+    const bool ended = scheduler.runUntil(output.checkpointAt);
+    scheduler.save(snapshotPath(output.checkpointPrefix, policy.name()));
+    if (!ended) {
+      return;
+    }
+  }
+  if (!scheduler.runUntil(std::numeric_limits<unsigned int>::max())) {
+    // The hash has recorded its detail range
+    return;
+  }
+  scheduler.printInfo(stats, output.showPercentiles);
+  if (series) {
+    series->save(output.timeSeriesPrefix + "-" + policy.name() +
+                 ".ts");
+  }
+}
+
+/* Runs the policy of plugin on its own ProcessTable, like simulate(). */
+static void simulatePlugin(const Input &input, unsigned int tcs,
+                           std::shared_ptr<const SchedulerPlugin> plugin,
+                           EventLog *log, const Output &output,
+                           std::ostream &stats) {
+  withPluginPolicy(*plugin, [&](auto *tag) {
+    typedef std::remove_pointer_t<decltype(tag)> Policy;
+    simulate(
+        input, tcs,
+        [&plugin](const ProcessTable &procs) { return Policy(procs, plugin); },
+        log, output, stats);
+  });
+}
+
+/* --branch=T:S,S,...: simulates RR over workload up to time T (from the
+ * snapshot restorePrefix-RR.ckpt if restorePrefix is set) once, then forks
+ * one branch per time slice S that finishes the run with it, see Branch.hpp.
+ * Writes each branch's statistics to os, in order. */
+template <bool AddToEnd>
+static void branchRoundRobin(const Workload &workload, unsigned int tcs,
+                             unsigned int tslice, const Output &output,
+                             unsigned int branchAt,
+                             const std::vector<unsigned int> &slices,
+                             std::ostream &os) {
+  ProcessTable processes(workload);
+  RoundRobin<AddToEnd> scheduler(processes, tcs,
+                                 RoundRobinPolicy<AddToEnd>(tslice), nullptr);
+  if (!output.restorePrefix.empty()) {
+    scheduler.restore(snapshotPath(output.restorePrefix, "RR"));
+  }
+  scheduler.runUntil(branchAt);
+  const std::vector<std::string> results = Branch::forkEach(
+      slices.size(), [&](unsigned int i) {
+        scheduler.getPolicy().setTimeSlice(slices[i]);
+        scheduler.run();
+        std::ostringstream ss;
+        ss << "Branch at time " << branchAt << "ms: time slice " << slices[i]
+           << "ms" << std::endl;
+        scheduler.printInfo(ss, output.showPercentiles);
+        return ss.str();
+      });
+  for (const std::string &result : results) {
+    os << result;
+  }
+}
+
+/* --sweep [path: grid file, - for stdin] [threads <optional>], see Sweep.hpp */
+static int sweep(int argc, char **argv) {
+  if (argc != 3 && argc != 4) {
+    std::cerr << "ERROR: usage: [" << *(argv)
+              << "] --sweep [path: grid file or - for stdin] [threads "
+                 "<optional>]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  // Without threads, one per hardware thread
+  unsigned int numThreads = 0;
+  if (argc == 4) {
+    char *end;
+    const char *value = *(argv + 3);
+    const unsigned long threads = strtoul(value, &end, 10);
+    if (*value == '\0' || *end != '\0' || !threads || threads > 1024) {
+      std::cerr << "ERROR: threads must be a number from 1 to 1024."
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    numThreads = threads;
+  }
+
+  try {
+    std::vector<Sweep::Config> configs;
+    if (*(argv + 2) == std::string("-")) {
+      configs = Sweep::parseGrid(std::cin);
+    } else {
+      std::ifstream ifs(*(argv + 2));
+      if (!ifs) {
+        std::cerr << "ERROR: could not open " << *(argv + 2) << std::endl;
+        return EXIT_FAILURE;
+      }
+      configs = Sweep::parseGrid(ifs);
+    }
+    Sweep::run(configs, std::cout, numThreads);
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+/* --convert [path: process file] [path: workload file] [lambda] [alpha]
+ * Parses a process file (see SeqGenerator::parseProcesses()) and saves it as a
+ * binary workload file for --workload=. */
+static int convert(int argc, char **argv) {
+  if (argc != 6) {
+    std::cerr << "ERROR: usage: [" << *(argv)
+              << "] --convert [path: process file] [path: workload file] "
+                 "[lambda] [alpha]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  try {
+    const Workload workload = SeqGenerator::parseProcesses(
+        *(argv + 2), std::stod(*(argv + 4)), 0, std::stod(*(argv + 5)), 0);
+    WorkloadFile::save(workload, *(argv + 3));
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+/* --import-sched [path: trace dump, - for stdin] [path: workload file]
+ * [lambda] [alpha] [us per ms <optional>]
+ * Imports a perf sched or ftrace dump of sched_switch / sched_wakeup events
+ * as a binary workload file for --workload=, see SchedTrace.hpp. Each
+ * simulated ms is 1000us of trace time unless given. */
+static int importSched(int argc, char **argv) {
+  double lambda = 0;
+  double alpha = -1;
+  unsigned long usPerMs = 1000;
+  char *end;
+  if (argc == 6 || argc == 7) {
+    lambda = strtod(*(argv + 4), &end);
+    if (end == *(argv + 4) || *end != '\0') {
+      lambda = 0;
+    }
+    alpha = strtod(*(argv + 5), &end);
+    if (end == *(argv + 5) || *end != '\0') {
+      alpha = -1;
+    }
+    if (argc == 7) {
+      usPerMs = strtoul(*(argv + 6), &end, 10);
+      if (**(argv + 6) < '0' || **(argv + 6) > '9' || *end != '\0' ||
+          usPerMs > UINT_MAX) {
+        usPerMs = 0;
+      }
+    }
+  }
+  // lambda must be positive, alpha a weight from 0 to 1
+  if ((argc != 6 && argc != 7) || !(lambda > 0 && lambda < HUGE_VAL) ||
+      !(alpha >= 0 && alpha <= 1) || !usPerMs) {
+    std::cerr << "ERROR: usage: [" << *(argv)
+              << "] --import-sched [path: trace dump, - for stdin] "
+                 "[path: workload file] [lambda] [alpha] "
+                 "[us per ms <optional>]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  try {
+    const SchedTrace::Summary summary = SchedTrace::convert(
+        *(argv + 2), *(argv + 3), lambda, alpha, usPerMs);
+    std::cout << "Imported " << summary.numProcs << " processes with "
+              << summary.numBursts << " CPU bursts from "
+              << summary.numEvents << " events (" << summary.numLines
+              << " lines, " << summary.numMalformed << " malformed)"
+              << std::endl;
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+/* --hash-diff [path: hash file] [path: hash file] [--rerun <optional>]
+ * Compares two files saved with --hash=. A divergence is narrowed down to the
+ * first diverging event by the two --hash-detail commands it prints, which
+ * --rerun runs as well, see EventHash.hpp. Exits with 0 if they match. */
+static int hashDiff(int argc, char **argv) {
+  const bool rerun = argc == 5 && *(argv + 4) == std::string("--rerun");
+  if (argc != 4 && !rerun) {
+    std::cerr << "ERROR: usage: [" << *(argv)
+              << "] --hash-diff [path: hash file] [path: hash file] "
+                 "[--rerun <optional>]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  try {
+    return EventHash::diff(*(argv + 2), *(argv + 3), std::cout, rerun)
+               ? EXIT_SUCCESS
+               : EXIT_FAILURE;
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
+
+/* --timeseries-csv [path: time series file]
+ * Prints a file saved with --timeseries= as CSV, see TimeSeries.hpp. */
+static int timeSeriesCsv(int argc, char **argv) {
+  if (argc != 3) {
+    std::cerr << "ERROR: usage: [" << *(argv)
+              << "] --timeseries-csv [path: time series file]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  try {
+    TimeSeries::load(*(argv + 2)).writeCsv(std::cout);
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+/* --check-philox
+ * Checks Philox::block() against the Random123 known-answer vectors for
+ * Philox4x32-10, and that SeqGenerator::generateProcess() and arrivalOrder()
+ * agree with the PHILOX workload generateProccesses() makes, for both
+ * samplers. Prints what differs; exits with 0 if nothing does. */
+static int checkPhilox(int argc, char **argv) {
+  if (argc != 2) {
+    std::cerr << "ERROR: usage: [" << *(argv) << "] --check-philox"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  struct KnownAnswer {
+    Philox::Counter ctr;
+    Philox::Key key;
+    Philox::Counter expected;
+  };
+  static const KnownAnswer answers[] = {
+      {{0, 0, 0, 0},
+       {0, 0},
+       {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+      {{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+       {0xffffffff, 0xffffffff},
+       {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+      {{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+       {0xa4093822, 0x299f31d0},
+       {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}};
+  int numFailures = 0;
+  for (const KnownAnswer &answer : answers) {
+    if (Philox::block(answer.ctr, answer.key) != answer.expected) {
+      std::cout << "Philox::block() misses a known answer for counter "
+                << std::hex << answer.ctr[0] << " " << answer.ctr[1] << " "
+                << answer.ctr[2] << " " << answer.ctr[3] << std::dec
+                << std::endl;
+      ++numFailures;
+    }
+  }
+
+  struct Settings {
+    unsigned int n;
+    double lambda;
+    double maxval;
+    long int seedval;
+  };
+  static const Settings settings[] = {
+      {200, 0.01, 256, 5}, {64, 0.001, 4096, 1}, {512, 0.01, 64, -3}};
+  for (const Settings &set : settings) {
+    for (SeqGenerator::Sampler sampler :
+         {SeqGenerator::Sampler::REJECTION,
+          SeqGenerator::Sampler::INVERSE_CDF}) {
+      const Workload workload = SeqGenerator::generateProccesses(
+          set.n, set.lambda, set.maxval, set.seedval, 0.5,
+          SeqGenerator::RngMode::PHILOX, sampler, /* all cores */ 0);
+      std::ostringstream name;
+      name << "n=" << set.n << " lambda=" << set.lambda
+           << " limit=" << set.maxval << " seed=" << set.seedval
+           << (sampler == SeqGenerator::Sampler::REJECTION ? " rejection"
+                                                            : " inverse-cdf");
+      ProcessSpec spec;
+      for (Workload::Handle h = 0; h < workload.size(); ++h) {
+        SeqGenerator::generateProcess(h, set.lambda, set.maxval, set.seedval,
+                                      spec, sampler);
+        const unsigned long long begin = workload.getBurstOffset(h);
+        bool same = spec.arrivalTime == workload.getArrivalTime(h) &&
+                    spec.pid == workload.getPid(h) &&
+                    spec.tau0 == workload.getTau0(h) &&
+                    spec.cpuBurstTimes.size() == workload.getNumBursts(h);
+        for (unsigned int j = 0; same && j < spec.cpuBurstTimes.size(); ++j) {
+          same = spec.cpuBurstTimes[j] == workload.getCpuBurstTime(begin + j) &&
+                 spec.ioBurstTimes[j] == workload.getIoBurstTime(begin + j);
+        }
+        if (!same) {
+          std::cout << "generateProcess(" << h << ") differs from process "
+                    << Process::fmtPid(workload.getPid(h)) << " for "
+                    << name.str() << std::endl;
+          ++numFailures;
+          break;
+        }
+      }
+      const std::vector<Workload::Handle> byArrival = workload.byArrival();
+      if (SeqGenerator::arrivalOrder(set.n, set.lambda, set.maxval,
+                                     set.seedval, sampler) !=
+          std::vector<unsigned int>(byArrival.begin(), byArrival.end())) {
+        std::cout << "arrivalOrder() differs from the workload's for "
+                  << name.str() << std::endl;
+        ++numFailures;
+      }
+    }
+  }
+  std::cout << numFailures << " failure(s)" << std::endl;
+  return numFailures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/* --bench sampler [count <optional>]
+ * --bench suite [path: baseline file] [--update <optional>]
+ * --bench plugin [path: shared object] [args <optional>]
+ * See Bench.hpp. */
+static int bench(int argc, char **argv) {
+  const std::string name = argc >= 3 ? *(argv + 2) : "";
+  try {
+    if (name == "sampler" && (argc == 3 || argc == 4)) {
+      unsigned long count = 10000000;
+      if (argc == 4) {
+        char *end;
+        const char *value = *(argv + 3);
+        errno = 0;
+        count = strtoul(value, &end, 10);
+        // strtoul wraps a negative value around rather than failing
+        if (*value == '\0' || *value == '-' || *end != '\0' || !count ||
+            errno == ERANGE) {
+          std::cerr << "ERROR: count must be a positive number." << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+      Bench::sampler(std::cout, count);
+      return EXIT_SUCCESS;
+    }
+    if (name == "suite" &&
+        (argc == 4 || (argc == 5 && *(argv + 4) == std::string("--update")))) {
+      return Bench::suite(std::cout, *(argv + 3), argc == 5) ? EXIT_FAILURE
+                                                             : EXIT_SUCCESS;
+    }
+    if (name == "plugin" && (argc == 4 || argc == 5)) {
+      Bench::plugin(std::cout, *(argv + 3), argc == 5 ? *(argv + 4) : "");
+      return EXIT_SUCCESS;
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cerr << "ERROR: usage: [" << *(argv)
+            << "] --bench sampler [count <optional>] | --bench suite [path: "
+               "baseline file] [--update <optional>] | --bench plugin [path: "
+               "shared object] [args <optional>]"
+            << std::endl;
+  return EXIT_FAILURE;
+}
+
+/* --cfs=L,G,W: CFS target latency, minimum and wakeup granularity in ms */
+static bool parseCfsTimes(const std::string &value, CfsConfig &config) {
+  unsigned long times[3];
+  const char *it = value.c_str();
+  for (unsigned int i = 0; i < 3; ++i) {
+    char *end;
+    times[i] = strtoul(it, &end, 10);
+    if (end == it || !times[i] || times[i] > 1000000 ||
+        *end != (i < 2 ? ',' : '\0')) {
+      return false;
+    }
+    it = end + 1;
+  }
+  config.targetLatency = times[0];
+  config.minGranularity = times[1];
+  config.wakeupGranularity = times[2];
+  return true;
+}
+
+/* --nice=A:N,B:N,...: nice levels by process name */
+static bool parseNiceLevels(const std::string &value, CfsConfig &config) {
+  std::istringstream entries(value);
+  std::string entry;
+  while (std::getline(entries, entry, ',')) {
+    const std::size_t colon = entry.find(':');
+    if (colon == std::string::npos) {
+      return false;
+    }
+    Process::Pid pid;
+    try {
+      pid = Process::parsePid(entry.substr(0, colon));
+    } catch (const std::exception &) {
+      return false;
+    }
+    char *end;
+    const char *nice = entry.c_str() + colon + 1;
+    const long level = strtol(nice, &end, 10);
+    if (*nice == '\0' || *end != '\0' || level < CfsConfig::MIN_NICE ||
+        level > CfsConfig::MAX_NICE || pid >= 1000000) {
+      return false;
+    }
+    if (pid >= config.niceLevels.size()) {
+      config.niceLevels.resize(pid + 1, 0);
+    }
+    config.niceLevels[pid] = level;
+  }
+  return !value.empty();
+}
+
+/* --mlfq=S,S,...[:B]: MLFQ time slices per level and boost interval in ms */
+static bool parseMlfqLevels(const std::string &value, MlfqConfig &config) {
+  std::vector<unsigned int> slices;
+  const char *it = value.c_str();
+  while (true) {
+    char *end;
+    const unsigned long slice = strtoul(it, &end, 10);
+    if (end == it || !slice || slice > 1000000 ||
+        slices.size() == MlfqConfig::MAX_LEVELS) {
+      return false;
+    }
+    slices.push_back(slice);
+    it = end + 1;
+    if (*end == ':') {
+      const unsigned long interval = strtoul(it, &end, 10);
+      if (end == it || *end != '\0' ||
+          interval > std::numeric_limits<unsigned int>::max()) {
+        return false;
+      }
+      config.boostInterval = interval;
+      break;
+    }
+    if (*end != ',') {
+      if (*end != '\0') {
+        return false;
+      }
+      break;
+    }
+  }
+  config.timeSlices = slices;
+  return true;
+}
+
+/* --checkpoint=T:prefix: pause time and snapshot path prefix */
+static bool parseCheckpoint(const std::string &value, unsigned int &at,
+                            std::string &prefix) {
+  char *end;
+  const char *it = value.c_str();
+  const unsigned long time = strtoul(it, &end, 10);
+  if (end == it || *end != ':' || *(end + 1) == '\0' ||
+      time >= std::numeric_limits<unsigned int>::max()) {
+    return false;
+  }
+  at = time;
+  prefix = end + 1;
+  return true;
+}
+
+/* --hash-detail=ALG:FROM-TO: algorithm and range of events */
+static bool parseHashDetail(const std::string &value, std::string &algorithm,
+                            unsigned long long &from,
+                            unsigned long long &to) {
+  const std::size_t colon = value.rfind(':');
+  if (colon == 0 || colon == std::string::npos) {
+    return false;
+  }
+  algorithm = value.substr(0, colon);
+  char *end;
+  const char *it = value.c_str() + colon + 1;
+  from = strtoull(it, &end, 10);
+  if (end == it || *end != '-') {
+    return false;
+  }
+  it = end + 1;
+  to = strtoull(it, &end, 10);
+  return end != it && *end == '\0' && from && from <= to;
+}
+
+/* --branch=T:S,S,...: branch time and RR time slices in ms */
+static bool parseBranch(const std::string &value, unsigned int &at,
+                        std::vector<unsigned int> &slices) {
+  char *end;
+  const char *it = value.c_str();
+  const unsigned long time = strtoul(it, &end, 10);
+  if (end == it || *end != ':' ||
+      time >= std::numeric_limits<unsigned int>::max()) {
+    return false;
+  }
+  at = time;
+  slices.clear();
+  do {
+    it = end + 1;
+    const unsigned long slice = strtoul(it, &end, 10);
+    if (end == it || !slice || slice > 1000000 || slices.size() == 1024) {
+      return false;
+    }
+    slices.push_back(slice);
+  } while (*end == ',');
+  return *end == '\0';
+}
 
 /* [n: number of processes] [seed] [lambda] [limit] [tcs] [alpha] [tslice]
- * [rr_add: BEGINNING or END] */
+ * [rr_add: BEGINNING or END]
+ *
+ * Options may appear anywhere among these:
+ *   --cutoff=T: don't show events after time T, except process terminations
+ *   and the end of the simulation; --cutoff=none shows everything. Defaults to
+ *   DISPLAY_MAX_T if the binary was built with it, none otherwise.
+ *   --stats-only: don't show any events, only write simout.txt.
+ *   --percentiles: also write the p50/p90/p99/max wait and turnaround times
+ *   to simout.txt.
+ *   --timeseries=prefix: save each algorithm's per-window load to
+ *   prefix-<algorithm>.ts (see TimeSeries.hpp).
+ *   --window=W: the time series window in ms. Defaults to 100.
+ *   --workload=path: simulate the workload saved in a binary workload file
+ *   (see WorkloadFile.hpp), e.g. one made with --convert or --import-sched,
+ *   instead of generating one; n, seed, lambda, limit and alpha are then
+ *   ignored.
+ *   --verify-workload: check every burst of the --workload file as it is
+ *   loaded (see WorkloadFile::verify()), for files not written by this
+ *   program.
+ *   --dump=path: save the simulated workload to a binary workload file.
+ *   --stream: admit processes from the workload one at a time as they arrive
+ *   and drop them once they terminate (see ProcessTable.hpp); the [NEW]
+ *   listing is left out. With --rng=philox and no --workload or --dump, each
+ *   process is generated as it is admitted, so only the arrival order of the
+ *   workload is held in memory; otherwise the whole workload is still built
+ *   or loaded first and only the per-run state is bounded.
+ *   --trace=path: stream the processes of a process file listed in arrival
+ *   order, without ever loading all of it; n, seed and limit are ignored.
+ *   --rng=drand48|philox: how the workload is generated, see
+ *   SeqGenerator::RngMode. Defaults to drand48.
+ *   --sampler=rejection|inverse-cdf: how burst and arrival times are drawn,
+ *   see SeqGenerator::Sampler. Defaults to rejection.
+ *   --cpus=N: simulate N CPUs (see SmpScheduler.hpp); only simout.txt is
+ *   written, with the migrations and a line per CPU added.
+ *   --queues=global|per-cpu: one ready queue for all CPUs or one per CPU.
+ *   Defaults to global.
+ *   --balance=steal|periodic:T: how per-CPU queues are balanced, by idle
+ *   CPUs stealing or every T ms. Defaults to steal.
+ *   --migration=ms: extra context switch time when a process starts on
+ *   another CPU than it last ran on. Defaults to 0.
+ *   --cpu-threads=N: with per-CPU queues, simulate the CPUs on N threads;
+ *   the results are the same as without.
+ *   --cfs: also run CFS (see CompletelyFair.hpp) after RR; --cfs=L,G,W sets
+ *   its target latency, minimum granularity and wakeup granularity in ms.
+ *   Defaults to 96,12,16.
+ *   --nice=A:N,B:N,...: the nice levels (-20 to 19) of the named processes
+ *   under CFS, which every name must be in; the rest have nice level 0.
+ *   Needs --cfs.
+ *   --mlfq: also run MLFQ (see MultilevelFeedback.hpp) after RR and CFS;
+ *   --mlfq=S,S,...[:B] sets the time slice of each level, highest priority
+ *   first, and the priority boost interval (0 for none) in ms. Defaults to
+ *   16,32,64,128:1000.
+ *   --plugin=path[:args]: also run the policy of a shared object built
+ *   against SchedPlugin.h, after the others, creating it with args; may be
+ *   given several times. See PluginPolicy.hpp.
+ *   --checkpoint=T:prefix: pause every algorithm before its first event at or
+ *   after time T and save its state to prefix-<algorithm>.ckpt (see
+ *   Scheduler.hpp); simout.txt only gets the algorithms that ended by then.
+ *   --restore=prefix: resume every algorithm from prefix-<algorithm>.ckpt,
+ *   saved over the same workload; tcs, tslice and the other settings may
+ *   differ. The events logged are those after the pause.
+ *   --branch=T:S,S,...: only simulate RR, up to time T once, and then one
+ *   branch per time slice S from there on in a forked process (see
+ *   Branch.hpp); simout.txt gets each branch's statistics. With --restore,
+ *   RR starts from the snapshot.
+ *   These three can't be combined with --cpus, --stream, --trace,
+ *   --timeseries or --plugin.
+ *   --hash=prefix: keep a rolling hash of each algorithm's events and state
+ *   in prefix-<algorithm>.hash (see EventHash.hpp), which --hash-diff
+ *   compares; can't be combined with --checkpoint, --restore or --branch.
+ *   With --cpus, the CPUs run on one thread; --cpus=1 hashes the same as
+ *   without.
+ *   --hash-every=N: write the hashes every N events. Defaults to 1000000.
+ *   --hash-detail=ALG:E-E: only run algorithm ALG, up to the last event of
+ *   the range, and hash each event of the range on its own line; only the
+ *   hash file is written. --hash-diff prints (or with --rerun, runs) this
+ *   to narrow a divergence down. */
 int main(int argc, char **argv) {
 
+  if (argc >= 2 && *(argv + 1) == std::string("--sweep")) {
+    return sweep(argc, argv);
+  }
+  if (argc >= 2 && *(argv + 1) == std::string("--convert")) {
+    return convert(argc, argv);
+  }
+  if (argc >= 2 && *(argv + 1) == std::string("--hash-diff")) {
+    return hashDiff(argc, argv);
+  }
+  if (argc >= 2 && *(argv + 1) == std::string("--import-sched")) {
+    return importSched(argc, argv);
+  }
+  if (argc >= 2 && *(argv + 1) == std::string("--bench")) {
+    return bench(argc, argv);
+  }
+  if (argc >= 2 && *(argv + 1) == std::string("--check-philox")) {
+    return checkPhilox(argc, argv);
+  }
+  if (argc >= 2 && *(argv + 1) == std::string("--timeseries-csv")) {
+    return timeSeriesCsv(argc, argv);
+  }
+
+  unsigned int maxOutputTs = MAX_OUTPUT_TS;
+  bool statsOnly = false;
+  bool percentiles = false;
+  std::string timeSeriesPrefix;
+  unsigned long windowMs = 100;
+  std::string workloadPath;
+  bool verifyWorkload = false;
+  std::string dumpPath;
+  std::string tracePath;
+  bool stream = false;
+  SeqGenerator::RngMode rngMode = SeqGenerator::RngMode::DRAND48;
+  SeqGenerator::Sampler sampler = SeqGenerator::Sampler::REJECTION;
+  bool smp = false;
+  SmpConfig smpConfig;
+  bool cfs = false;
+  bool nice = false;
+  CfsConfig cfsConfig;
+  bool mlfq = false;
+  MlfqConfig mlfqConfig;
+  std::vector<std::shared_ptr<const SchedulerPlugin>> plugins;
+  std::string checkpointPrefix;
+  unsigned int checkpointAt = 0;
+  std::string restorePrefix;
+  bool branch = false;
+  unsigned int branchAt = 0;
+  std::vector<unsigned int> branchSlices;
+  std::string hashPrefix;
+  EventHash::Settings hashSettings;
+  std::string hashAlgorithm;
+  // Kept for the hash files, so a divergence can be narrowed down by running
+  // this again
+  hashSettings.command.assign(argv, argv + argc);
+  std::vector<char *> positional;
+  for (int i = 0; i < argc; ++i) {
+    const std::string arg = *(argv + i);
+    if (arg == "--stats-only") {
+      statsOnly = true;
+    } else if (arg == "--percentiles") {
+      percentiles = true;
+    } else if (arg.rfind("--timeseries=", 0) == 0) {
+      timeSeriesPrefix = arg.substr(13);
+    } else if (arg.rfind("--window=", 0) == 0) {
+      char *end;
+      const char *value = arg.c_str() + 9;
+      windowMs = strtoul(value, &end, 10);
+      if (*value == '\0' || *end != '\0' || !windowMs ||
+          windowMs > std::numeric_limits<unsigned int>::max()) {
+        std::cerr << "ERROR: --window must be a positive time in ms."
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+    } else if (arg.rfind("--cpus=", 0) == 0) {
+      char *end;
+      const char *value = arg.c_str() + 7;
+      const unsigned long numCpus = strtoul(value, &end, 10);
+      if (*value == '\0' || *end != '\0' || !numCpus || numCpus > 1024) {
+        std::cerr << "ERROR: --cpus must be a number of CPUs from 1 to 1024."
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+      smp = true;
+      smpConfig.numCpus = numCpus;
+    } else if (arg == "--queues=global") {
+      smpConfig.queues = SmpConfig::Queues::GLOBAL;
+    } else if (arg == "--queues=per-cpu") {
+      smpConfig.queues = SmpConfig::Queues::PER_CPU;
+    } else if (arg == "--balance=steal") {
+      smpConfig.balance = SmpConfig::Balance::STEAL;
+    } else if (arg.rfind("--balance=periodic:", 0) == 0) {
+      char *end;
+      const char *value = arg.c_str() + 19;
+      const unsigned long interval = strtoul(value, &end, 10);
+      if (*value == '\0' || *end != '\0' || !interval ||
+          interval > std::numeric_limits<unsigned int>::max()) {
+        std::cerr << "ERROR: --balance=periodic: must be followed by a "
+                     "positive time in ms."
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+      smpConfig.balance = SmpConfig::Balance::PERIODIC;
+      smpConfig.balanceInterval = interval;
+    } else if (arg.rfind("--migration=", 0) == 0) {
+      char *end;
+      const char *value = arg.c_str() + 12;
+      const unsigned long penalty = strtoul(value, &end, 10);
+      if (*value == '\0' || *end != '\0' ||
+          penalty > std::numeric_limits<unsigned int>::max() / 2) {
+        std::cerr << "ERROR: --migration must be a time in ms." << std::endl;
+        return EXIT_FAILURE;
+      }
+      smpConfig.migrationPenalty = penalty;
+    } else if (arg.rfind("--cpu-threads=", 0) == 0) {
+      char *end;
+      const char *value = arg.c_str() + 14;
+      const unsigned long numThreads = strtoul(value, &end, 10);
+      if (*value == '\0' || *end != '\0' || !numThreads ||
+          numThreads > 1024) {
+        std::cerr << "ERROR: --cpu-threads must be a number of threads from 1 "
+                     "to 1024."
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+      smpConfig.numThreads = numThreads;
+    } else if (arg == "--cfs") {
+      cfs = true;
+    } else if (arg.rfind("--cfs=", 0) == 0) {
+      if (!parseCfsTimes(arg.substr(6), cfsConfig)) {
+        std::cerr << "ERROR: --cfs= must be followed by three positive times "
+                     "in ms, e.g. --cfs=96,12,16."
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+      cfs = true;
+    } else if (arg.rfind("--nice=", 0) == 0) {
+      nice = true;
+      if (!parseNiceLevels(arg.substr(7), cfsConfig)) {
+        std::cerr << "ERROR: --nice= must be followed by process names and "
+                     "nice levels from -20 to 19, e.g. --nice=A:-5,B:10."
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+    } else if (arg == "--mlfq") {
+      mlfq = true;
+    } else if (arg.rfind("--mlfq=", 0) == 0) {
+      if (!parseMlfqLevels(arg.substr(7), mlfqConfig)) {
+        std::cerr << "ERROR: --mlfq= must be followed by 1 to "
+                  << MlfqConfig::MAX_LEVELS
+                  << " positive time slices in ms and optionally a boost "
+                     "interval, e.g. --mlfq=16,32,64:1000."
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+      mlfq = true;
+    } else if (arg.rfind("--plugin=", 0) == 0) {
+      const std::string spec = arg.substr(9);
+      const std::size_t colon = spec.find(':');
+      if (spec.empty() || colon == 0) {
+        std::cerr << "ERROR: --plugin= must be followed by the path of a "
+                     "shared object, e.g. --plugin=plugins/rr.so:64."
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+      try {
+        plugins.push_back(SchedulerPlugin::load(
+            spec.substr(0, colon),
+            colon == std::string::npos ? "" : spec.substr(colon + 1)));
+      } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+      }
+    } else if (arg.rfind("--checkpoint=", 0) == 0) {
+      if (!parseCheckpoint(arg.substr(13), checkpointAt, checkpointPrefix)) {
+        std::cerr << "ERROR: --checkpoint= must be followed by a time in ms "
+                     "and a path prefix, e.g. --checkpoint=100000:run."
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+    } else if (arg.rfind("--restore=", 0) == 0) {
+      restorePrefix = arg.substr(10);
+      if (restorePrefix.empty()) {
+        std::cerr << "ERROR: --restore= must be followed by a path prefix."
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+    } else if (arg.rfind("--branch=", 0) == 0) {
+      if (!parseBranch(arg.substr(9), branchAt, branchSlices)) {
+        std::cerr << "ERROR: --branch= must be followed by a time in ms and "
+                     "positive time slices, e.g. --branch=100000:64,128,256."
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+      branch = true;
+    } else if (arg.rfind("--hash=", 0) == 0) {
+      hashPrefix = arg.substr(7);
+      if (hashPrefix.empty()) {
+        std::cerr << "ERROR: --hash= must be followed by a path prefix."
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+    } else if (arg.rfind("--hash-every=", 0) == 0) {
+      char *end;
+      const char *value = arg.c_str() + 13;
+      hashSettings.interval = strtoull(value, &end, 10);
+      if (*value == '\0' || *end != '\0' || !hashSettings.interval) {
+        std::cerr << "ERROR: --hash-every must be a positive number of "
+                     "events."
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+    } else if (arg.rfind("--hash-detail=", 0) == 0) {
+      if (!parseHashDetail(arg.substr(14), hashAlgorithm,
+                           hashSettings.detailFrom, hashSettings.detailTo)) {
+        std::cerr << "ERROR: --hash-detail= must be followed by an algorithm "
+                     "and a range of events, e.g. --hash-detail=RR:1000-2000."
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+    } else if (arg.rfind("--workload=", 0) == 0) {
+      workloadPath = arg.substr(11);
+    } else if (arg == "--verify-workload") {
+      verifyWorkload = true;
+    } else if (arg.rfind("--dump=", 0) == 0) {
+      dumpPath = arg.substr(7);
+    } else if (arg == "--rng=drand48") {
+      rngMode = SeqGenerator::RngMode::DRAND48;
+    } else if (arg == "--rng=philox") {
+      rngMode = SeqGenerator::RngMode::PHILOX;
+    } else if (arg == "--sampler=rejection") {
+      sampler = SeqGenerator::Sampler::REJECTION;
+    } else if (arg == "--sampler=inverse-cdf") {
+      sampler = SeqGenerator::Sampler::INVERSE_CDF;
+    } else if (arg == "--stream") {
+      stream = true;
+    } else if (arg.rfind("--trace=", 0) == 0) {
+      tracePath = arg.substr(8);
+    } else if (arg == "--cutoff=none") {
+      maxOutputTs = NO_OUTPUT_CUTOFF;
+    } else if (arg.rfind("--cutoff=", 0) == 0) {
+      char *end;
+      const char *value = arg.c_str() + 9;
+      unsigned long cutoff = strtoul(value, &end, 10);
+      if (*value == '\0' || *end != '\0' || cutoff >= NO_OUTPUT_CUTOFF) {
+        std::cerr << "ERROR: --cutoff must be a time in ms or none."
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+      maxOutputTs = cutoff;
+    } else {
+      positional.push_back(*(argv + i));
+    }
+  }
+  argc = positional.size();
+  argv = positional.data();
+
   if (argc != 8 && argc != 9 && argc != 10) {
     std::cerr << "ERROR: usage: [" << *(argv)
               << "] [n: number of processes] [seed] [lambda] [limit] [tcs] "
                  "[alpha] [tslice] [rr_add: BEGINNING or END <optional>] [-p "
-                 "path: path/to/inputfile <optional>]"
+                 "path: path/to/inputfile <optional>] [--cutoff=T|none "
+                 "<optional>] [--stats-only <optional>] [--percentiles "
+                 "<optional>] [--workload=path <optional>] "
+                 "[--verify-workload <optional>] [--dump=path "
+                 "<optional>] [--stream <optional>] [--trace=path <optional>] "
+                 "[--rng=drand48|philox <optional>] [--timeseries=prefix "
+                 "<optional>] [--window=W <optional>] "
+                 "[--sampler=rejection|inverse-cdf <optional>] [--cpus=N "
+                 "<optional>] [--queues=global|per-cpu <optional>] "
+                 "[--balance=steal|periodic:T <optional>] [--migration=ms "
+                 "<optional>] [--cpu-threads=N <optional>] [--cfs|--cfs=L,G,W "
+                 "<optional>] [--nice=A:N,... <optional>] "
+                 "[--mlfq|--mlfq=S,S,...[:B] <optional>] "
+                 "[--plugin=path[:args] <optional>] [--checkpoint=T:prefix "
+                 "<optional>] [--restore=prefix <optional>] "
+                 "[--branch=T:S,S,... <optional>] [--hash=prefix <optional>] "
+                 "[--hash-every=N <optional>] [--hash-detail=ALG:E-E "
+                 "<optional>]"
               << std::endl;
     return EXIT_FAILURE;
   }
 
   bool addToEnd = true;
-  int n = atoi(*(argv + 1));
+  unsigned int n = strtoul(*(argv + 1), nullptr, 10);
   long seedval = atol(*(argv + 2));
   double lambda = std::stod(*(argv + 3));
   int maxval = atoi(*(argv + 4));
@@ -68,7 +1037,10 @@ int main(int argc, char **argv) {
   }
 
   std::ofstream ofs;
-  ofs.open("simout.txt", std::ofstream::out | std::ofstream::trunc);
+  // A detail hash run only writes its hash file
+  if (hashAlgorithm.empty()) {
+    ofs.open("simout.txt", std::ofstream::out | std::ofstream::trunc);
+  }
 
   // {\tt [$n$: 2] [seed: 2] [$\lambda$: 0.01] [limit: 256] [$t_{cs}$: 4]
   // [$\alpha$: 0.5] [$t_{slice}$: 128]} ofs << "{\\tt [$n$: " << n << "] [seed:
@@ -78,43 +1050,237 @@ int main(int argc, char **argv) {
   //   ofs << "[$rr_{add}$: " << *(argv + 8) << "]";
   // }
   // ofs << "}" << std::endl;
-  std::vector<Process> processes =
-      SeqGenerator::generateProccesses(n, lambda, maxval, seedval, alpha);
-  // std::vector<Process> processes =
+  if (!tracePath.empty() && (!workloadPath.empty() || !dumpPath.empty())) {
+    std::cerr << "ERROR: --trace can't be combined with --workload or --dump."
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (nice && !cfs) {
+    std::cerr << "ERROR: --nice only applies to --cfs." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (smp && !timeSeriesPrefix.empty()) {
+    std::cerr << "ERROR: --timeseries can't be combined with --cpus."
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  if ((!checkpointPrefix.empty() || !restorePrefix.empty() || branch) &&
+      (smp || stream || !tracePath.empty() || !timeSeriesPrefix.empty() ||
+       !plugins.empty())) {
+    std::cerr << "ERROR: --checkpoint, --restore and --branch can't be "
+                 "combined with --cpus, --stream, --trace, --timeseries or "
+                 "--plugin."
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (!hashPrefix.empty() &&
+      (!checkpointPrefix.empty() || !restorePrefix.empty() || branch)) {
+    std::cerr << "ERROR: --hash can't be combined with --checkpoint, "
+                 "--restore or --branch."
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (!hashAlgorithm.empty() && hashPrefix.empty()) {
+    std::cerr << "ERROR: --hash-detail needs --hash." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (!hashAlgorithm.empty()) {
+    // Only the range is recorded, one line per event
+    hashSettings.interval = std::numeric_limits<unsigned long long>::max();
+    statsOnly = true;
+  }
+  if (!hashPrefix.empty()) {
+    char cwd[PATH_MAX];
+    if (getcwd(cwd, sizeof(cwd))) {
+      hashSettings.cwd = cwd;
+    }
+  }
+  if (branch && !checkpointPrefix.empty()) {
+    std::cerr << "ERROR: --branch can't be combined with --checkpoint."
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  Workload workload(alpha);
+  // Set when every simulation generates the processes it admits itself
+  std::unique_ptr<std::vector<unsigned int>> arrivalOrder;
+  try {
+    if (!tracePath.empty()) {
+      // Nothing to load, every simulation reads the trace itself
+    } else if (stream && workloadPath.empty() && dumpPath.empty() &&
+               rngMode == SeqGenerator::RngMode::PHILOX) {
+      arrivalOrder.reset(new std::vector<unsigned int>(
+          SeqGenerator::arrivalOrder(n, lambda, maxval, seedval, sampler)));
+    } else if (workloadPath.empty()) {
+      workload = SeqGenerator::generateProccesses(
+          n, lambda, maxval, seedval, alpha, rngMode, sampler,
+          /* all cores */ 0);
+    } else {
+      workload = WorkloadFile::load(workloadPath, verifyWorkload);
+    }
+    if (!dumpPath.empty()) {
+      WorkloadFile::save(workload, dumpPath);
+    }
+    // Every name --nice gives must be one of the workload's processes
+    if (!cfsConfig.niceLevels.empty()) {
+      Process::Pid numPids = 0;
+      if (!tracePath.empty()) {
+        numPids = TraceSource(tracePath, lambda, alpha).size();
+      } else if (arrivalOrder) {
+        numPids = n;
+      } else {
+        for (Workload::Handle h = 0; h < workload.size(); ++h) {
+          numPids = std::max(numPids, workload.getPid(h) + 1);
+        }
+      }
+      if (cfsConfig.niceLevels.size() > numPids) {
+        std::cerr << "ERROR: --nice names process "
+                  << Process::fmtPid(cfsConfig.niceLevels.size() - 1)
+                  << ", which isn't in the workload." << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  // const Workload workload =
   // SeqGenerator::parseProcesses("testinputs/mostlyIoBound.txt", lambda, tcs,
   // alpha, tslice);
 
-  // FCFS
-  RoundRobin fcfs(processes, tslice, tcs, addToEnd, /* FCFS: true */ true);
-  fcfs.run();
-  // fcfs.printCsv(ofs);
-  fcfs.printInfo(ofs);
-  fcfs.reset();
-  std::cout << std::endl;
-
-  // SJF
-  ShortestRemainingTime sjf(processes, tcs, /* SJF: true */ true);
-  sjf.run();
-  // sjf.printCsv(ofs);
-  sjf.printInfo(ofs);
-  sjf.reset();
-  std::cout << std::endl;
-
-  // SRT
-  ShortestRemainingTime srt(processes, tcs, /* SRT: false */ false);
-  srt.run();
-  // srt.printCsv(ofs);
-  srt.printInfo(ofs);
-  srt.reset();
-  std::cout << std::endl;
-
-  // RR
-  RoundRobin rr(processes, tslice, tcs, addToEnd, /* RR: false */ false);
-  rr.run();
-  // rr.printCsv(ofs);
-  rr.printInfo(ofs);
-  rr.reset();
+  const Input input{tracePath.empty() && !arrivalOrder ? &workload : nullptr,
+                    stream,
+                    tracePath,
+                    lambda,
+                    alpha,
+                    arrivalOrder.get(),
+                    (double)maxval,
+                    seedval,
+                    sampler};
+  const Output output{maxOutputTs,      percentiles,  timeSeriesPrefix,
+                      (unsigned int)windowMs, smp, smpConfig,
+                      checkpointPrefix, checkpointAt, restorePrefix,
+                      hashPrefix,       hashSettings, hashAlgorithm};
+
+  if (branch) {
+    // Forks, so no other thread may be running
+    try {
+      if (addToEnd) {
+        branchRoundRobin<true>(workload, tcs, tslice, output, branchAt,
+                               branchSlices, ofs);
+      } else {
+        branchRoundRobin<false>(workload, tcs, tslice, output, branchAt,
+                                branchSlices, ofs);
+      }
+    } catch (const std::exception &e) {
+      std::cerr << e.what() << std::endl;
+      return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+  }
+
+  // The algorithms only share the (immutable) workload, so they all run at
+  // once. FCFS logs straight to stdout; the others keep their events in
+  // temporary files (see EventLog.hpp) and their statistics in memory until
+  // everything before them has been written.
+  EventLog out(STDOUT_FILENO, /* background writer */ true);
+  // The optional algorithms come after RR, in a fixed order
+  const unsigned int cfsIndex = 4;
+  const unsigned int mlfqIndex = cfsIndex + cfs;
+  const unsigned int pluginIndex = mlfqIndex + mlfq;
+  const unsigned int numAlgorithms = pluginIndex + plugins.size();
+  std::vector<std::unique_ptr<EventLog>> events;
+  std::vector<EventLog *> logs(numAlgorithms, nullptr);
+  if (!statsOnly && !smp) {
+    logs[0] = &out;
+    for (unsigned int i = 1; i < numAlgorithms; ++i) {
+      events.emplace_back(new EventLog());
+      logs[i] = events.back().get();
+    }
+  }
+  std::vector<std::ostringstream> stats(numAlgorithms);
+  int status = EXIT_SUCCESS;
+  try {
+    ThreadPool pool(numAlgorithms);
+    pool.submit([&] {
+      simulate(
+          input, tcs, [](const ProcessTable &) { return FcfsPolicy(); },
+          logs[0], output, stats[0]);
+    });
+    pool.submit([&] {
+      simulate(
+          input, tcs,
+          [](const ProcessTable &procs) { return SjfPolicy(procs); },
+          logs[1], output, stats[1]);
+    });
+    pool.submit([&] {
+      simulate(
+          input, tcs,
+          [](const ProcessTable &procs) { return SrtPolicy(procs); },
+          logs[2], output, stats[2]);
+    });
+    pool.submit([&] {
+      if (addToEnd) {
+        simulate(
+            input, tcs,
+            [tslice](const ProcessTable &) {
+              return RoundRobinPolicy<true>(tslice);
+            },
+            logs[3], output, stats[3]);
+      } else {
+        simulate(
+            input, tcs,
+            [tslice](const ProcessTable &) {
+              return RoundRobinPolicy<false>(tslice);
+            },
+            logs[3], output, stats[3]);
+      }
+    });
+    if (cfs) {
+      pool.submit([&] {
+        simulate(
+            input, tcs,
+            [&cfsConfig](const ProcessTable &procs) {
+              return CfsPolicy(procs, cfsConfig);
+            },
+            logs[cfsIndex], output, stats[cfsIndex]);
+      });
+    }
+    if (mlfq) {
+      pool.submit([&] {
+        simulate(
+            input, tcs,
+            [&mlfqConfig](const ProcessTable &procs) {
+              return MlfqPolicy(procs, mlfqConfig);
+            },
+            logs[mlfqIndex], output, stats[mlfqIndex]);
+      });
+    }
+    for (unsigned int i = 0; i < plugins.size(); ++i) {
+      pool.submit([&, i] {
+        simulatePlugin(input, tcs, plugins[i], logs[pluginIndex + i], output,
+                       stats[pluginIndex + i]);
+      });
+    }
+    pool.wait();
+  } catch (const std::exception &e) {
+    // Still write out whatever the runs logged before giving up
+    std::cerr << e.what() << std::endl;
+    status = EXIT_FAILURE;
+  }
+  try {
+    for (const auto &log : events) {
+      out << '\n';
+      log->copyTo(out);
+    }
+    out.flush();
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    status = EXIT_FAILURE;
+  }
+  for (const auto &st : stats) {
+    ofs << st.str();
+  }
 
   ofs.close();
-  return EXIT_SUCCESS;
+  return status;
 }